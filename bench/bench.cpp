@@ -11,6 +11,10 @@
 #include "spdlog/sinks/daily_file_sink.h"
 #include "spdlog/sinks/null_sink.h"
 #include "spdlog/sinks/rotating_file_sink.h"
+#include "spdlog/sinks/sharded_file_sink.h"
+#ifndef _WIN32
+    #include "spdlog/sinks/direct_file_sink.h"
+#endif
 
 #if defined(SPDLOG_USE_STD_FORMAT)
     #include <format>
@@ -58,6 +62,23 @@ void bench_threaded_logging(size_t threads, int iters) {
         "rotating_mt/backtrace-on", "logs/rotating_mt.log", file_size, rotating_files);
     rotating_mt_tracing->enable_backtrace(32);
     bench_mt(iters, std::move(rotating_mt_tracing), threads);
+    auto rotating_mt_prealloc = std::make_shared<spdlog::logger>(
+        "rotating_mt/prealloc",
+        std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
+            "logs/rotating_mt_prealloc.log", file_size, rotating_files, false,
+            spdlog::file_event_handlers{}, true));
+    bench_mt(iters, std::move(rotating_mt_prealloc), threads);
+#ifndef _WIN32
+    auto rotating_mt_direct = std::make_shared<spdlog::logger>(
+        "rotating_mt/direct", std::make_shared<spdlog::sinks::rotating_direct_file_sink_mt>(
+                                  "logs/rotating_mt_direct.log", file_size, rotating_files, false,
+                                  spdlog::file_event_handlers{}, true));
+    bench_mt(iters, std::move(rotating_mt_direct), threads);
+#endif
+
+    spdlog::info("");
+    auto sharded_mt = spdlog::sharded_logger_mt("sharded_mt", "logs/sharded_mt.log", threads, true);
+    bench_mt(iters, std::move(sharded_mt), threads);
 
     spdlog::info("");
     auto daily_mt = spdlog::daily_logger_mt("daily_mt", "logs/daily_mt.log");
@@ -97,6 +118,19 @@ void bench_single_threaded(int iters) {
         "rotating_st/backtrace-on", "logs/rotating_st.log", file_size, rotating_files);
     rotating_st_tracing->enable_backtrace(32);
     bench(iters, std::move(rotating_st_tracing));
+    auto rotating_st_prealloc = std::make_shared<spdlog::logger>(
+        "rotating_st/prealloc",
+        std::make_shared<spdlog::sinks::rotating_file_sink_st>(
+            "logs/rotating_st_prealloc.log", file_size, rotating_files, false,
+            spdlog::file_event_handlers{}, true));
+    bench(iters, std::move(rotating_st_prealloc));
+#ifndef _WIN32
+    auto rotating_st_direct = std::make_shared<spdlog::logger>(
+        "rotating_st/direct", std::make_shared<spdlog::sinks::rotating_direct_file_sink_st>(
+                                  "logs/rotating_st_direct.log", file_size, rotating_files, false,
+                                  spdlog::file_event_handlers{}, true));
+    bench(iters, std::move(rotating_st_direct));
+#endif
 
     spdlog::info("");
     auto daily_st = spdlog::daily_logger_st("daily_st", "logs/daily_st.log");
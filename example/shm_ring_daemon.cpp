@@ -0,0 +1,71 @@
+//
+// Copyright(c) 2015 Gabi Melman.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+// Log shipping daemon: reads the messages that applications write to a shared memory ring with
+// shm_ring_sink, and writes them to a rotating log file.
+//
+// usage: shm_ring_daemon <shm name> <log file> [ring size in bytes]
+//
+// applications log with:
+//     auto logger = spdlog::shm_ring_logger_mt("app", "/myapp-log");
+
+#include "spdlog/sinks/rotating_file_sink.h"
+#include "spdlog/sinks/shm_ring_sink.h"
+#include "spdlog/spdlog.h"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <thread>
+
+static std::atomic<bool> stop{false};
+
+static void on_signal(int) { stop = true; }
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        spdlog::error("usage: {} <shm name> <log file> [ring size in bytes]", argv[0]);
+        return 1;
+    }
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+
+    try {
+        size_t ring_size = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 4 * 1024 * 1024;
+        spdlog::sinks::shm_ring_reader reader(argv[1], ring_size);
+        spdlog::sinks::rotating_file_sink_mt file_sink(argv[2], 100 * 1024 * 1024, 10);
+
+        auto last_flush = std::chrono::steady_clock::now();
+        uint64_t last_dropped = reader.dropped_messages();
+        while (!stop) {
+            if (reader.drain_to(file_sink, 10000) == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            if (now - last_flush >= std::chrono::seconds(1)) {
+                file_sink.flush();
+                last_flush = now;
+                auto dropped = reader.dropped_messages();
+                if (dropped != last_dropped) {
+                    spdlog::warn("{} messages dropped because the ring was full",
+                                 dropped - last_dropped);
+                    last_dropped = dropped;
+                }
+            }
+        }
+
+        // write what is left before exiting
+        while (reader.drain_to(file_sink) > 0) {
+        }
+        file_sink.flush();
+        spdlog::info("stopped. written: {} dropped: {} abandoned: {}", reader.written_messages(),
+                     reader.dropped_messages(), reader.abandoned_messages());
+    } catch (const spdlog::spdlog_ex &ex) {
+        spdlog::error("shm_ring_daemon failed: {}", ex.what());
+        return 1;
+    }
+    return 0;
+}
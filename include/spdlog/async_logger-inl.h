@@ -60,12 +60,12 @@ SPDLOG_LOGGER_CATCH(source_loc())
 // backend functions - called from the thread pool to do the actual job
 //
 SPDLOG_INLINE void spdlog::async_logger::backend_sink_it_(const details::log_msg &msg) {
-    for (auto &sink : sinks_) {
+    for_each_sink_([&](const sink_ptr &sink) {
         if (sink->should_log(msg.level)) {
             SPDLOG_TRY { sink->log(msg); }
             SPDLOG_LOGGER_CATCH(msg.source)
         }
-    }
+    });
 
     if (should_flush_(msg)) {
         backend_flush_();
@@ -73,10 +73,10 @@ SPDLOG_INLINE void spdlog::async_logger::backend_sink_it_(const details::log_msg
 }
 
 SPDLOG_INLINE void spdlog::async_logger::backend_flush_() {
-    for (auto &sink : sinks_) {
+    for_each_sink_([&](const sink_ptr &sink) {
         SPDLOG_TRY { sink->flush(); }
         SPDLOG_LOGGER_CATCH(source_loc())
-    }
+    });
 }
 
 SPDLOG_INLINE std::shared_ptr<spdlog::logger> spdlog::async_logger::clone(std::string new_name) {
@@ -36,5 +36,21 @@ inline void load_argv_levels(int argc, char **argv) {
     load_argv_levels(argc, const_cast<const char **>(argv));
 }
 
+// search for SPDLOG_CALLSITES= in the args and use it to turn callsites on or off
+// example.exe "SPDLOG_CALLSITES=conn.cpp:42,handle_request"
+inline void load_argv_callsites(int argc, const char **argv) {
+    const std::string spdlog_callsites_prefix = "SPDLOG_CALLSITES=";
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.find(spdlog_callsites_prefix) == 0) {
+            helpers::load_callsites(arg.substr(spdlog_callsites_prefix.size()));
+        }
+    }
+}
+
+inline void load_argv_callsites(int argc, char **argv) {
+    load_argv_callsites(argc, const_cast<const char **>(argv));
+}
+
 }  // namespace cfg
 }  // namespace spdlog
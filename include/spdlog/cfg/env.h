@@ -32,5 +32,14 @@ inline void load_env_levels() {
     }
 }
 
+// turn callsites on or off from env variable SPDLOG_CALLSITES (see helpers::load_callsites)
+// example: export SPDLOG_CALLSITES="conn.cpp:42,handle_request"
+inline void load_env_callsites() {
+    auto env_val = details::os::getenv("SPDLOG_CALLSITES");
+    if (!env_val.empty()) {
+        helpers::load_callsites(env_val);
+    }
+}
+
 }  // namespace cfg
 }  // namespace spdlog
@@ -7,6 +7,7 @@
     #include <spdlog/cfg/helpers.h>
 #endif
 
+#include <spdlog/details/callsite.h>
 #include <spdlog/details/os.h>
 #include <spdlog/details/registry.h>
 #include <spdlog/spdlog.h>
@@ -102,6 +103,34 @@ SPDLOG_INLINE void load_levels(const std::string &input) {
                                              global_level_found ? &global_level : nullptr);
 }
 
+SPDLOG_INLINE void load_callsites(const std::string &input) {
+    if (input.empty() || input.size() > 512) {
+        return;
+    }
+
+    // entries are applied in order, so later ones override earlier ones
+    std::string token;
+    std::istringstream token_stream(input);
+    while (std::getline(token_stream, token, ',')) {
+        auto kv = extract_kv_('=', token);
+        auto &spec = kv.first.empty() ? kv.second : kv.first;
+        std::string mode_name = kv.first.empty() ? "on" : to_lower_(kv.second);
+        details::callsite_mode mode;
+        if (mode_name == "on") {
+            mode = details::callsite_mode::on;
+        } else if (mode_name == "off") {
+            mode = details::callsite_mode::off;
+        } else if (mode_name == "level") {
+            mode = details::callsite_mode::level;
+        } else {
+            continue;  // ignore unrecognized modes
+        }
+        if (!spec.empty()) {
+            details::callsite_registry::instance().set_mode(spec, mode);
+        }
+    }
+}
+
 }  // namespace helpers
 }  // namespace cfg
 }  // namespace spdlog
@@ -17,8 +17,20 @@ namespace helpers {
 // set global level to debug: "debug"
 // turn off all logging except for logger1: "off,logger1=debug"
 // turn off all logging except for logger1 and logger2: "off,logger1=debug,logger2=info"
+// set net.http and the loggers below it (net.http.server, ...) to debug: "net.http=debug"
 //
 SPDLOG_API void load_levels(const std::string &txt);
+
+//
+// Set the modes of callsites in the callsite registry (used with SPDLOG_CALLSITE_CACHE) from
+// given string of comma separated "spec=on|off|level" entries. A spec alone is turned on.
+//
+// Examples:
+//
+// log the statement at line 42 of conn.cpp regardless of the logger level: "conn.cpp:42"
+// log all statements of function handle_request, except one: "handle_request,server.cpp:99=off"
+//
+SPDLOG_API void load_callsites(const std::string &txt);
 }  // namespace helpers
 
 }  // namespace cfg
@@ -296,6 +296,16 @@ enum class pattern_time_type {
     utc     // log utc
 };
 
+//
+// Async overflow policy - block by default.
+//
+enum class async_overflow_policy {
+    block,           // Block until message can be enqueued
+    overrun_oldest,  // Discard oldest message in the queue if full when trying to
+                     // add new item.
+    discard_new      // Discard new message if the queue is full when trying to add new item.
+};
+
 //
 // Log exception
 //
@@ -6,31 +6,43 @@
 #ifndef SPDLOG_HEADER_ONLY
     #include <spdlog/details/backtracer.h>
 #endif
+
+#include <thread>
+
 namespace spdlog {
 namespace details {
 SPDLOG_INLINE backtracer::backtracer(const backtracer &other) {
     std::lock_guard<std::mutex> lock(other.mutex_);
     enabled_ = other.enabled();
-    messages_ = other.messages_;
+    const auto *other_ring = other.ring_.load();
+    if (other_ring != nullptr) {
+        replace_ring_(details::make_unique<ring>(other_ring->size));
+        for (const auto &e : other.collect_(false)) {
+            push_(e.msg, e.lazy);
+        }
+    }
 }
 
 SPDLOG_INLINE backtracer::backtracer(backtracer &&other) SPDLOG_NOEXCEPT {
     std::lock_guard<std::mutex> lock(other.mutex_);
     enabled_ = other.enabled();
-    messages_ = std::move(other.messages_);
+    ring_owner_ = std::move(other.ring_owner_);
+    ring_.store(ring_owner_.get());
+    other.ring_.store(nullptr);
 }
 
 SPDLOG_INLINE backtracer &backtracer::operator=(backtracer other) {
     std::lock_guard<std::mutex> lock(mutex_);
     enabled_ = other.enabled();
-    messages_ = std::move(other.messages_);
+    replace_ring_(std::move(other.ring_owner_));
+    other.ring_.store(nullptr);
     return *this;
 }
 
 SPDLOG_INLINE void backtracer::enable(size_t size) {
     std::lock_guard<std::mutex> lock{mutex_};
+    replace_ring_(size > 0 ? details::make_unique<ring>(size) : nullptr);
     enabled_.store(true, std::memory_order_relaxed);
-    messages_ = circular_q<log_msg_buffer>{size};
 }
 
 SPDLOG_INLINE void backtracer::disable() {
@@ -40,24 +52,106 @@ SPDLOG_INLINE void backtracer::disable() {
 
 SPDLOG_INLINE bool backtracer::enabled() const { return enabled_.load(std::memory_order_relaxed); }
 
-SPDLOG_INLINE void backtracer::push_back(const log_msg &msg) {
-    std::lock_guard<std::mutex> lock{mutex_};
-    messages_.push_back(log_msg_buffer{msg});
+SPDLOG_INLINE void backtracer::push_back(const log_msg &msg) { push_(msg, false); }
+
+SPDLOG_INLINE void backtracer::push_(const log_msg &msg, bool lazy) {
+    read_epoch::reader_guard guard(writers_epoch_);
+    auto *r = ring_.load(std::memory_order_acquire);
+    if (r == nullptr) {
+        return;
+    }
+    auto seq = r->head.fetch_add(1, std::memory_order_relaxed);
+    auto &s = r->slots[seq % r->size];
+    auto tag = (seq + 1) << 1;
+
+    // take the slot, unless a newer message got it first
+    auto state = s.state.load(std::memory_order_relaxed);
+    for (;;) {
+        if (state & 1) {
+            std::this_thread::yield();
+            state = s.state.load(std::memory_order_relaxed);
+        } else if (state > tag) {
+            return;
+        } else if (s.state.compare_exchange_weak(state, tag | 1, std::memory_order_acquire,
+                                                 std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    s.msg.assign(msg);
+    s.lazy = lazy;
+    s.state.store(tag, std::memory_order_release);
 }
 
 SPDLOG_INLINE bool backtracer::empty() const {
     std::lock_guard<std::mutex> lock{mutex_};
-    return messages_.empty();
+    const auto *r = ring_.load();
+    return r == nullptr || r->head.load() == r->tail;
 }
 
 // pop all items in the q and apply the given fun on each of them.
 SPDLOG_INLINE void backtracer::foreach_pop(std::function<void(const details::log_msg &)> fun) {
-    std::lock_guard<std::mutex> lock{mutex_};
-    while (!messages_.empty()) {
-        auto &front_msg = messages_.front();
-        fun(front_msg);
-        messages_.pop_front();
+    std::vector<entry> messages;
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        messages = collect_(true);
+    }
+    memory_buf_t buf;
+    for (const auto &e : messages) {
+        if (!e.lazy) {
+            fun(e.msg);
+            continue;
+        }
+#ifndef SPDLOG_USE_STD_FORMAT
+        log_msg formatted(e.msg);
+        buf.clear();
+        SPDLOG_TRY {
+            lazy_format::format(e.msg.payload, buf);
+            formatted.payload = string_view_t(buf.data(), buf.size());
+        }
+        SPDLOG_CATCH_STD
+        if (formatted.payload.data() == e.msg.payload.data()) {
+            // formatting failed. show the format string rather than nothing.
+            formatted.payload = lazy_format::format_string(e.msg.payload);
+        }
+        fun(formatted);
+#endif
+    }
+}
+
+SPDLOG_INLINE std::vector<backtracer::entry> backtracer::collect_(bool pop) const {
+    std::vector<entry> messages;
+    read_epoch::reader_guard guard(writers_epoch_);
+    auto *r = ring_.load(std::memory_order_acquire);
+    if (r == nullptr) {
+        return messages;
+    }
+    auto head = r->head.load();
+    auto first = head > r->size ? head - r->size : 0;
+    if (first < r->tail) {
+        first = r->tail;
     }
+    messages.reserve(static_cast<size_t>(head - first));
+    for (auto seq = first; seq < head; seq++) {
+        auto &s = r->slots[seq % r->size];
+        auto tag = (seq + 1) << 1;
+        // skip the messages still being written, or already overwritten
+        auto expected = tag;
+        if (s.state.compare_exchange_strong(expected, tag | 1, std::memory_order_acquire)) {
+            messages.push_back(entry{s.msg, s.lazy});
+            s.state.store(tag, std::memory_order_release);
+        }
+    }
+    if (pop) {
+        r->tail = head;
+    }
+    return messages;
 }
+
+SPDLOG_INLINE void backtracer::replace_ring_(std::unique_ptr<ring> new_ring) {
+    ring_.store(new_ring.get(), std::memory_order_release);
+    writers_epoch_.synchronize();
+    ring_owner_ = std::move(new_ring);
+}
+
 }  // namespace details
 }  // namespace spdlog
@@ -3,23 +3,31 @@
 
 #pragma once
 
-#include <spdlog/details/circular_q.h>
+#include <spdlog/details/lazy_format.h>
 #include <spdlog/details/log_msg_buffer.h>
+#include <spdlog/details/read_epoch.h>
 
 #include <atomic>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 // Store log messages in circular buffer.
 // Useful for storing debug data in case of error/warning happens.
+//
+// push_back() doesn't lock: each message gets the next sequence number with an atomic
+// increment and is copied into the slot for that number, whose buffer is reused, so once
+// every slot has seen its longest message nothing is allocated either. Only a thread writing
+// the same slot, or a dump reading it, can make a writer wait.
+//
+// push_back_lazy() stores the format string and the arguments instead of the formatted payload
+// (see lazy_format.h). They are formatted only if the message is dumped.
 
 namespace spdlog {
 namespace details {
 class SPDLOG_API backtracer {
-    mutable std::mutex mutex_;
-    std::atomic<bool> enabled_{false};
-    circular_q<log_msg_buffer> messages_;
-
 public:
     backtracer() = default;
     backtracer(const backtracer &other);
@@ -33,8 +41,62 @@ public:
     void push_back(const log_msg &msg);
     bool empty() const;
 
+#ifndef SPDLOG_USE_STD_FORMAT
+    // store msg with the payload fmt and args, to be formatted by foreach_pop().
+    // returns false if the arguments cannot be stored (and msg was not pushed).
+    template <typename... Args>
+    bool push_back_lazy(const log_msg &msg, string_view_t fmt, const Args &...args) {
+        memory_buf_t packed;
+        if (!lazy_format::pack(packed, fmt, args...)) {
+            return false;
+        }
+        log_msg lazy_msg(msg);
+        lazy_msg.payload = string_view_t(packed.data(), packed.size());
+        push_(lazy_msg, true);
+        return true;
+    }
+#endif
+
     // pop all items in the q and apply the given fun on each of them.
     void foreach_pop(std::function<void(const details::log_msg &)> fun);
+
+private:
+    struct slot {
+        // sequence number of the message + 1, shifted left. the lowest bit is set while the slot
+        // is written or read. 0 if the slot was never written.
+        std::atomic<uint64_t> state{0};
+        log_msg_buffer msg;
+        bool lazy = false;  // the payload is packed by lazy_format
+    };
+
+    struct entry {
+        log_msg_buffer msg;
+        bool lazy;
+    };
+
+    struct ring {
+        explicit ring(size_t n)
+            : size(n),
+              slots(new slot[n]) {}
+
+        const size_t size;
+        std::unique_ptr<slot[]> slots;
+        std::atomic<uint64_t> head{0};  // next sequence number
+        uint64_t tail = 0;              // first sequence number not popped yet
+    };
+
+    void push_(const log_msg &msg, bool lazy);
+    // copy the messages of the current ring, oldest first, and pop them if requested.
+    // called with mutex_ locked.
+    std::vector<entry> collect_(bool pop) const;
+    // replace the ring and wait until no writer uses the old one. called with mutex_ locked.
+    void replace_ring_(std::unique_ptr<ring> new_ring);
+
+    mutable std::mutex mutex_;  // serializes enable() and the dumps
+    std::atomic<bool> enabled_{false};
+    std::atomic<ring *> ring_{nullptr};
+    std::unique_ptr<ring> ring_owner_;
+    mutable read_epoch writers_epoch_;
 };
 
 }  // namespace details
@@ -0,0 +1,320 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+//
+// Compact binary encoding of log_msg, used by binary_tcp_sink.
+//
+// The stream is a sequence of frames: varint(frame size) type(1 byte) body.
+//
+//   hello         'S' 'P' 'D' 'B' version(1 byte)
+//   string        varint(id) varint(size) bytes
+//   source_loc    varint(id) varint(filename string id) varint(line) varint(funcname string id)
+//   record        zigzag varint(time delta in ns) level(1 byte) varint(logger name string id)
+//                 varint(thread id) varint(source_loc id, 0 = none) varint(size) payload
+//
+// Logger names and source locations are interned: each one is sent once (as a string/source_loc
+// frame) the first time it is used, and records refer to it by id. The time of each record is
+// encoded as the difference from the previous record's time (the first record is relative to the
+// epoch). A new stream (e.g. a new connection) must start with a hello and a reset encoder.
+//
+// binary_decoder reconstructs the log_msg objects from the stream and can feed them to any sink,
+// so a relay can pass them on without parsing text:
+//
+//     spdlog::details::binary_decoder decoder;
+//     while ((n = ::read(fd, buf, sizeof(buf))) > 0) {
+//         decoder.feed(buf, n, [&](const spdlog::details::log_msg &msg) {
+//             if (file_sink->should_log(msg.level)) file_sink->log(msg);
+//         });
+//     }
+//
+
+#include <spdlog/common.h>
+#include <spdlog/details/log_msg.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace spdlog {
+namespace details {
+
+namespace binary_protocol {
+static const char magic[4] = {'S', 'P', 'D', 'B'};
+static const uint8_t version = 1;
+static const size_t max_frame_size = 16 * 1024 * 1024;
+
+enum class frame_type : uint8_t { hello = 0, string = 1, source_loc = 2, record = 3 };
+
+inline void append_varint(uint64_t n, memory_buf_t &dest) {
+    while (n >= 0x80) {
+        dest.push_back(static_cast<char>((n & 0x7f) | 0x80));
+        n >>= 7;
+    }
+    dest.push_back(static_cast<char>(n));
+}
+
+// zigzag encoding maps small negative numbers to small unsigned numbers
+inline uint64_t zigzag(int64_t n) {
+    return (static_cast<uint64_t>(n) << 1) ^ static_cast<uint64_t>(n >> 63);
+}
+
+inline int64_t unzigzag(uint64_t n) {
+    return static_cast<int64_t>(n >> 1) ^ -static_cast<int64_t>(n & 1);
+}
+
+// read a varint from [pos, end). returns false if the data ends before the varint does.
+inline bool read_varint(const char *&pos, const char *end, uint64_t &n) {
+    n = 0;
+    for (unsigned shift = 0; pos < end && shift < 64; shift += 7) {
+        auto byte = static_cast<uint8_t>(*pos++);
+        n |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+}  // namespace binary_protocol
+
+class binary_encoder {
+public:
+    // start a new stream: forget the interned ids and append the hello frame
+    void reset(memory_buf_t &dest) {
+        strings_.clear();
+        source_locs_.clear();
+        last_name_.clear();
+        last_name_id_ = 0;
+        last_time_ns_ = 0;
+
+        frame_.clear();
+        frame_.append(binary_protocol::magic, binary_protocol::magic + 4);
+        frame_.push_back(static_cast<char>(binary_protocol::version));
+        append_frame_(binary_protocol::frame_type::hello, frame_, dest);
+    }
+
+    // append the frames of the given message (and of any string it uses for the first time)
+    void encode(const log_msg &msg, memory_buf_t &dest) {
+        using binary_protocol::append_varint;
+
+        // the logger name is usually the same as in the previous message (same logger)
+        if (last_name_id_ == 0 || msg.logger_name.size() != last_name_.size() ||
+            std::memcmp(msg.logger_name.data(), last_name_.data(), last_name_.size()) != 0) {
+            last_name_id_ = intern_string_(msg.logger_name, dest);
+            last_name_.assign(msg.logger_name.data(), msg.logger_name.size());
+        }
+        auto loc_id = msg.source.empty() ? 0 : intern_source_loc_(msg.source, dest);
+
+        auto time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           msg.time.time_since_epoch())
+                           .count();
+        frame_.clear();
+        append_varint(binary_protocol::zigzag(time_ns - last_time_ns_), frame_);
+        last_time_ns_ = time_ns;
+        frame_.push_back(static_cast<char>(msg.level));
+        append_varint(last_name_id_, frame_);
+        append_varint(msg.thread_id, frame_);
+        append_varint(loc_id, frame_);
+        append_varint(msg.payload.size(), frame_);
+        frame_.append(msg.payload.data(), msg.payload.data() + msg.payload.size());
+        append_frame_(binary_protocol::frame_type::record, frame_, dest);
+    }
+
+private:
+    static void append_frame_(binary_protocol::frame_type type,
+                              const memory_buf_t &body,
+                              memory_buf_t &dest) {
+        binary_protocol::append_varint(body.size() + 1, dest);
+        dest.push_back(static_cast<char>(type));
+        dest.append(body.data(), body.data() + body.size());
+    }
+
+    uint64_t intern_string_(string_view_t str, memory_buf_t &dest) {
+        using binary_protocol::append_varint;
+        std::string key(str.data(), str.size());
+        auto it = strings_.find(key);
+        if (it != strings_.end()) {
+            return it->second;
+        }
+        uint64_t id = strings_.size() + 1;
+        strings_.emplace(std::move(key), id);
+
+        memory_buf_t body;
+        append_varint(id, body);
+        append_varint(str.size(), body);
+        body.append(str.data(), str.data() + str.size());
+        append_frame_(binary_protocol::frame_type::string, body, dest);
+        return id;
+    }
+
+    // source locations are string literals, so they are keyed by address
+    uint64_t intern_source_loc_(const source_loc &loc, memory_buf_t &dest) {
+        using binary_protocol::append_varint;
+        auto key = std::make_tuple(static_cast<const void *>(loc.filename), loc.line,
+                                   static_cast<const void *>(loc.funcname));
+        auto it = source_locs_.find(key);
+        if (it != source_locs_.end()) {
+            return it->second;
+        }
+        auto filename_id = intern_string_(loc.filename ? loc.filename : "", dest);
+        auto funcname_id = intern_string_(loc.funcname ? loc.funcname : "", dest);
+        uint64_t id = source_locs_.size() + 1;
+        source_locs_.emplace(key, id);
+
+        memory_buf_t body;
+        append_varint(id, body);
+        append_varint(filename_id, body);
+        append_varint(static_cast<uint64_t>(loc.line), body);
+        append_varint(funcname_id, body);
+        append_frame_(binary_protocol::frame_type::source_loc, body, dest);
+        return id;
+    }
+
+    std::unordered_map<std::string, uint64_t> strings_;
+    std::map<std::tuple<const void *, int, const void *>, uint64_t> source_locs_;
+    std::string last_name_;
+    uint64_t last_name_id_ = 0;
+    int64_t last_time_ns_ = 0;
+    memory_buf_t frame_;
+};
+
+class binary_decoder {
+public:
+    // decode as many complete frames as possible from the data received so far (including
+    // the given bytes), calling on_msg(const log_msg &) for each record.
+    // the log_msg and the strings it points to are valid only during the callback.
+    // throws spdlog_ex on malformed input.
+    template <typename OnMsg>
+    void feed(const char *data, size_t size, OnMsg &&on_msg) {
+        buf_.append(data, data + size);
+        const char *pos = buf_.data();
+        const char *end = buf_.data() + buf_.size();
+        for (;;) {
+            const char *frame_start = pos;
+            uint64_t frame_size;
+            if (!binary_protocol::read_varint(pos, end, frame_size)) {
+                pos = frame_start;
+                break;
+            }
+            if (frame_size == 0 || frame_size > binary_protocol::max_frame_size) {
+                throw_spdlog_ex("binary_decoder: invalid frame size");
+            }
+            if (static_cast<uint64_t>(end - pos) < frame_size) {
+                pos = frame_start;
+                break;
+            }
+            decode_frame_(pos, pos + frame_size, on_msg);
+            pos += frame_size;
+        }
+        // keep the incomplete frame for the next call
+        auto consumed = static_cast<size_t>(pos - buf_.data());
+        std::memmove(buf_.data(), pos, buf_.size() - consumed);
+        buf_.resize(buf_.size() - consumed);
+    }
+
+private:
+    struct decoded_source_loc {
+        uint64_t filename_id;
+        int line;
+        uint64_t funcname_id;
+    };
+
+    template <typename OnMsg>
+    void decode_frame_(const char *pos, const char *end, OnMsg &on_msg) {
+        auto type = static_cast<binary_protocol::frame_type>(*pos++);
+        switch (type) {
+            case binary_protocol::frame_type::hello:
+                if (end - pos != 5 || std::memcmp(pos, binary_protocol::magic, 4) != 0 ||
+                    static_cast<uint8_t>(pos[4]) != binary_protocol::version) {
+                    throw_spdlog_ex("binary_decoder: unsupported stream");
+                }
+                // new stream
+                strings_.clear();
+                source_locs_.clear();
+                last_time_ns_ = 0;
+                break;
+            case binary_protocol::frame_type::string: {
+                auto id = read_(pos, end);
+                auto size = read_(pos, end);
+                if (id != strings_.size() + 1 || size > static_cast<uint64_t>(end - pos)) {
+                    throw_spdlog_ex("binary_decoder: invalid string frame");
+                }
+                strings_.emplace_back(pos, static_cast<size_t>(size));
+                break;
+            }
+            case binary_protocol::frame_type::source_loc: {
+                auto id = read_(pos, end);
+                decoded_source_loc loc;
+                loc.filename_id = read_(pos, end);
+                loc.line = static_cast<int>(read_(pos, end));
+                loc.funcname_id = read_(pos, end);
+                if (id != source_locs_.size() + 1) {
+                    throw_spdlog_ex("binary_decoder: invalid source_loc frame");
+                }
+                source_locs_.push_back(loc);
+                break;
+            }
+            case binary_protocol::frame_type::record: {
+                last_time_ns_ += binary_protocol::unzigzag(read_(pos, end));
+                if (pos == end) {
+                    throw_spdlog_ex("binary_decoder: truncated record");
+                }
+                auto level_byte = static_cast<uint8_t>(*pos++);
+                const auto &logger_name = string_(read_(pos, end));
+                auto thread_id = read_(pos, end);
+                auto loc_id = read_(pos, end);
+                auto size = read_(pos, end);
+                if (size > static_cast<uint64_t>(end - pos) || level_byte > level::off ||
+                    loc_id > source_locs_.size()) {
+                    throw_spdlog_ex("binary_decoder: invalid record");
+                }
+
+                source_loc loc;
+                if (loc_id > 0) {
+                    const auto &l = source_locs_[loc_id - 1];
+                    loc = source_loc{string_(l.filename_id).c_str(), l.line,
+                                     string_(l.funcname_id).c_str()};
+                }
+                log_clock::time_point time(std::chrono::duration_cast<log_clock::duration>(
+                    std::chrono::nanoseconds(last_time_ns_)));
+                log_msg msg(time, loc, logger_name, static_cast<level::level_enum>(level_byte),
+                            string_view_t(pos, static_cast<size_t>(size)));
+                msg.thread_id = static_cast<size_t>(thread_id);
+                on_msg(static_cast<const log_msg &>(msg));
+                break;
+            }
+            default:
+                throw_spdlog_ex("binary_decoder: unknown frame type");
+        }
+    }
+
+    static uint64_t read_(const char *&pos, const char *end) {
+        uint64_t n;
+        if (!binary_protocol::read_varint(pos, end, n)) {
+            throw_spdlog_ex("binary_decoder: truncated frame");
+        }
+        return n;
+    }
+
+    const std::string &string_(uint64_t id) const {
+        if (id == 0 || id > strings_.size()) {
+            throw_spdlog_ex("binary_decoder: unknown string id");
+        }
+        return strings_[id - 1];
+    }
+
+    memory_buf_t buf_;
+    std::deque<std::string> strings_;  // deque, so c_str() stays valid as strings are added
+    std::vector<decoded_source_loc> source_locs_;
+    int64_t last_time_ns_ = 0;
+};
+
+}  // namespace details
+}  // namespace spdlog
@@ -0,0 +1,121 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef SPDLOG_HEADER_ONLY
+    #include <spdlog/details/callsite.h>
+#endif
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace spdlog {
+namespace details {
+
+SPDLOG_INLINE std::atomic<uint32_t> &level_epoch() {
+    static std::atomic<uint32_t> epoch{1};
+    return epoch;
+}
+
+SPDLOG_INLINE void bump_level_epoch() { level_epoch().fetch_add(1, std::memory_order_release); }
+
+SPDLOG_INLINE uint32_t next_callsite_key() {
+    static std::atomic<uint32_t> last_key{0};
+    return last_key.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+SPDLOG_INLINE void register_callsite(callsite *site) { callsite_registry::instance().add(site); }
+
+SPDLOG_INLINE callsite_registry &callsite_registry::instance() {
+    static callsite_registry s_instance;
+    return s_instance;
+}
+
+SPDLOG_INLINE void callsite_registry::add(callsite *site) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    callsites_.push_back(site);
+    bool changed = false;
+    for (const auto &rule : rules_) {
+        if (matches_(rule.first, *site)) {
+            site->mode_.store(static_cast<int>(rule.second), std::memory_order_relaxed);
+            changed = true;
+        }
+    }
+    // another thread may have cached a check of this callsite before the rules were applied
+    if (changed) {
+        bump_level_epoch();
+    }
+}
+
+SPDLOG_INLINE size_t callsite_registry::set_mode(const std::string &spec, callsite_mode mode) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rules_.erase(std::remove_if(rules_.begin(), rules_.end(),
+                                [&spec](const std::pair<std::string, callsite_mode> &rule) {
+                                    return rule.first == spec;
+                                }),
+                 rules_.end());
+    rules_.emplace_back(spec, mode);
+    size_t matched = 0;
+    for (auto *site : callsites_) {
+        if (matches_(spec, *site)) {
+            site->mode_.store(static_cast<int>(mode), std::memory_order_relaxed);
+            matched++;
+        }
+    }
+    bump_level_epoch();
+    return matched;
+}
+
+SPDLOG_INLINE void callsite_registry::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rules_.clear();
+    for (auto *site : callsites_) {
+        site->mode_.store(static_cast<int>(callsite_mode::level), std::memory_order_relaxed);
+    }
+    bump_level_epoch();
+}
+
+SPDLOG_INLINE std::vector<callsite_info> callsite_registry::callsites() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<callsite_info> result;
+    result.reserve(callsites_.size());
+    for (const auto *site : callsites_) {
+        result.push_back(callsite_info{site->filename() ? site->filename() : "", site->line(),
+                                       site->funcname() ? site->funcname() : "", site->mode()});
+    }
+    return result;
+}
+
+SPDLOG_INLINE bool callsite_registry::matches_(const std::string &spec, const callsite &site) {
+    // "file:line"
+    std::string file = spec;
+    int line = 0;
+    auto colon = spec.rfind(':');
+    if (colon != std::string::npos && colon + 1 < spec.size() &&
+        spec.find_first_not_of("0123456789", colon + 1) == std::string::npos) {
+        file = spec.substr(0, colon);
+        line = std::atoi(spec.c_str() + colon + 1);
+    } else if (spec.find_first_of("./\\") == std::string::npos) {
+        // function name
+        return site.funcname() != nullptr && spec == site.funcname();
+    }
+
+    if (site.filename() == nullptr || (line != 0 && line != site.line())) {
+        return false;
+    }
+    // the path must end with the spec, at a path separator
+    size_t len = std::strlen(site.filename());
+    if (file.empty() || file.size() > len) {
+        return false;
+    }
+    const char *suffix = site.filename() + len - file.size();
+    if (file.compare(suffix) != 0) {
+        return false;
+    }
+    return suffix == site.filename() || suffix[-1] == '/' || suffix[-1] == '\\';
+}
+
+}  // namespace details
+}  // namespace spdlog
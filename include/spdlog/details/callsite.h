@@ -0,0 +1,185 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <spdlog/common.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Per callsite state of the SPDLOG_* macros, used when SPDLOG_CALLSITE_CACHE is defined.
+//
+// Each macro callsite keeps a static callsite object with the result of its last level check,
+// tagged with the logger, the level and the global level epoch. The epoch is bumped by every
+// change that can affect a level check (set_level, enable/disable_backtrace, set_default_logger,
+// callsite modes), so until then a disabled statement costs two relaxed loads and a branch,
+// without calling into the logger.
+//
+// The first time a callsite is reached it registers itself in the callsite_registry, where
+// single statements can be turned on (logged regardless of the logger level) or off at runtime,
+// by file:line, file or function name.
+
+namespace spdlog {
+namespace details {
+
+class callsite;
+
+// the global level epoch
+SPDLOG_API std::atomic<uint32_t> &level_epoch();
+
+// invalidate the level checks cached by all callsites
+SPDLOG_API void bump_level_epoch();
+
+// unique key of a logger instance (0 is used for the default logger)
+SPDLOG_API uint32_t next_callsite_key();
+
+// add the callsite to callsite_registry::instance()
+SPDLOG_API void register_callsite(callsite *site);
+
+enum class callsite_mode {
+    level,  // log if the logger level allows (the default)
+    on,     // log regardless of the logger level
+    off     // never log
+};
+
+class callsite {
+public:
+    enum action { skip, log, force_log };
+
+    constexpr callsite(const char *filename, int line, const char *funcname)
+        : filename_{filename},
+          line_{line},
+          funcname_{funcname} {}
+
+    callsite(const callsite &) = delete;
+    callsite &operator=(const callsite &) = delete;
+
+    // what to do with a message of the given level: skip it, log it (the logger checks its
+    // level again, and may only keep it for backtrace), or log it regardless of the level
+    template <typename Logger>
+    action check(const Logger &logger, level::level_enum lvl) {
+        return check(logger.callsite_key(), lvl, [&logger]() { return &logger; });
+    }
+
+    // same for the logger returned by get_logger(), which is called only when the cached result
+    // is stale. used with key 0 for the default logger.
+    template <typename GetLogger>
+    action check(uint32_t key, level::level_enum lvl, GetLogger &&get_logger) {
+        const auto *epoch = epoch_.load(std::memory_order_relaxed);
+        if (epoch != nullptr) {
+            auto tag = make_tag_(key, epoch->load(std::memory_order_relaxed), lvl);
+            auto cached = cached_.load(std::memory_order_relaxed);
+            if ((cached >> 2) == tag) {
+                return static_cast<action>(cached & 3);
+            }
+        } else {
+            epoch = &level_epoch();
+            const std::atomic<uint32_t> *expected = nullptr;
+            if (epoch_.compare_exchange_strong(expected, epoch, std::memory_order_relaxed)) {
+                register_callsite(this);
+            }
+        }
+
+        // load the epoch before the levels and the mode, so a change after this point is
+        // detected by the next check
+        auto tag = make_tag_(key, epoch->load(std::memory_order_acquire), lvl);
+        auto current_mode = mode();
+        action result = skip;
+        const auto *logger = current_mode == callsite_mode::off ? nullptr : get_logger();
+        if (logger != nullptr) {
+            if (logger->should_log(lvl) || logger->should_backtrace()) {
+                result = log;
+            }
+            if (current_mode == callsite_mode::on && !logger->should_log(lvl)) {
+                result = force_log;
+            }
+        }
+        cached_.store((tag << 2) | static_cast<uint64_t>(result), std::memory_order_relaxed);
+        return result;
+    }
+
+    const char *filename() const { return filename_; }
+
+    int line() const { return line_; }
+
+    const char *funcname() const { return funcname_; }
+
+    callsite_mode mode() const {
+        return static_cast<callsite_mode>(mode_.load(std::memory_order_relaxed));
+    }
+
+private:
+    friend class callsite_registry;
+
+    // key (32 bits) | epoch (27 bits) | level (3 bits). the action is stored in the lowest bits.
+    static uint64_t make_tag_(uint32_t key, uint32_t epoch, level::level_enum lvl) {
+        return (uint64_t{key} << 30) | (uint64_t{epoch & 0x07ffffff} << 3) |
+               static_cast<uint64_t>(lvl & 7);
+    }
+
+    const char *filename_;
+    int line_;
+    const char *funcname_;
+    std::atomic<int> mode_{0};
+    std::atomic<const std::atomic<uint32_t> *> epoch_{nullptr};
+    std::atomic<uint64_t> cached_{0};
+};
+
+struct callsite_info {
+    std::string filename;
+    int line;
+    std::string funcname;
+    callsite_mode mode;
+};
+
+//
+// Callsites reached so far, and the modes set for them.
+// A mode is set for all callsites matching a spec:
+//     "file.cpp:42"   the statement at line 42 of file.cpp
+//     "file.cpp"      all statements in file.cpp
+//     "func"          all statements in functions named func
+// Files match if the path given by __FILE__ ends with the spec (e.g. "net/conn.cpp").
+// The modes are kept as rules, applied in order to the callsites that are reached later.
+// Callsites are never removed, so a shared library using the macros must not be unloaded.
+// This class is thread safe.
+//
+class SPDLOG_API callsite_registry {
+public:
+    callsite_registry(const callsite_registry &) = delete;
+    callsite_registry &operator=(const callsite_registry &) = delete;
+
+    static callsite_registry &instance();
+
+    void add(callsite *site);
+
+    // set the mode of the callsites matching spec.
+    // returns the number of already reached callsites that matched.
+    size_t set_mode(const std::string &spec, callsite_mode mode);
+
+    // remove all rules and set all callsites back to callsite_mode::level
+    void reset();
+
+    // the callsites reached so far
+    std::vector<callsite_info> callsites() const;
+
+private:
+    callsite_registry() = default;
+
+    static bool matches_(const std::string &spec, const callsite &site);
+
+    mutable std::mutex mutex_;
+    std::vector<callsite *> callsites_;
+    std::vector<std::pair<std::string, callsite_mode>> rules_;
+};
+
+}  // namespace details
+}  // namespace spdlog
+
+#ifdef SPDLOG_HEADER_ONLY
+    #include "callsite-inl.h"
+#endif
@@ -0,0 +1,51 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <spdlog/common.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace spdlog {
+namespace details {
+
+// datagrams collected to be sent together (e.g. with sendmmsg), stored back to back in data
+struct datagram_batch {
+    memory_buf_t data;
+    std::vector<size_t> sizes;  // size of each datagram in data
+
+    void append(const char *datagram, size_t size) {
+        data.append(datagram, datagram + size);
+        sizes.push_back(size);
+    }
+
+    // the bytes appended to data since it had start_size bytes are the next datagram
+    void end_datagram(size_t start_size) { sizes.push_back(data.size() - start_size); }
+
+    bool empty() const { return sizes.empty(); }
+
+    size_t count() const { return sizes.size(); }
+
+    void clear() {
+        data.clear();
+        sizes.clear();
+    }
+
+    // clears the batch when going out of scope: a batch is discarded even if sending it failed
+    class clear_guard {
+    public:
+        explicit clear_guard(datagram_batch &batch)
+            : batch_(batch) {}
+        ~clear_guard() { batch_.clear(); }
+        clear_guard(const clear_guard &) = delete;
+        clear_guard &operator=(const clear_guard &) = delete;
+
+    private:
+        datagram_batch &batch_;
+    };
+};
+
+}  // namespace details
+}  // namespace spdlog
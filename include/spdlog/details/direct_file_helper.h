@@ -0,0 +1,315 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifdef _WIN32
+    #error "direct_file_helper is not supported on windows"
+#endif
+
+//
+// Drop-in replacement for file_helper that writes with O_DIRECT, so log traffic doesn't evict
+// the application's data from the page cache.
+//
+// Writes are collected in an internal aligned buffer and written in whole blocks. flush() writes
+// the partial last block too, padded - the partial block is kept in the buffer and rewritten on
+// the next flush. The padding is zeros followed by a 16 byte trailer that records its length
+// (so it may extend into the next block). The file stays extended to the block boundary, so
+// flushing doesn't update the file size each time, and is truncated back to its real size by
+// close() (and so before a rotation). Readers of an open file may see the padding at its end; if
+// the process dies before close(), the padding is trimmed when the file is opened again. Only
+// padding that ends with a valid trailer is trimmed, so logged zero bytes are kept.
+//
+// If the file system doesn't support O_DIRECT (e.g. tmpfs), the file is opened without it and
+// the same block aligned writes are used.
+//
+// Only the before_open and after_close event handlers are called (there is no FILE* to pass).
+//
+
+#include <spdlog/common.h>
+#include <spdlog/details/file_helper.h>
+#include <spdlog/details/os.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace spdlog {
+namespace details {
+
+class direct_file_helper {
+public:
+    static constexpr size_t alignment = 4096;
+
+    direct_file_helper() = default;
+
+    explicit direct_file_helper(const file_event_handlers &event_handlers,
+                                size_t buffer_size = 64 * 1024)
+        : event_handlers_{event_handlers},
+          capacity_{buffer_size > alignment ? buffer_size / alignment * alignment : alignment} {}
+
+    direct_file_helper(const direct_file_helper &) = delete;
+    direct_file_helper &operator=(const direct_file_helper &) = delete;
+
+    ~direct_file_helper() {
+        SPDLOG_TRY { close(); }
+        SPDLOG_CATCH_STD
+        std::free(buf_);
+    }
+
+    void open(const filename_t &fname, bool truncate = false) {
+        close();
+        filename_ = fname;
+        // one more block for padding that extends past the buffer (see flush())
+        if (buf_ == nullptr && ::posix_memalign(reinterpret_cast<void **>(&buf_), alignment,
+                                                capacity_ + alignment) != 0) {
+            buf_ = nullptr;
+            throw_spdlog_ex("direct_file_helper: failed allocating aligned buffer");
+        }
+
+        if (event_handlers_.before_open) {
+            event_handlers_.before_open(filename_);
+        }
+        os::create_dir(os::dir_name(fname));
+        int flags = O_RDWR | O_CREAT;
+#ifdef O_CLOEXEC
+        flags |= O_CLOEXEC;
+#endif
+        if (truncate) {
+            flags |= O_TRUNC;
+        }
+        direct_ = false;
+#ifdef O_DIRECT
+        fd_ = ::open(fname.c_str(), flags | O_DIRECT, 0644);
+        direct_ = fd_ != -1;
+        if (fd_ == -1 && errno == EINVAL) {
+            fd_ = ::open(fname.c_str(), flags, 0644);
+        }
+#else
+        fd_ = ::open(fname.c_str(), flags, 0644);
+#endif
+        if (fd_ == -1) {
+            throw_spdlog_ex("Failed opening file " + filename_ + " for writing", errno);
+        }
+
+        // continue from the last block boundary, keeping the partial last block in the buffer
+        struct stat st;
+        if (::fstat(fd_, &st) != 0) {
+            throw_spdlog_ex("Failed getting file size " + filename_, errno);
+        }
+        file_size_ = static_cast<size_t>(st.st_size);
+        // ignore the padding left by a flush() that wasn't followed by close()
+        auto data_size = file_size_ - padding_size_();
+        padded_ = data_size != file_size_;
+        file_offset_ = data_size / alignment * alignment;
+        buf_len_ = data_size - file_offset_;
+        if (buf_len_ > 0 && ::pread(fd_, buf_, alignment, static_cast<off_t>(file_offset_)) <
+                                static_cast<ssize_t>(buf_len_)) {
+            throw_spdlog_ex("Failed reading last block of " + filename_, errno);
+        }
+    }
+
+    void reopen(bool truncate) {
+        if (filename_.empty()) {
+            throw_spdlog_ex("Failed re opening file - was not opened before");
+        }
+        open(filename_, truncate);
+    }
+
+    void flush() {
+        if (fd_ == -1 || buf_len_ == 0) {
+            return;
+        }
+        auto padded = buf_len_;
+        if (buf_len_ % alignment != 0) {
+            padded = (buf_len_ + trailer_size + alignment - 1) / alignment * alignment;
+            write_padding_(buf_ + buf_len_, padded - buf_len_);
+            // the padding stays in the file until close()
+            padded_ = true;
+        }
+        write_blocks_(padded);
+        // drop the complete blocks from the buffer and keep the partial one
+        auto complete = buf_len_ / alignment * alignment;
+        std::memmove(buf_, buf_ + complete, buf_len_ - complete);
+        file_offset_ += complete;
+        buf_len_ -= complete;
+        if (buf_len_ == 0) {
+            replace_stale_padding_();
+        }
+    }
+
+    void sync() {
+        flush();
+        if (fd_ != -1 && ::fsync(fd_) != 0) {
+            throw_spdlog_ex("Failed to fsync file " + filename_, errno);
+        }
+    }
+
+    void sync_data() {
+        flush();
+#if defined(__linux__)
+        if (fd_ != -1 && ::fdatasync(fd_) != 0) {
+#else
+        if (fd_ != -1 && ::fsync(fd_) != 0) {
+#endif
+            throw_spdlog_ex("Failed to fdatasync file " + filename_, errno);
+        }
+    }
+
+    void close() {
+        if (fd_ == -1) {
+            return;
+        }
+        flush();
+        // drop the padding of the last block and the unused preallocated space
+        bool truncated = true;
+        if (padded_ || preallocated_size_ > 0) {
+            truncated = ::ftruncate(fd_, static_cast<off_t>(file_offset_ + buf_len_)) == 0;
+        }
+        auto truncate_errno = errno;
+        ::close(fd_);
+        fd_ = -1;
+        file_size_ = 0;
+        file_offset_ = 0;
+        buf_len_ = 0;
+        padded_ = false;
+        preallocated_size_ = 0;
+        if (event_handlers_.after_close) {
+            event_handlers_.after_close(filename_);
+        }
+        if (!truncated) {
+            throw_spdlog_ex("Failed truncating file " + filename_, truncate_errno);
+        }
+    }
+
+    void write(const memory_buf_t &buf) {
+        if (fd_ == -1) return;
+        const char *data = buf.data();
+        size_t remaining = buf.size();
+        while (remaining > 0) {
+            auto n = (std::min)(remaining, capacity_ - buf_len_);
+            std::memcpy(buf_ + buf_len_, data, n);
+            buf_len_ += n;
+            data += n;
+            remaining -= n;
+            if (buf_len_ == capacity_) {
+                write_blocks_(capacity_);
+                file_offset_ += capacity_;
+                buf_len_ = 0;
+                replace_stale_padding_();
+            }
+        }
+    }
+
+    size_t size() const { return file_offset_ + buf_len_; }
+
+    const filename_t &filename() const { return filename_; }
+
+    // reserve disk space for the file up to the given size. unused space is released on close.
+    void preallocate(size_t size) {
+#if defined(__linux__) && defined(FALLOC_FL_KEEP_SIZE)
+        if (fd_ != -1 &&
+            ::fallocate(fd_, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(size)) == 0) {
+            preallocated_size_ = size;
+        }
+#else
+        (void)size;
+#endif
+    }
+
+    // true if the file was opened with O_DIRECT
+    bool direct() const { return direct_; }
+
+private:
+    static constexpr size_t trailer_size = 16;
+
+    static const char *trailer_magic_() { return "spdlgpad"; }
+
+    // zeros, then the trailer: 8 magic bytes and the padding length (trailer included)
+    static void write_padding_(char *dest, size_t length) {
+        std::memset(dest, 0, length - trailer_size);
+        auto *trailer = dest + length - trailer_size;
+        std::memcpy(trailer, trailer_magic_(), 8);
+        auto stored = static_cast<uint64_t>(length);
+        std::memcpy(trailer + 8, &stored, sizeof(stored));
+    }
+
+    // the length of the padding at the end of the file, or 0 if it doesn't end with a valid
+    // padding. reads the last 2 blocks into buf_.
+    size_t padding_size_() {
+        if (file_size_ < alignment || file_size_ % alignment != 0) {
+            return 0;
+        }
+        auto n_bytes = file_size_ >= 2 * alignment ? 2 * alignment : alignment;
+        if (::pread(fd_, buf_, n_bytes, static_cast<off_t>(file_size_ - n_bytes)) !=
+            static_cast<ssize_t>(n_bytes)) {
+            throw_spdlog_ex("Failed reading last block of " + filename_, errno);
+        }
+        const auto *trailer = buf_ + n_bytes - trailer_size;
+        uint64_t length = 0;
+        std::memcpy(&length, trailer + 8, sizeof(length));
+        if (std::memcmp(trailer, trailer_magic_(), 8) != 0 || length < trailer_size ||
+            length > n_bytes) {
+            return 0;
+        }
+        auto zeros_end = trailer - buf_;
+        auto zeros_begin = n_bytes - static_cast<size_t>(length);
+        auto is_zero = [](char c) { return c == '\0'; };
+        if (!std::all_of(buf_ + zeros_begin, buf_ + zeros_end, is_zero)) {
+            return 0;
+        }
+        return static_cast<size_t>(length);
+    }
+
+    // a flush() whose padding extended into the next block leaves the rest of it there when the
+    // data reaches the block boundary, with a trailer that no longer matches the data. called
+    // with an empty buffer: replaces it with a block of padding.
+    void replace_stale_padding_() {
+        if (file_size_ > file_offset_) {
+            write_padding_(buf_, alignment);
+            write_blocks_(alignment);
+            padded_ = true;
+        }
+    }
+
+    // n_bytes is a multiple of alignment. after a short write with O_DIRECT, continue from the
+    // last complete block, since O_DIRECT needs block aligned offsets and sizes.
+    void write_blocks_(size_t n_bytes) {
+        size_t written = 0;
+        while (written < n_bytes) {
+            auto rv = ::pwrite(fd_, buf_ + written, n_bytes - written,
+                               static_cast<off_t>(file_offset_ + written));
+            if (rv < 0) {
+                if (errno == EINTR) continue;
+                throw_spdlog_ex("Failed writing to file " + filename_, errno);
+            }
+            if (rv == 0) {
+                throw_spdlog_ex("Failed writing to file " + filename_ + " (no progress)");
+            }
+            auto n = static_cast<size_t>(rv);
+            written += direct_ ? n / alignment * alignment : n;
+        }
+        file_size_ = (std::max)(file_size_, file_offset_ + n_bytes);
+    }
+
+    file_event_handlers event_handlers_;
+    size_t capacity_ = 64 * 1024;
+    char *buf_ = nullptr;
+    size_t buf_len_ = 0;
+    size_t file_size_ = 0;    // the size of the file, including the padding
+    size_t file_offset_ = 0;  // file offset of buf_[0], always block aligned
+    int fd_ = -1;
+    bool direct_ = false;
+    bool padded_ = false;  // the file ends with padding (see flush())
+    size_t preallocated_size_ = 0;
+    filename_t filename_;
+};
+
+}  // namespace details
+}  // namespace spdlog
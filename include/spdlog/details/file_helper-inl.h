@@ -82,12 +82,25 @@ SPDLOG_INLINE void file_helper::sync() {
     }
 }
 
+SPDLOG_INLINE void file_helper::sync_data() {
+    if (!os::fdatasync(fd_)) {
+        throw_spdlog_ex("Failed to fdatasync file " + os::filename_to_str(filename_), errno);
+    }
+}
+
 SPDLOG_INLINE void file_helper::close() {
     if (fd_ != nullptr) {
         if (event_handlers_.before_close) {
             event_handlers_.before_close(filename_, fd_);
         }
 
+        // release the reserved space beyond the written size
+        if (preallocated_) {
+            std::fflush(fd_);
+            (void)os::truncate(fd_, os::filesize(fd_));
+            preallocated_ = false;
+        }
+
         std::fclose(fd_);
         fd_ = nullptr;
 
@@ -115,6 +128,12 @@ SPDLOG_INLINE size_t file_helper::size() const {
 
 SPDLOG_INLINE const filename_t &file_helper::filename() const { return filename_; }
 
+SPDLOG_INLINE void file_helper::preallocate(size_t size) {
+    if (fd_ != nullptr && os::fallocate(fd_, size)) {
+        preallocated_ = true;
+    }
+}
+
 //
 // return file path and its extension:
 //
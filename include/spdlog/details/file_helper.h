@@ -26,11 +26,16 @@ public:
     void reopen(bool truncate);
     void flush();
     void sync();
+    void sync_data();
     void close();
     void write(const memory_buf_t &buf);
     size_t size() const;
     const filename_t &filename() const;
 
+    // reserve disk space for the file up to the given size (if supported by the platform),
+    // so appends don't need to allocate new blocks. unused space is released on close.
+    void preallocate(size_t size);
+
     //
     // return file path and its extension:
     //
@@ -50,9 +55,30 @@ private:
     const int open_tries_ = 5;
     const unsigned int open_interval_ = 10;
     std::FILE *fd_{nullptr};
+    bool preallocated_ = false;
     filename_t filename_;
     file_event_handlers event_handlers_;
 };
+
+template <typename FileHelper>
+auto would_exceed_(FileHelper &helper, size_t max_size, size_t msg_size, int)
+    -> decltype(helper.would_exceed(max_size, msg_size)) {
+    return helper.would_exceed(max_size, msg_size);
+}
+
+template <typename FileHelper>
+bool would_exceed_(FileHelper &, size_t, size_t, long) {
+    return true;
+}
+
+// called by the size based sinks when their estimate (the bytes written so far) says that
+// writing msg_size more bytes makes the file exceed max_size. file helpers whose files are
+// smaller than what is written to them (e.g. gzip_file_helper) implement would_exceed(max_size,
+// msg_size) to check it against their own size, for the others the estimate is used as is.
+template <typename FileHelper>
+bool would_exceed(FileHelper &helper, size_t max_size, size_t msg_size) {
+    return would_exceed_(helper, max_size, msg_size, 0);
+}
 }  // namespace details
 }  // namespace spdlog
 
@@ -0,0 +1,188 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+//
+// Drop-in replacement for file_helper that gzip-compresses everything written through it.
+// Requires zlib (https://zlib.net) - link with -lz.
+//
+// Each flush() ends the current gzip member, so the file is always a valid (multi member) gzip
+// stream up to the last flush and can be read with zcat/gunzip at any time.
+// size() returns the number of compressed bytes in the file.
+// Compression is synchronous: it runs in the thread that writes the message.
+//
+
+#include <spdlog/common.h>
+#include <spdlog/details/file_helper.h>
+#include <spdlog/details/os.h>
+
+#include <string>
+#include <zlib.h>
+
+namespace spdlog {
+namespace details {
+
+class gzip_file_helper {
+public:
+    gzip_file_helper() { init_stream_(); }
+
+    explicit gzip_file_helper(const file_event_handlers &event_handlers,
+                              int compression_level = Z_DEFAULT_COMPRESSION)
+        : file_helper_{event_handlers},
+          compression_level_{compression_level} {
+        init_stream_();
+    }
+
+    gzip_file_helper(const gzip_file_helper &) = delete;
+    gzip_file_helper &operator=(const gzip_file_helper &) = delete;
+
+    ~gzip_file_helper() {
+        SPDLOG_TRY { close(); }
+        SPDLOG_CATCH_STD
+        ::deflateEnd(&stream_);
+    }
+
+    void open(const filename_t &fname, bool truncate = false) {
+        close();
+        file_helper_.open(fname, truncate);
+        reset_size_();
+    }
+
+    void reopen(bool truncate) {
+        close();
+        file_helper_.reopen(truncate);
+        reset_size_();
+    }
+
+    // end the current gzip member and flush it to disk
+    void flush() {
+        if (member_open_) {
+            deflate_(Z_FINISH);
+            if (::deflateReset(&stream_) != Z_OK) {
+                throw_spdlog_ex("gzip_file_helper: deflateReset failed");
+            }
+            member_open_ = false;
+        }
+        file_helper_.flush();
+    }
+
+    void sync() {
+        flush();
+        file_helper_.sync();
+    }
+
+    void sync_data() {
+        flush();
+        file_helper_.sync_data();
+    }
+
+    void close() {
+        if (member_open_) {
+            flush();
+        }
+        file_helper_.close();
+    }
+
+    void write(const memory_buf_t &buf) {
+        if (buf.size() == 0) {
+            return;
+        }
+        stream_.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(buf.data()));
+        stream_.avail_in = static_cast<uInt>(buf.size());
+        member_open_ = true;
+        unchecked_size_ += buf.size();
+        deflate_(Z_NO_FLUSH);
+    }
+
+    // called by the size based sinks when the uncompressed bytes alone would make the file
+    // exceed max_size (see details::would_exceed): true if writing msg_size more bytes might
+    // make the compressed file exceed it.
+    // the compressed size is only known after ending the gzip member, so it is estimated from
+    // the compression ratio seen at the previous check, and checked again when half of the
+    // remaining space is estimated to be used (keeping max_size / 32 in reserve), or after
+    // max_size uncompressed bytes. the file is reported full up to max_size / 16 early: checking
+    // until it is exactly full would end it with many small members, which compress worse.
+    bool would_exceed(size_t max_size, size_t msg_size) {
+        if (unchecked_size_ + msg_size <= check_after_) {
+            return false;
+        }
+        flush();
+        if (unchecked_size_ > 0 && compressed_size_ > checked_size_) {
+            ratio_ = static_cast<double>(compressed_size_ - checked_size_) /
+                     static_cast<double>(unchecked_size_);
+        }
+        checked_size_ = compressed_size_;
+        unchecked_size_ = 0;
+        check_after_ = 0;
+        if (compressed_size_ >= max_size ||
+            max_size - compressed_size_ <= msg_size + max_size / 16) {
+            return true;
+        }
+        auto remaining = max_size - compressed_size_ - msg_size - max_size / 32;
+        auto estimate = static_cast<double>(remaining) * 0.5 / ratio_;
+        check_after_ = estimate < static_cast<double>(max_size) ? static_cast<size_t>(estimate)
+                                                                : max_size;
+        return false;
+    }
+
+    // compressed bytes written to the file so far.
+    // data still buffered inside the compressor is not counted until the next flush.
+    size_t size() const { return compressed_size_; }
+
+    const filename_t &filename() const { return file_helper_.filename(); }
+
+    void preallocate(size_t size) { file_helper_.preallocate(size); }
+
+private:
+    void init_stream_() {
+        // windowBits 15 + 16 tells zlib to write a gzip header and trailer
+        if (::deflateInit2(&stream_, compression_level_, Z_DEFLATED, 15 + 16, 8,
+                           Z_DEFAULT_STRATEGY) != Z_OK) {
+            throw_spdlog_ex("gzip_file_helper: deflateInit2 failed");
+        }
+    }
+
+    void reset_size_() {
+        compressed_size_ = file_helper_.size();
+        checked_size_ = compressed_size_;
+        unchecked_size_ = 0;
+        check_after_ = 0;
+    }
+
+    // run the compressor over all pending input and write whatever it produced
+    void deflate_(int flush_mode) {
+        int rv;
+        do {
+            out_buf_.resize(out_chunk_size);
+            stream_.next_out = reinterpret_cast<Bytef *>(out_buf_.data());
+            stream_.avail_out = static_cast<uInt>(out_buf_.size());
+            rv = ::deflate(&stream_, flush_mode);
+            if (rv == Z_STREAM_ERROR) {
+                throw_spdlog_ex("gzip_file_helper: deflate failed for file " +
+                                os::filename_to_str(filename()));
+            }
+            auto produced = out_buf_.size() - stream_.avail_out;
+            if (produced > 0) {
+                out_buf_.resize(produced);
+                file_helper_.write(out_buf_);
+                compressed_size_ += produced;
+            }
+        } while (stream_.avail_out == 0 || (flush_mode == Z_FINISH && rv != Z_STREAM_END));
+    }
+
+    static constexpr size_t out_chunk_size = 16 * 1024;
+    file_helper file_helper_;
+    int compression_level_ = Z_DEFAULT_COMPRESSION;
+    z_stream stream_{};
+    bool member_open_ = false;
+    size_t compressed_size_ = 0;
+    size_t checked_size_ = 0;    // compressed size at the last would_exceed() check
+    size_t unchecked_size_ = 0;  // uncompressed bytes written since then
+    size_t check_after_ = 0;     // uncompressed bytes that can be written before the next check
+    double ratio_ = 1;           // compressed bytes per uncompressed byte at the last check
+    memory_buf_t out_buf_;
+};
+
+}  // namespace details
+}  // namespace spdlog
@@ -0,0 +1,216 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Packs a format string and its arguments into a compact byte string, to be formatted later.
+// Used by the backtracer, so that only the messages that are dumped get formatted.
+//
+// Only arithmetic and string arguments are supported (see lazy_format::is_supported): their
+// values are copied, so the result is the same as formatting them right away. Messages with
+// other arguments are formatted before they are stored.
+// Not available with SPDLOG_USE_STD_FORMAT, which has no dynamic argument list.
+
+#include <spdlog/common.h>
+
+#ifndef SPDLOG_USE_STD_FORMAT
+    #include <spdlog/fmt/args.h>
+
+    #include <cstdint>
+    #include <cstring>
+    #include <string>
+    #include <type_traits>
+
+namespace spdlog {
+namespace details {
+namespace lazy_format {
+
+enum class arg_type : char {
+    boolean,
+    character,
+    int64,
+    uint64,
+    float32,
+    float64,
+    long_double,
+    str
+};
+
+template <typename T, typename D = typename std::decay<T>::type>
+struct is_supported
+    : std::integral_constant<bool,
+                             (std::is_integral<D>::value && !std::is_same<D, wchar_t>::value &&
+                              !std::is_same<D, char16_t>::value &&
+                              !std::is_same<D, char32_t>::value) ||
+                                 std::is_floating_point<D>::value ||
+                                 std::is_same<D, const char *>::value ||
+                                 std::is_same<D, char *>::value ||
+                                 std::is_same<D, std::string>::value ||
+                                 std::is_same<D, string_view_t>::value> {};
+
+template <typename... Args>
+struct all_supported;
+
+template <>
+struct all_supported<> : std::true_type {};
+
+template <typename T, typename... Rest>
+struct all_supported<T, Rest...>
+    : std::integral_constant<bool, is_supported<T>::value && all_supported<Rest...>::value> {};
+
+inline void put_(memory_buf_t &dest, arg_type type, const void *data, size_t size) {
+    dest.push_back(static_cast<char>(type));
+    const auto *p = static_cast<const char *>(data);
+    dest.append(p, p + size);
+}
+
+inline bool write_arg_(memory_buf_t &dest, bool value) {
+    put_(dest, arg_type::boolean, &value, sizeof(value));
+    return true;
+}
+
+inline bool write_arg_(memory_buf_t &dest, char value) {
+    put_(dest, arg_type::character, &value, sizeof(value));
+    return true;
+}
+
+template <typename T,
+          typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value,
+                                  int>::type = 0>
+inline bool write_arg_(memory_buf_t &dest, T value) {
+    auto v = static_cast<int64_t>(value);
+    put_(dest, arg_type::int64, &v, sizeof(v));
+    return true;
+}
+
+template <typename T,
+          typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value,
+                                  int>::type = 0>
+inline bool write_arg_(memory_buf_t &dest, T value) {
+    auto v = static_cast<uint64_t>(value);
+    put_(dest, arg_type::uint64, &v, sizeof(v));
+    return true;
+}
+
+inline bool write_arg_(memory_buf_t &dest, float value) {
+    put_(dest, arg_type::float32, &value, sizeof(value));
+    return true;
+}
+
+inline bool write_arg_(memory_buf_t &dest, double value) {
+    put_(dest, arg_type::float64, &value, sizeof(value));
+    return true;
+}
+
+inline bool write_arg_(memory_buf_t &dest, long double value) {
+    put_(dest, arg_type::long_double, &value, sizeof(value));
+    return true;
+}
+
+inline bool write_arg_(memory_buf_t &dest, string_view_t value) {
+    auto size = static_cast<uint32_t>(value.size());
+    put_(dest, arg_type::str, &size, sizeof(size));
+    dest.append(value.data(), value.data() + value.size());
+    return true;
+}
+
+inline bool write_arg_(memory_buf_t &dest, const std::string &value) {
+    return write_arg_(dest, string_view_t(value));
+}
+
+inline bool write_arg_(memory_buf_t &dest, const char *value) {
+    // let the formatting report null strings
+    return value != nullptr && write_arg_(dest, string_view_t(value));
+}
+
+inline bool write_args_(memory_buf_t &) { return true; }
+
+template <typename T, typename... Rest>
+inline bool write_args_(memory_buf_t &dest, const T &arg, const Rest &...rest) {
+    return write_arg_(dest, arg) && write_args_(dest, rest...);
+}
+
+// pack fmt and args into dest. returns false if they cannot be packed (see is_supported),
+// in which case they must be formatted right away.
+template <typename... Args>
+inline bool pack(memory_buf_t &dest, string_view_t fmt, const Args &...args) {
+    auto fmt_size = static_cast<uint32_t>(fmt.size());
+    const auto *p = reinterpret_cast<const char *>(&fmt_size);
+    dest.append(p, p + sizeof(fmt_size));
+    dest.append(fmt.data(), fmt.data() + fmt.size());
+    return write_args_(dest, args...);
+}
+
+template <typename T>
+inline T read_(const char *&pos) {
+    T value;
+    std::memcpy(&value, pos, sizeof(value));
+    pos += sizeof(value);
+    return value;
+}
+
+// the format string of the packed message
+inline string_view_t format_string(string_view_t packed) {
+    uint32_t fmt_size = 0;
+    if (packed.size() < sizeof(fmt_size)) {
+        return string_view_t{};
+    }
+    std::memcpy(&fmt_size, packed.data(), sizeof(fmt_size));
+    if (fmt_size > packed.size() - sizeof(fmt_size)) {
+        return string_view_t{};
+    }
+    return string_view_t(packed.data() + sizeof(fmt_size), fmt_size);
+}
+
+// format the packed message into dest. throws spdlog_ex on invalid data, or format_error.
+inline void format(string_view_t packed, memory_buf_t &dest) {
+    const char *pos = packed.data();
+    const char *end = packed.data() + packed.size();
+    if (packed.size() < sizeof(uint32_t)) {
+        throw_spdlog_ex("lazy_format: invalid packed message");
+    }
+    string_view_t fmt = format_string(packed);
+    pos += sizeof(uint32_t) + fmt.size();
+
+    fmt::dynamic_format_arg_store<fmt::format_context> store;
+    while (pos < end) {
+        switch (static_cast<arg_type>(*pos++)) {
+            case arg_type::boolean:
+                store.push_back(read_<bool>(pos));
+                break;
+            case arg_type::character:
+                store.push_back(read_<char>(pos));
+                break;
+            case arg_type::int64:
+                store.push_back(read_<int64_t>(pos));
+                break;
+            case arg_type::uint64:
+                store.push_back(read_<uint64_t>(pos));
+                break;
+            case arg_type::float32:
+                store.push_back(read_<float>(pos));
+                break;
+            case arg_type::float64:
+                store.push_back(read_<double>(pos));
+                break;
+            case arg_type::long_double:
+                store.push_back(read_<long double>(pos));
+                break;
+            case arg_type::str: {
+                auto size = read_<uint32_t>(pos);
+                store.push_back(string_view_t(pos, size));
+                pos += size;
+                break;
+            }
+            default:
+                throw_spdlog_ex("lazy_format: invalid packed message");
+        }
+    }
+    fmt::vformat_to(fmt::appender(dest), fmt, store);
+}
+
+}  // namespace lazy_format
+}  // namespace details
+}  // namespace spdlog
+
+#endif  // SPDLOG_USE_STD_FORMAT
@@ -0,0 +1,90 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Levels of hierarchical logger names, stored in a trie of their dot separated parts.
+// The level set for "net.http" applies to "net.http" and to all the loggers below it
+// ("net.http.server", ...), unless a level is set for a longer prefix.
+// Not thread safe.
+
+#include <spdlog/common.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace spdlog {
+namespace details {
+
+class level_trie {
+public:
+    // set the level of name and of the names below it
+    void set(const std::string &name, level::level_enum lvl) {
+        auto *n = &root_;
+        for_each_part_(name, [&n](const std::string &part) {
+            auto &child = n->children[part];
+            if (!child) {
+                child = details::make_unique<node>();
+            }
+            n = child.get();
+            return true;
+        });
+        n->has_level = true;
+        n->lvl = lvl;
+    }
+
+    // find the level set for the longest prefix of name. returns false if there is none.
+    bool find(const std::string &name, level::level_enum &lvl) const {
+        const auto *n = &root_;
+        bool found = false;
+        for_each_part_(name, [&](const std::string &part) {
+            auto it = n->children.find(part);
+            if (it == n->children.end()) {
+                return false;
+            }
+            n = it->second.get();
+            if (n->has_level) {
+                found = true;
+                lvl = n->lvl;
+            }
+            return true;
+        });
+        return found;
+    }
+
+    // true if name is equal to prefix or below it
+    static bool is_below(const std::string &name, const std::string &prefix) {
+        return name.compare(0, prefix.size(), prefix) == 0 &&
+               (name.size() == prefix.size() || name[prefix.size()] == '.');
+    }
+
+    void clear() { root_.children.clear(); }
+
+private:
+    struct node {
+        bool has_level = false;
+        level::level_enum lvl = level::info;
+        std::unordered_map<std::string, std::unique_ptr<node>> children;
+    };
+
+    // call f(part) for each dot separated part of name, until it returns false
+    template <typename F>
+    static void for_each_part_(const std::string &name, F &&f) {
+        std::string part;
+        size_t start = 0;
+        for (;;) {
+            auto end = name.find('.', start);
+            part.assign(name, start, end == std::string::npos ? std::string::npos : end - start);
+            if (!f(static_cast<const std::string &>(part)) || end == std::string::npos) {
+                return;
+            }
+            start = end + 1;
+        }
+    }
+
+    node root_;
+};
+
+}  // namespace details
+}  // namespace spdlog
@@ -45,6 +45,14 @@ SPDLOG_INLINE log_msg_buffer &log_msg_buffer::operator=(log_msg_buffer &&other)
     return *this;
 }
 
+SPDLOG_INLINE void log_msg_buffer::assign(const log_msg &orig_msg) {
+    log_msg::operator=(orig_msg);
+    buffer.clear();
+    buffer.append(logger_name.begin(), logger_name.end());
+    buffer.append(payload.begin(), payload.end());
+    update_string_views();
+}
+
 SPDLOG_INLINE void log_msg_buffer::update_string_views() {
     logger_name = string_view_t{buffer.data(), logger_name.size()};
     payload = string_view_t{buffer.data() + logger_name.size(), payload.size()};
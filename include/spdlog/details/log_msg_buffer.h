@@ -22,6 +22,9 @@ public:
     log_msg_buffer(log_msg_buffer &&other) SPDLOG_NOEXCEPT;
     log_msg_buffer &operator=(const log_msg_buffer &other);
     log_msg_buffer &operator=(log_msg_buffer &&other) SPDLOG_NOEXCEPT;
+
+    // copy orig_msg, reusing the allocated buffer
+    void assign(const log_msg &orig_msg);
 };
 
 }  // namespace details
@@ -0,0 +1,116 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+//
+// Flat binary copy of the log_msg fields, used to pass messages through shared memory
+// (shm_ring_sink) or to park them on disk (spool_sink) and rebuild them later.
+// A record is a log_msg_record followed by the logger name, filename, funcname and payload
+// bytes. The layout is that of the host, so records are read only on the machine that wrote them.
+//
+
+#include <spdlog/common.h>
+#include <spdlog/details/log_msg.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace spdlog {
+namespace details {
+
+struct log_msg_record {
+    int64_t time_ns;
+    uint64_t thread_id;
+    int32_t line;
+    uint32_t level;
+    uint32_t logger_name_size;
+    uint32_t filename_size;
+    uint32_t funcname_size;
+    uint32_t payload_size;
+
+    // fill the record from msg. filename and funcname are set to the source location strings.
+    void assign(const log_msg &msg, string_view_t &filename, string_view_t &funcname) {
+        time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(msg.time.time_since_epoch())
+                      .count();
+        thread_id = msg.thread_id;
+        level = static_cast<uint32_t>(msg.level);
+        line = 0;
+        filename = string_view_t();
+        funcname = string_view_t();
+        if (!msg.source.empty()) {
+            line = msg.source.line;
+            filename = msg.source.filename ? msg.source.filename : "";
+            funcname = msg.source.funcname ? msg.source.funcname : "";
+        }
+        logger_name_size = static_cast<uint32_t>(msg.logger_name.size());
+        filename_size = static_cast<uint32_t>(filename.size());
+        funcname_size = static_cast<uint32_t>(funcname.size());
+        payload_size = static_cast<uint32_t>(msg.payload.size());
+    }
+
+    size_t strings_size() const {
+        return size_t{logger_name_size} + filename_size + funcname_size + payload_size;
+    }
+
+    // append the record of msg to dest
+    static void append(const log_msg &msg, memory_buf_t &dest) {
+        log_msg_record record;
+        string_view_t filename, funcname;
+        record.assign(msg, filename, funcname);
+        auto *p = reinterpret_cast<const char *>(&record);
+        dest.append(p, p + sizeof(record));
+        dest.append(msg.logger_name.data(), msg.logger_name.data() + msg.logger_name.size());
+        dest.append(filename.data(), filename.data() + filename.size());
+        dest.append(funcname.data(), funcname.data() + funcname.size());
+        dest.append(msg.payload.data(), msg.payload.data() + msg.payload.size());
+    }
+};
+
+// rebuilds log_msg objects from records.
+// keeps the source location strings, which log_msg needs null terminated.
+class log_msg_record_reader {
+public:
+    // call on_msg(const log_msg &) with the message of the record in [data, data + size).
+    // the log_msg and the strings it points to are valid only during the callback.
+    // returns false (without calling on_msg) if the data is not a valid record.
+    template <typename OnMsg>
+    bool read(const char *data, size_t size, OnMsg &&on_msg) {
+        log_msg_record record;
+        if (size < sizeof(record)) {
+            return false;
+        }
+        std::memcpy(&record, data, sizeof(record));
+        if (sizeof(record) + record.strings_size() != size || record.level > level::off) {
+            return false;
+        }
+        const char *pos = data + sizeof(record);
+        string_view_t logger_name(pos, record.logger_name_size);
+        pos += record.logger_name_size;
+        filename_.assign(pos, record.filename_size);
+        pos += record.filename_size;
+        funcname_.assign(pos, record.funcname_size);
+        pos += record.funcname_size;
+
+        source_loc loc;
+        if (record.line > 0) {
+            loc = source_loc{filename_.c_str(), record.line, funcname_.c_str()};
+        }
+        log_clock::time_point time(std::chrono::duration_cast<log_clock::duration>(
+            std::chrono::nanoseconds(record.time_ns)));
+        log_msg msg(time, loc, logger_name, static_cast<level::level_enum>(record.level),
+                    string_view_t(pos, record.payload_size));
+        msg.thread_id = static_cast<size_t>(record.thread_id);
+        on_msg(static_cast<const log_msg &>(msg));
+        return true;
+    }
+
+private:
+    std::string filename_;
+    std::string funcname_;
+};
+
+}  // namespace details
+}  // namespace spdlog
@@ -589,6 +589,38 @@ SPDLOG_INLINE bool fsync(FILE *fp) {
 #endif
 }
 
+// Do fdatasync by FILE handlerpointer
+// Return true on success
+SPDLOG_INLINE bool fdatasync(FILE *fp) {
+#if defined(__linux__)
+    return ::fdatasync(fileno(fp)) == 0;
+#else
+    return fsync(fp);
+#endif
+}
+
+// Reserve disk space for the file up to the given size without changing the file size.
+// Return true on success, false on failure or if not supported by the platform.
+SPDLOG_INLINE bool fallocate(FILE *fp, size_t size) {
+#if defined(__linux__) && defined(FALLOC_FL_KEEP_SIZE)
+    return ::fallocate(fileno(fp), FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(size)) == 0;
+#else
+    (void)fp;
+    (void)size;
+    return false;
+#endif
+}
+
+// Truncate (or extend) the file to the given size.
+// Return true on success.
+SPDLOG_INLINE bool truncate(FILE *fp, size_t size) {
+#ifdef _WIN32
+    return _chsize_s(_fileno(fp), static_cast<__int64>(size)) == 0;
+#else
+    return ::ftruncate(fileno(fp), static_cast<off_t>(size)) == 0;
+#endif
+}
+
 }  // namespace os
 }  // namespace details
 }  // namespace spdlog
@@ -114,6 +114,18 @@ SPDLOG_API std::string getenv(const char *field);
 // Return true on success.
 SPDLOG_API bool fsync(FILE *fp);
 
+// Do fdatasync by FILE objectpointer (fsync on platforms without fdatasync).
+// Return true on success.
+SPDLOG_API bool fdatasync(FILE *fp);
+
+// Reserve disk space for the file up to the given size without changing the file size.
+// Return true on success, false on failure or if not supported by the platform.
+SPDLOG_API bool fallocate(FILE *fp, size_t size);
+
+// Truncate (or extend) the file to the given size.
+// Return true on success.
+SPDLOG_API bool truncate(FILE *fp, size_t size);
+
 }  // namespace os
 }  // namespace details
 }  // namespace spdlog
@@ -0,0 +1,90 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <spdlog/details/thread_shard.h>
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+// Lets readers use an immutable object published through an atomic pointer without locking,
+// and lets the writer wait until no reader can still be using the object it replaced.
+//
+//     // reader
+//     read_epoch::reader_guard guard(epoch);
+//     const auto *obj = published.load();
+//     ... use *obj until guard goes out of scope ...
+//
+//     // writer (one at a time)
+//     published.store(new_obj);
+//     epoch.synchronize();
+//     delete old_obj;
+//
+// Readers register in one of two counters, chosen by the current epoch. synchronize() flips
+// the epoch twice and each time waits for the counter of the previous epoch to drain, so every
+// reader that may have loaded the old pointer has left when it returns.
+//
+// The counters are striped over n_slots cache lines, chosen by the hash of the thread id, so
+// readers on different threads don't write to the same cache line. The writer polls each counter
+// with an acq_rel read-modify-write rather than a load: a reader whose increment comes after the
+// poll in the counter's modification order synchronizes with it, and so sees the new pointer.
+// That keeps the readers at acquire/release, without a seq_cst fence on either side.
+
+namespace spdlog {
+namespace details {
+
+class read_epoch {
+public:
+    read_epoch() = default;
+    read_epoch(const read_epoch &) = delete;
+    read_epoch &operator=(const read_epoch &) = delete;
+
+    class reader_guard {
+    public:
+        explicit reader_guard(read_epoch &epoch)
+            : readers_(epoch.slots_[thread_shard(n_slots)]
+                           .readers[epoch.epoch_.load(std::memory_order_relaxed) & 1]) {
+            readers_.fetch_add(1, std::memory_order_acquire);
+        }
+
+        ~reader_guard() { readers_.fetch_sub(1, std::memory_order_release); }
+
+        reader_guard(const reader_guard &) = delete;
+        reader_guard &operator=(const reader_guard &) = delete;
+
+    private:
+        std::atomic<size_t> &readers_;
+    };
+
+    // wait until the readers that entered before this call have left.
+    // must not be called by a reader of this epoch.
+    void synchronize() {
+        for (int i = 0; i < 2; i++) {
+            auto epoch = epoch_.load(std::memory_order_relaxed) & 1;
+            epoch_.store(epoch ^ 1, std::memory_order_relaxed);
+            for (auto &slot : slots_) {
+                while (slot.readers[epoch].fetch_add(0, std::memory_order_acq_rel) != 0) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr size_t n_slots = 8;
+    static constexpr size_t cache_line_size = 64;
+
+    // padded, so that each slot has its own cache line (new doesn't honor alignas before C++17)
+    struct slot {
+        std::atomic<size_t> readers[2] = {{0}, {0}};
+        char padding[cache_line_size - 2 * sizeof(std::atomic<size_t>)];
+    };
+
+    std::atomic<unsigned> epoch_{0};
+    slot slots_[n_slots];
+};
+
+}  // namespace details
+}  // namespace spdlog
@@ -43,8 +43,10 @@ SPDLOG_INLINE registry::registry()
     const char *default_logger_name = "";
     default_logger_ = std::make_shared<spdlog::logger>(default_logger_name, std::move(color_sink));
     loggers_[default_logger_name] = default_logger_;
+    default_logger_raw_.store(default_logger_.get(), std::memory_order_release);
 
 #endif  // SPDLOG_DISABLE_DEFAULT_LOGGER
+    publish_loggers_();
 }
 
 SPDLOG_INLINE registry::~registry() = default;
@@ -63,9 +65,7 @@ SPDLOG_INLINE void registry::initialize_logger(std::shared_ptr<logger> new_logge
     }
 
     // set new level according to previously configured level or default level
-    auto it = log_levels_.find(new_logger->name());
-    auto new_level = it != log_levels_.end() ? it->second : global_log_level_;
-    new_logger->set_level(new_level);
+    new_logger->set_level(configured_level_(new_logger->name()));
 
     new_logger->flush_on(flush_level_);
 
@@ -79,9 +79,17 @@ SPDLOG_INLINE void registry::initialize_logger(std::shared_ptr<logger> new_logge
 }
 
 SPDLOG_INLINE std::shared_ptr<logger> registry::get(const std::string &logger_name) {
-    std::lock_guard<std::mutex> lock(logger_map_mutex_);
-    auto found = loggers_.find(logger_name);
-    return found == loggers_.end() ? nullptr : found->second;
+    read_epoch::reader_guard guard(loggers_epoch_);
+    const auto *loggers = loggers_snapshot_.load(std::memory_order_acquire);
+    auto found = loggers->find(logger_name);
+    return found == loggers->end() ? nullptr : found->second;
+}
+
+SPDLOG_INLINE logger *registry::get_raw(const std::string &logger_name) {
+    read_epoch::reader_guard guard(loggers_epoch_);
+    const auto *loggers = loggers_snapshot_.load(std::memory_order_acquire);
+    auto found = loggers->find(logger_name);
+    return found == loggers->end() ? nullptr : found->second.get();
 }
 
 SPDLOG_INLINE std::shared_ptr<logger> registry::default_logger() {
@@ -90,19 +98,24 @@ SPDLOG_INLINE std::shared_ptr<logger> registry::default_logger() {
 }
 
 // Return raw ptr to the default logger.
-// To be used directly by the spdlog default api (e.g. spdlog::info)
-// This make the default API faster, but cannot be used concurrently with set_default_logger().
-// e.g do not call set_default_logger() from one thread while calling spdlog::info() from another.
-SPDLOG_INLINE logger *registry::get_default_raw() { return default_logger_.get(); }
+// To be used directly by the spdlog default api (e.g. spdlog::info), under a default_logger_guard
+SPDLOG_INLINE logger *registry::get_default_raw() {
+    return default_logger_raw_.load(std::memory_order_acquire);
+}
 
 // set default logger.
 // default logger is stored in default_logger_ (for faster retrieval) and in the loggers_ map.
 SPDLOG_INLINE void registry::set_default_logger(std::shared_ptr<logger> new_default_logger) {
-    std::lock_guard<std::mutex> lock(logger_map_mutex_);
-    if (new_default_logger != nullptr) {
-        loggers_[new_default_logger->name()] = new_default_logger;
+    std::shared_ptr<logger> old_default_logger;
+    {
+        std::lock_guard<std::mutex> lock(logger_map_mutex_);
+        if (new_default_logger != nullptr) {
+            loggers_[new_default_logger->name()] = new_default_logger;
+        }
+        old_default_logger = replace_default_logger_(std::move(new_default_logger));
+        publish_loggers_();
     }
-    default_logger_ = std::move(new_default_logger);
+    release_default_logger_(std::move(old_default_logger));
 }
 
 SPDLOG_INLINE void registry::set_tp(std::shared_ptr<thread_pool> tp) {
@@ -181,18 +194,28 @@ SPDLOG_INLINE void registry::flush_all() {
 }
 
 SPDLOG_INLINE void registry::drop(const std::string &logger_name) {
-    std::lock_guard<std::mutex> lock(logger_map_mutex_);
-    auto is_default_logger = default_logger_ && default_logger_->name() == logger_name;
-    loggers_.erase(logger_name);
-    if (is_default_logger) {
-        default_logger_.reset();
+    std::shared_ptr<logger> old_default_logger;
+    {
+        std::lock_guard<std::mutex> lock(logger_map_mutex_);
+        auto is_default_logger = default_logger_ && default_logger_->name() == logger_name;
+        loggers_.erase(logger_name);
+        if (is_default_logger) {
+            old_default_logger = replace_default_logger_(nullptr);
+        }
+        publish_loggers_();
     }
+    release_default_logger_(std::move(old_default_logger));
 }
 
 SPDLOG_INLINE void registry::drop_all() {
-    std::lock_guard<std::mutex> lock(logger_map_mutex_);
-    loggers_.clear();
-    default_logger_.reset();
+    std::shared_ptr<logger> old_default_logger;
+    {
+        std::lock_guard<std::mutex> lock(logger_map_mutex_);
+        loggers_.clear();
+        old_default_logger = replace_default_logger_(nullptr);
+        publish_loggers_();
+    }
+    release_default_logger_(std::move(old_default_logger));
 }
 
 // clean all resources and threads started by the registry
@@ -219,20 +242,35 @@ SPDLOG_INLINE void registry::set_automatic_registration(bool automatic_registrat
 
 SPDLOG_INLINE void registry::set_levels(log_levels levels, level::level_enum *global_level) {
     std::lock_guard<std::mutex> lock(logger_map_mutex_);
-    log_levels_ = std::move(levels);
+    log_levels_.clear();
+    for (auto &name_level : levels) {
+        log_levels_.set(name_level.first, name_level.second);
+    }
     auto global_level_requested = global_level != nullptr;
     global_log_level_ = global_level_requested ? *global_level : global_log_level_;
 
     for (auto &logger : loggers_) {
-        auto logger_entry = log_levels_.find(logger.first);
-        if (logger_entry != log_levels_.end()) {
-            logger.second->set_level(logger_entry->second);
+        level::level_enum logger_level;
+        if (log_levels_.find(logger.first, logger_level)) {
+            logger.second->set_level(logger_level);
         } else if (global_level_requested) {
             logger.second->set_level(*global_level);
         }
     }
 }
 
+SPDLOG_INLINE void registry::set_level(const std::string &logger_name,
+                                       level::level_enum log_level) {
+    std::lock_guard<std::mutex> lock(logger_map_mutex_);
+    log_levels_.set(logger_name, log_level);
+    for (auto &logger : loggers_) {
+        if (level_trie::is_below(logger.first, logger_name)) {
+            // a longer prefix may have its own level
+            logger.second->set_level(configured_level_(logger.first));
+        }
+    }
+}
+
 SPDLOG_INLINE registry &registry::instance() {
     static registry s_instance;
     return s_instance;
@@ -240,9 +278,13 @@ SPDLOG_INLINE registry &registry::instance() {
 
 SPDLOG_INLINE void registry::apply_logger_env_levels(std::shared_ptr<logger> new_logger) {
     std::lock_guard<std::mutex> lock(logger_map_mutex_);
-    auto it = log_levels_.find(new_logger->name());
-    auto new_level = it != log_levels_.end() ? it->second : global_log_level_;
-    new_logger->set_level(new_level);
+    new_logger->set_level(configured_level_(new_logger->name()));
+}
+
+// the level configured for the logger name or its closest parent, or the global level
+SPDLOG_INLINE level::level_enum registry::configured_level_(const std::string &logger_name) const {
+    level::level_enum configured_level;
+    return log_levels_.find(logger_name, configured_level) ? configured_level : global_log_level_;
 }
 
 SPDLOG_INLINE void registry::throw_if_exists_(const std::string &logger_name) {
@@ -255,7 +297,79 @@ SPDLOG_INLINE void registry::register_logger_(std::shared_ptr<logger> new_logger
     auto logger_name = new_logger->name();
     throw_if_exists_(logger_name);
     loggers_[logger_name] = std::move(new_logger);
+    publish_loggers_();
+}
+
+// returns the previous default logger. called with logger_map_mutex_ locked.
+SPDLOG_INLINE std::shared_ptr<logger> registry::replace_default_logger_(
+    std::shared_ptr<logger> new_default_logger) {
+    default_logger_raw_.store(new_default_logger.get(), std::memory_order_release);
+    default_logger_.swap(new_default_logger);
+    bump_level_epoch();
+    return new_default_logger;
+}
+
+// release the replaced default logger once the default API calls that may still use it have
+// returned. a call from the default API can't wait for itself, so the logger is kept until the
+// next release instead.
+SPDLOG_INLINE void registry::release_default_logger_(std::shared_ptr<logger> old_default_logger) {
+    std::vector<std::shared_ptr<logger>> retired;
+    {
+        std::lock_guard<std::mutex> lock(retired_default_loggers_mutex_);
+        if (old_default_logger != nullptr) {
+            retired_default_loggers_.push_back(std::move(old_default_logger));
+        }
+        if (retired_default_loggers_.empty() || default_logger_guard::depth() > 0) {
+            return;
+        }
+        retired.swap(retired_default_loggers_);
+    }
+    std::lock_guard<std::mutex> lock(default_logger_epoch_mutex_);
+    default_logger_epoch_.synchronize();
+}
+
+// replace the snapshot used by get(). called with logger_map_mutex_ locked.
+SPDLOG_INLINE void registry::publish_loggers_() {
+    std::unique_ptr<const logger_map> snapshot(new logger_map(loggers_));
+    loggers_snapshot_.store(snapshot.get(), std::memory_order_release);
+    loggers_epoch_.synchronize();
+    loggers_snapshot_owner_ = std::move(snapshot);
+}
+
+SPDLOG_INLINE default_logger_guard::default_logger_guard()
+    : guard_(registry::instance().default_logger_epoch_),
+      logger_(registry::instance().get_default_raw()) {
+#ifndef SPDLOG_NO_TLS
+    thread_depth_()++;
+#endif
 }
 
+SPDLOG_INLINE default_logger_guard::~default_logger_guard() {
+#ifndef SPDLOG_NO_TLS
+    thread_depth_()--;
+#endif
+}
+
+SPDLOG_INLINE bool default_logger_guard::levels::should_log(level::level_enum lvl) const {
+    default_logger_guard guard;
+    return guard.get() != nullptr && guard->should_log(lvl);
+}
+
+SPDLOG_INLINE bool default_logger_guard::levels::should_backtrace() const {
+    default_logger_guard guard;
+    return guard.get() != nullptr && guard->should_backtrace();
+}
+
+#ifdef SPDLOG_NO_TLS
+SPDLOG_INLINE int default_logger_guard::depth() { return 0; }
+#else
+SPDLOG_INLINE int default_logger_guard::depth() { return thread_depth_(); }
+
+SPDLOG_INLINE int &default_logger_guard::thread_depth_() {
+    static thread_local int depth = 0;
+    return depth;
+}
+#endif
+
 }  // namespace details
 }  // namespace spdlog
@@ -9,14 +9,18 @@
 // This class is thread safe
 
 #include <spdlog/common.h>
+#include <spdlog/details/level_trie.h>
 #include <spdlog/details/periodic_worker.h>
+#include <spdlog/details/read_epoch.h>
 
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace spdlog {
 class logger;
@@ -27,23 +31,33 @@ class thread_pool;
 class SPDLOG_API registry {
 public:
     using log_levels = std::unordered_map<std::string, level::level_enum>;
+    using logger_map = std::unordered_map<std::string, std::shared_ptr<logger>>;
     registry(const registry &) = delete;
     registry &operator=(const registry &) = delete;
 
     void register_logger(std::shared_ptr<logger> new_logger);
     void initialize_logger(std::shared_ptr<logger> new_logger);
+    // lock free lookup in an immutable snapshot of the loggers map
     std::shared_ptr<logger> get(const std::string &logger_name);
+
+    // same without the reference count update. the pointer is valid as long as the logger is
+    // not dropped (or kept alive by another shared_ptr).
+    logger *get_raw(const std::string &logger_name);
     std::shared_ptr<logger> default_logger();
 
-    // Return raw ptr to the default logger.
-    // To be used directly by the spdlog default api (e.g. spdlog::info)
-    // This make the default API faster, but cannot be used concurrently with set_default_logger().
-    // e.g do not call set_default_logger() from one thread while calling spdlog::info() from
-    // another.
+    // Return raw ptr to the default logger (a single load).
+    // To be used directly by the spdlog default api (e.g. spdlog::info), under a
+    // default_logger_guard. Without a guard, the pointer is valid until the default logger is
+    // replaced or dropped.
     logger *get_default_raw();
 
     // set default logger and add it to the registry if not registered already.
     // default logger is stored in default_logger_ (for faster retrieval) and in the loggers_ map.
+    // Can be called while other threads use the default API: it waits for the calls that may
+    // still use the previous default logger to return, and then releases it. When called from
+    // the default API itself (e.g. by a sink of the default logger), the previous logger is
+    // released by the next set_default_logger(), drop() or drop_all() instead. Without thread
+    // local storage (SPDLOG_NO_TLS), it must not be called from the default API.
     // Note: Make sure to unregister it when no longer needed or before calling again with a new
     // logger.
     void set_default_logger(std::shared_ptr<logger> new_default_logger);
@@ -61,6 +75,11 @@ public:
 
     void set_level(level::level_enum log_level);
 
+    // set the level of the logger with the given name and of all the loggers below it
+    // (e.g. "net.http" sets "net.http" and "net.http.server"), now and when they are created.
+    // a level set for a longer prefix takes precedence.
+    void set_level(const std::string &logger_name, level::level_enum log_level);
+
     void flush_on(level::level_enum log_level);
 
     template <typename Rep, typename Period>
@@ -93,6 +112,8 @@ public:
     void set_automatic_registration(bool automatic_registration);
 
     // set levels for all existing/future loggers. global_level can be null if should not set.
+    // the names are hierarchical: the level of "net" applies to "net.http" too, unless "net.http"
+    // has its own.
     void set_levels(log_levels levels, level::level_enum *global_level);
 
     static registry &instance();
@@ -106,10 +127,18 @@ private:
     void throw_if_exists_(const std::string &logger_name);
     void register_logger_(std::shared_ptr<logger> new_logger);
     bool set_level_from_cfg_(logger *logger);
+    void publish_loggers_();
+    std::shared_ptr<logger> replace_default_logger_(std::shared_ptr<logger> new_default_logger);
+    void release_default_logger_(std::shared_ptr<logger> old_default_logger);
+    level::level_enum configured_level_(const std::string &logger_name) const;
     std::mutex logger_map_mutex_, flusher_mutex_;
     std::recursive_mutex tp_mutex_;
-    std::unordered_map<std::string, std::shared_ptr<logger>> loggers_;
-    log_levels log_levels_;
+    logger_map loggers_;
+    // copy of loggers_ used by get(), replaced by publish_loggers_() after each change
+    std::atomic<const logger_map *> loggers_snapshot_{nullptr};
+    std::unique_ptr<const logger_map> loggers_snapshot_owner_;
+    read_epoch loggers_epoch_;
+    level_trie log_levels_;
     std::unique_ptr<formatter> formatter_;
     spdlog::level::level_enum global_log_level_ = level::info;
     level::level_enum flush_level_ = level::off;
@@ -117,8 +146,52 @@ private:
     std::shared_ptr<thread_pool> tp_;
     std::unique_ptr<periodic_worker> periodic_flusher_;
     std::shared_ptr<logger> default_logger_;
+    // default_logger_.get(), read by the default API under a default_logger_guard
+    std::atomic<logger *> default_logger_raw_{nullptr};
+    read_epoch default_logger_epoch_;
+    std::mutex default_logger_epoch_mutex_;  // one synchronize() at a time
+    // replaced default loggers that may still be in use, released after the next synchronize()
+    std::vector<std::shared_ptr<logger>> retired_default_loggers_;
+    std::mutex retired_default_loggers_mutex_;
     bool automatic_registration_ = true;
     size_t backtrace_n_messages_ = 0;
+
+    friend class default_logger_guard;
+};
+
+// Keeps the default logger alive while the default API uses it: set_default_logger(), drop()
+// and drop_all() wait for the guards taken before they replaced it.
+//
+//     default_logger_guard guard;
+//     guard->info("...");
+class SPDLOG_API default_logger_guard {
+public:
+    default_logger_guard();
+    ~default_logger_guard();
+    default_logger_guard(const default_logger_guard &) = delete;
+    default_logger_guard &operator=(const default_logger_guard &) = delete;
+
+    logger *get() const { return logger_; }
+    logger *operator->() const { return logger_; }
+    logger &operator*() const { return *logger_; }
+
+    // the level checks of the default logger, each under its own guard. used by the callsite
+    // cache, which checks the levels of the default logger only when its cached result is stale.
+    struct levels {
+        bool should_log(level::level_enum lvl) const;
+        bool should_backtrace() const;
+    };
+
+    // number of guards held by the current thread (always 0 with SPDLOG_NO_TLS)
+    static int depth();
+
+private:
+#ifndef SPDLOG_NO_TLS
+    static int &thread_depth_();
+#endif
+
+    read_epoch::reader_guard guard_;
+    logger *logger_;
 };
 
 }  // namespace details
@@ -0,0 +1,175 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Sampling decisions of the SPDLOG_*_SAMPLED macros (spdlog.h) and of sampling_sink.
+//
+// A message is kept with a probability of 1/n. If the MDC of the thread has a trace id (under
+// the key SPDLOG_SAMPLING_TRACE_KEY, "trace_id" by default), the decision is made by the hash
+// of the trace id, so the messages of a trace are either all kept or all dropped, in every
+// process that uses the same n. Otherwise a per thread xorshift generator is used.
+
+#include <spdlog/common.h>
+
+#ifndef SPDLOG_NO_TLS
+    #include <spdlog/mdc.h>
+#endif
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifndef SPDLOG_SAMPLING_TRACE_KEY
+    #define SPDLOG_SAMPLING_TRACE_KEY "trace_id"
+#endif
+
+namespace spdlog {
+namespace details {
+
+// splitmix64 finalizer
+inline uint64_t sampling_mix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+inline uint64_t sampling_random() {
+#ifndef SPDLOG_NO_TLS
+    // xorshift64*, seeded by the address of the state, which differs between threads
+    static thread_local uint64_t state = 0;
+    if (state == 0) {
+        state = sampling_mix(reinterpret_cast<uintptr_t>(&state)) | 1;
+    }
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545f4914f6cdd1dull;
+#else
+    static std::atomic<uint64_t> counter{0};
+    return sampling_mix(counter.fetch_add(1, std::memory_order_relaxed));
+#endif
+}
+
+// hash of the trace id in the MDC. returns false if there is none.
+inline bool sampling_trace_hash(uint64_t &hash) {
+#ifndef SPDLOG_NO_TLS
+    static const std::string key(SPDLOG_SAMPLING_TRACE_KEY);
+    const auto &context = mdc::get_context();
+    if (context.empty()) {
+        return false;
+    }
+    auto it = context.find(key);
+    if (it == context.end() || it->second.empty()) {
+        return false;
+    }
+    // FNV-1a
+    uint64_t h = 14695981039346656037ull;
+    for (auto c : it->second) {
+        h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    hash = sampling_mix(h);
+    return true;
+#else
+    (void)hash;
+    return false;
+#endif
+}
+
+// true with a probability of 1/one_in (always if one_in <= 1)
+inline bool sample_one_in(uint64_t one_in) {
+    if (one_in <= 1) {
+        return true;
+    }
+    uint64_t hash;
+    if (!sampling_trace_hash(hash)) {
+        hash = sampling_random();
+    }
+    return hash % one_in == 0;
+}
+
+struct sampling_counters {
+    std::atomic<uint64_t> emitted{0};
+    std::atomic<uint64_t> dropped{0};
+};
+
+class sampled_callsite;
+
+// the callsites of the SPDLOG_*_SAMPLED macros reached so far, most recent first
+inline std::atomic<sampled_callsite *> &sampled_callsites_head() {
+    static std::atomic<sampled_callsite *> head{nullptr};
+    return head;
+}
+
+// per callsite state of the SPDLOG_*_SAMPLED macros: the decisions made at one statement.
+// the first time it's reached it adds itself to the sampled_callsites() list (lock free, and
+// never removed, so a shared library using the macros must not be unloaded).
+class sampled_callsite {
+public:
+    constexpr sampled_callsite(const char *filename, int line, const char *funcname)
+        : filename_{filename},
+          line_{line},
+          funcname_{funcname} {}
+
+    sampled_callsite(const sampled_callsite &) = delete;
+    sampled_callsite &operator=(const sampled_callsite &) = delete;
+
+    // the sampling decision for one call
+    bool sample(uint64_t one_in) {
+        if (!registered_.load(std::memory_order_relaxed) &&
+            !registered_.exchange(true, std::memory_order_relaxed)) {
+            auto &head = sampled_callsites_head();
+            next_ = head.load(std::memory_order_relaxed);
+            while (!head.compare_exchange_weak(next_, this, std::memory_order_release,
+                                               std::memory_order_relaxed)) {
+            }
+        }
+        auto keep = sample_one_in(one_in);
+        (keep ? counters_.emitted : counters_.dropped).fetch_add(1, std::memory_order_relaxed);
+        return keep;
+    }
+
+    const char *filename() const { return filename_; }
+
+    int line() const { return line_; }
+
+    const char *funcname() const { return funcname_; }
+
+    const sampling_counters &counters() const { return counters_; }
+
+    const sampled_callsite *next() const { return next_; }
+
+private:
+    const char *filename_;
+    int line_;
+    const char *funcname_;
+    sampling_counters counters_;
+    std::atomic<bool> registered_{false};
+    sampled_callsite *next_ = nullptr;
+};
+
+struct sampled_callsite_info {
+    std::string filename;
+    int line;
+    std::string funcname;
+    uint64_t emitted;
+    uint64_t dropped;
+};
+
+// the counters of the SPDLOG_*_SAMPLED callsites reached so far
+inline std::vector<sampled_callsite_info> sampled_callsites() {
+    std::vector<sampled_callsite_info> result;
+    const auto *site = sampled_callsites_head().load(std::memory_order_acquire);
+    for (; site != nullptr; site = site->next()) {
+        result.push_back(sampled_callsite_info{
+            site->filename() ? site->filename() : "", site->line(),
+            site->funcname() ? site->funcname() : "",
+            site->counters().emitted.load(std::memory_order_relaxed),
+            site->counters().dropped.load(std::memory_order_relaxed)});
+    }
+    return result;
+}
+
+}  // namespace details
+}  // namespace spdlog
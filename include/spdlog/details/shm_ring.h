@@ -0,0 +1,335 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifdef _WIN32
+    #error "shm_ring is not supported on windows"
+#endif
+
+//
+// Multi producer / single consumer ring of variable size records in POSIX shared memory
+// (shm_open), used by shm_ring_sink and shm_ring_reader.
+//
+// Each record starts with an 8 byte atomic commit word: the record size, a tag of its position
+// and state bits. Writers (threads of any process that maps the ring) claim the record at
+// write_pos with a CAS of its commit word from the "free" word of that position to the size with
+// the "reserved" bit, then move write_pos past it, copy the record and publish it by setting the
+// "committed" bit (release). Since the size is stored by the claim itself, a reserved record
+// always has a known size, and a writer that finds the record at write_pos claimed moves
+// write_pos past it itself instead of waiting for its owner. Records that don't fit before the
+// end of the buffer are preceded by a padding record. If the ring is full the record is dropped
+// and the dropped counter in the shared header is incremented.
+//
+// Every word of free space holds the free word of its position, which includes the tag, so it
+// differs from lap to lap. A writer that read a stale write_pos expects the free word of a lap
+// that is over, and its claim fails: writers never change a word they didn't claim. (The tag
+// repeats every 4 GiB of records, so a writer would have to sleep that long between reading
+// write_pos and its claim.)
+//
+// The reader consumes committed records in order, fills their space with the free words of the
+// next lap, and advances read_pos.
+// Everything lives in the shared memory object, so committed records survive a crash of the
+// writer (or of the reader) and are read when the reader (re)attaches. A record whose writer
+// died before committing it blocks the reader until skip_stalled() is called.
+//
+
+#include <spdlog/common.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace spdlog {
+namespace details {
+
+class shm_ring {
+public:
+    static constexpr uint32_t magic = 0x53504c52;  // "SPLR"
+    static constexpr uint32_t version = 3;
+
+    struct header {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t capacity;
+        alignas(64) std::atomic<uint64_t> write_pos;  // end of the reserved space
+        alignas(64) std::atomic<uint64_t> read_pos;   // end of the consumed space
+        alignas(64) std::atomic<uint64_t> committed;  // records written so far
+        std::atomic<uint64_t> dropped;                // records dropped because the ring was full
+        std::atomic<uint32_t> ready;                  // set once the creator initialized it
+    };
+
+    // commit word bits. the low 32 bits hold the record size (without the commit word), the
+    // next 29 bits a tag of the record position. a free word has no state bits and free_size.
+    static constexpr uint64_t committed_bit = uint64_t(1) << 63;
+    static constexpr uint64_t reserved_bit = uint64_t(1) << 62;
+    static constexpr uint64_t padding_bit = uint64_t(1) << 61;
+    static constexpr uint64_t tag_mask = uint64_t(0x1fffffff) << 32;
+    static constexpr uint64_t size_mask = 0xffffffff;
+    static constexpr uint64_t free_size = 0xfffffffe;
+    static constexpr size_t max_capacity = size_t(1) << 31;  // the tag must differ between laps
+
+    // commit word of a record of the given size at pos
+    static uint64_t make_word(uint64_t pos, size_t size, uint64_t bits) {
+        return bits | (((pos >> 3) << 32) & tag_mask) | size;
+    }
+
+    // content of the free space at pos
+    static uint64_t free_word(uint64_t pos) { return make_word(pos, free_size, 0); }
+
+    shm_ring() = default;
+    shm_ring(const shm_ring &) = delete;
+    shm_ring &operator=(const shm_ring &) = delete;
+    ~shm_ring() { close(); }
+
+    // open the shared memory object with the given name (e.g. "/myapp-log"), creating it
+    // if it doesn't exist. capacity (bytes, rounded up to a power of 2) is used only when
+    // creating it - 0 means open an existing ring only.
+    void open(const std::string &name, size_t capacity) {
+        close();
+        name_ = name;
+        bool created = false;
+        if (capacity > 0) {
+            fd_ = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+            created = fd_ != -1;
+        }
+        if (fd_ == -1) {
+            fd_ = ::shm_open(name.c_str(), O_RDWR, 0600);
+        }
+        if (fd_ == -1) {
+            throw_spdlog_ex("shm_ring: failed opening " + name, errno);
+        }
+
+        if (created) {
+            size_t cap = 4096;
+            while (cap < capacity && cap < max_capacity) {
+                cap <<= 1;
+            }
+            map_size_ = sizeof(header) + cap;
+            if (::ftruncate(fd_, static_cast<off_t>(map_size_)) != 0) {
+                throw_spdlog_ex("shm_ring: failed sizing " + name, errno);
+            }
+            map_();
+            hdr_->magic = magic;
+            hdr_->version = version;
+            hdr_->capacity = cap;
+            data_ = reinterpret_cast<char *>(hdr_) + sizeof(header);
+            mask_ = cap - 1;
+            fill_free_(0, cap);
+            hdr_->ready.store(1, std::memory_order_release);
+        } else {
+            // the creator might still be initializing it
+            struct stat st;
+            for (int i = 0; i < 1000; i++) {
+                if (::fstat(fd_, &st) != 0) {
+                    throw_spdlog_ex("shm_ring: fstat failed for " + name, errno);
+                }
+                if (static_cast<size_t>(st.st_size) > sizeof(header)) {
+                    map_size_ = static_cast<size_t>(st.st_size);
+                    map_();
+                    if (hdr_->ready.load(std::memory_order_acquire) == 1) {
+                        break;
+                    }
+                    ::munmap(hdr_, map_size_);
+                    hdr_ = nullptr;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            if (hdr_ == nullptr || hdr_->magic != magic || hdr_->version != version ||
+                sizeof(header) + hdr_->capacity != map_size_) {
+                close();
+                throw_spdlog_ex("shm_ring: " + name + " is not a valid ring");
+            }
+        }
+        data_ = reinterpret_cast<char *>(hdr_) + sizeof(header);
+        mask_ = hdr_->capacity - 1;
+    }
+
+    void close() {
+        if (hdr_ != nullptr) {
+            ::munmap(hdr_, map_size_);
+            hdr_ = nullptr;
+            data_ = nullptr;
+        }
+        if (fd_ != -1) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    // remove the shared memory object. mappings that are still open stay valid.
+    static void unlink(const std::string &name) { ::shm_unlink(name.c_str()); }
+
+    bool is_open() const { return hdr_ != nullptr; }
+
+    const std::string &name() const { return name_; }
+
+    header &hdr() { return *hdr_; }
+
+    // copy the given parts into a new record. returns false (and counts the record as dropped)
+    // if there is not enough free space.
+    template <size_t N>
+    bool write(const string_view_t (&parts)[N]) {
+        size_t size = 0;
+        for (const auto &part : parts) {
+            size += part.size();
+        }
+        const uint64_t need = record_space_(size);
+        const uint64_t capacity = hdr_->capacity;
+        if (size > size_mask || need > capacity) {
+            hdr_->dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        for (;;) {
+            // read_pos first: write_pos, loaded after it, is not behind it
+            const uint64_t read_pos = hdr_->read_pos.load(std::memory_order_acquire);
+            uint64_t pos = hdr_->write_pos.load(std::memory_order_acquire);
+            const uint64_t to_end = capacity - (pos & mask_);
+            const bool padding = need > to_end;
+            if (pos + (padding ? to_end + need : need) - read_pos > capacity) {
+                hdr_->dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            // claim the record (or the padding up to the end of the buffer)
+            const uint64_t space = padding ? to_end : need;
+            uint64_t word = make_word(pos, size, reserved_bit);
+            if (padding) {
+                word = make_word(pos, static_cast<size_t>(to_end - 8), padding_bit | committed_bit);
+            }
+            uint64_t found = free_word(pos);
+            if (!word_(pos).compare_exchange_strong(found, word, std::memory_order_acq_rel)) {
+                if ((found & (reserved_bit | committed_bit)) != 0 &&
+                    (found & tag_mask) == (word & tag_mask)) {
+                    // claimed by another writer that didn't move write_pos yet (or died before
+                    // doing so): move it past that record. fails if pos is stale.
+                    uint64_t expected = pos;
+                    hdr_->write_pos.compare_exchange_strong(
+                        expected, pos + record_space_(static_cast<size_t>(found & size_mask)),
+                        std::memory_order_acq_rel);
+                }
+                // otherwise pos was stale: the space is part of a newer record, or consumed
+                continue;
+            }
+            // fails if another writer (or skip_stalled) already moved write_pos past the claim
+            uint64_t expected = pos;
+            hdr_->write_pos.compare_exchange_strong(expected, pos + space,
+                                                    std::memory_order_release);
+            if (padding) {
+                continue;
+            }
+
+            char *dest = data_ + (pos & mask_) + 8;
+            for (const auto &part : parts) {
+                std::memcpy(dest, part.data(), part.size());
+                dest += part.size();
+            }
+            word_(pos).store(make_word(pos, size, committed_bit), std::memory_order_release);
+            hdr_->committed.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // call on_record(const char *data, size_t size) for up to max_records committed records.
+    // returns the number of records read. single consumer only.
+    template <typename OnRecord>
+    size_t read(OnRecord &&on_record, size_t max_records = static_cast<size_t>(-1)) {
+        size_t n = 0;
+        uint64_t pos = hdr_->read_pos.load(std::memory_order_relaxed);
+        const uint64_t write_pos = hdr_->write_pos.load(std::memory_order_acquire);
+        while (n < max_records && pos != write_pos) {
+            auto word = word_(pos).load(std::memory_order_acquire);
+            if ((word & committed_bit) == 0) {
+                break;
+            }
+            const size_t size = static_cast<size_t>(word & size_mask);
+            const char *record = data_ + (pos & mask_) + 8;
+            if ((word & padding_bit) == 0) {
+                on_record(record, size);
+                n++;
+            }
+            pos = consume_(pos, record_space_(size));
+        }
+        return n;
+    }
+
+    // skip the record at the read position if it was reserved but not committed. only that
+    // record is skipped: its size is part of the claim.
+    // call only when its writer is known to be dead (e.g. it was not committed for a long
+    // time), otherwise the writer would write into space that was already released.
+    // returns true if a record was skipped.
+    bool skip_stalled() {
+        uint64_t pos = hdr_->read_pos.load(std::memory_order_relaxed);
+        if (!stalled_at_(pos)) {
+            return false;
+        }
+        auto space = record_space_(static_cast<size_t>(word_(pos).load() & size_mask));
+        // no writer moved write_pos past the record yet
+        uint64_t expected = pos;
+        hdr_->write_pos.compare_exchange_strong(expected, pos + space, std::memory_order_acq_rel);
+        consume_(pos, space);
+        return true;
+    }
+
+    // position of the next record to read. used to detect stalls.
+    uint64_t read_pos() const { return hdr_->read_pos.load(std::memory_order_relaxed); }
+
+    bool has_pending() {
+        uint64_t pos = hdr_->read_pos.load(std::memory_order_relaxed);
+        return pos != hdr_->write_pos.load(std::memory_order_acquire) || stalled_at_(pos);
+    }
+
+private:
+    static uint64_t record_space_(size_t size) { return (8 + size + 7) & ~uint64_t(7); }
+
+    // true if the record at pos is claimed in this lap but not committed
+    bool stalled_at_(uint64_t pos) {
+        auto word = word_(pos).load(std::memory_order_acquire);
+        return (word & (reserved_bit | committed_bit)) == reserved_bit &&
+               (word & tag_mask) == (make_word(pos, 0, 0) & tag_mask);
+    }
+
+    std::atomic<uint64_t> &word_(uint64_t pos) {
+        return *reinterpret_cast<std::atomic<uint64_t> *>(data_ + (pos & mask_));
+    }
+
+    // fill the consumed space with the free words of the next lap, and release it
+    uint64_t consume_(uint64_t pos, uint64_t space) {
+        fill_free_(pos + hdr_->capacity, space);
+        hdr_->read_pos.store(pos + space, std::memory_order_release);
+        return pos + space;
+    }
+
+    void fill_free_(uint64_t pos, uint64_t space) {
+        for (uint64_t word_pos = pos; word_pos < pos + space; word_pos += 8) {
+            word_(word_pos).store(free_word(word_pos), std::memory_order_relaxed);
+        }
+    }
+
+    void map_() {
+        auto *p = ::mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) {
+            throw_spdlog_ex("shm_ring: mmap failed for " + name_, errno);
+        }
+        hdr_ = static_cast<header *>(p);
+    }
+
+    std::string name_;
+    int fd_ = -1;
+    size_t map_size_ = 0;
+    header *hdr_ = nullptr;
+    char *data_ = nullptr;
+    uint64_t mask_ = 0;
+};
+
+}  // namespace details
+}  // namespace spdlog
@@ -0,0 +1,100 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Spreading threads over the shards (per shard mutexes, formatters, counters..) of an object.
+//
+// thread_shard(n) hashes the thread id: cheap and stateless, good enough for striping
+// counters. thread_shard_map assigns the shards of one object round robin, in the order the
+// threads first use it, so N threads using an object with N shards get one shard each, whatever
+// the other threads of the process do.
+
+#include <spdlog/details/os.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace spdlog {
+namespace details {
+
+// hash of the current thread id. the splitmix64 finalizer is a bijection, so threads alive at
+// the same time have distinct hashes.
+inline uint64_t thread_hash() SPDLOG_NOEXCEPT {
+    auto mix = [](uint64_t x) {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    };
+#if defined(SPDLOG_NO_TLS)
+    return mix(static_cast<uint64_t>(os::thread_id()));
+#else
+    static thread_local const uint64_t hash = mix(static_cast<uint64_t>(os::thread_id()));
+    return hash;
+#endif
+}
+
+// shard of the current thread by the hash of its id, in [0, n_shards)
+inline size_t thread_shard(size_t n_shards) SPDLOG_NOEXCEPT {
+    return static_cast<size_t>(thread_hash() % n_shards);
+}
+
+// per object round robin assignment of the threads to n_shards shards.
+// lock free open addressing table of thread hash -> shard. when it is full (threads come and
+// go, and their entries are never removed), the remaining threads fall back to thread_shard().
+class thread_shard_map {
+public:
+    explicit thread_shard_map(size_t n_shards)
+        : n_shards_{n_shards == 0 ? 1 : n_shards} {
+        capacity_ = 64;
+        while (capacity_ < n_shards_ * 4) {
+            capacity_ *= 2;
+        }
+        entries_.reset(new entry[capacity_]);
+    }
+
+    thread_shard_map(const thread_shard_map &) = delete;
+    thread_shard_map &operator=(const thread_shard_map &) = delete;
+
+    size_t n_shards() const { return n_shards_; }
+
+    // shard of the current thread, in [0, n_shards)
+    size_t shard() SPDLOG_NOEXCEPT {
+        auto key = thread_hash();
+        key += key == 0;  // 0 marks the free entries
+        for (size_t i = 0; i < max_probes; i++) {
+            auto &e = entries_[(key + i) & (capacity_ - 1)];
+            auto k = e.key.load(std::memory_order_acquire);
+            if (k == 0) {
+                // only this thread inserts this key, so the shard is set before it is read
+                if (e.key.compare_exchange_strong(k, key, std::memory_order_acq_rel)) {
+                    auto shard = next_.fetch_add(1, std::memory_order_relaxed) % n_shards_;
+                    e.shard.store(shard, std::memory_order_relaxed);
+                    return shard;
+                }
+            }
+            if (k == key) {
+                return e.shard.load(std::memory_order_relaxed);
+            }
+        }
+        return thread_shard(n_shards_);
+    }
+
+private:
+    static constexpr size_t max_probes = 16;
+
+    struct entry {
+        std::atomic<uint64_t> key{0};
+        std::atomic<size_t> shard{0};
+    };
+
+    size_t n_shards_;
+    size_t capacity_;
+    std::unique_ptr<entry[]> entries_;
+    std::atomic<size_t> next_{0};
+};
+
+}  // namespace details
+}  // namespace spdlog
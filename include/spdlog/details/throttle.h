@@ -0,0 +1,63 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Per callsite state of the throttled macros (SPDLOG_*_EVERY_N, SPDLOG_*_EVERY_MS and
+// SPDLOG_*_FIRST_N in spdlog.h). Each macro callsite keeps a static throttle object, checked
+// after the level and before the arguments are formatted, so throttled statements cost an
+// atomic operation.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace spdlog {
+namespace details {
+
+// allow the 1st, n+1th, 2n+1th.. calls
+class throttle_every_n {
+public:
+    bool allow(uint64_t n) { return count_.fetch_add(1, std::memory_order_relaxed) % n == 0; }
+
+private:
+    std::atomic<uint64_t> count_{0};
+};
+
+// allow the first n calls
+class throttle_first_n {
+public:
+    bool allow(uint64_t n) {
+        return count_.load(std::memory_order_relaxed) < n &&
+               count_.fetch_add(1, std::memory_order_relaxed) < n;
+    }
+
+private:
+    std::atomic<uint64_t> count_{0};
+};
+
+// allow one call per interval. suppressed is set to the number of calls suppressed since the
+// previous allowed one.
+class throttle_every_ms {
+public:
+    bool allow(int64_t interval_ms, uint64_t &suppressed) {
+        auto now = static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                            std::chrono::steady_clock::now().time_since_epoch())
+                                            .count());
+        auto next = next_.load(std::memory_order_relaxed);
+        if (now < next ||
+            !next_.compare_exchange_strong(next, now + interval_ms, std::memory_order_relaxed)) {
+            suppressed_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    std::atomic<int64_t> next_{INT64_MIN};
+    std::atomic<uint64_t> suppressed_{0};
+};
+
+}  // namespace details
+}  // namespace spdlog
@@ -26,7 +26,8 @@ namespace details {
 class udp_client {
     static constexpr int TX_BUFFER_SIZE = 1024 * 10;
     SOCKET socket_ = INVALID_SOCKET;
-    sockaddr_in addr_ = {};
+    sockaddr_storage addr_ = {};
+    int addr_len_ = 0;
 
     static void init_winsock_() {
         WSADATA wsaData;
@@ -54,27 +55,39 @@ class udp_client {
     }
 
 public:
-    udp_client(const std::string &host, uint16_t port) {
+    // host can be an IPv4/IPv6 address or a hostname.
+    // send_buffer_size sets SO_SNDBUF (0 keeps the system default).
+    udp_client(const std::string &host, uint16_t port, int send_buffer_size = TX_BUFFER_SIZE) {
         init_winsock_();
 
-        addr_.sin_family = PF_INET;
-        addr_.sin_port = htons(port);
-        addr_.sin_addr.s_addr = INADDR_ANY;
-        if (InetPtonA(PF_INET, host.c_str(), &addr_.sin_addr.s_addr) != 1) {
+        struct addrinfo hints {};
+        ZeroMemory(&hints, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;  // To work with IPv4, IPv6, and so on
+        hints.ai_socktype = SOCK_DGRAM;
+        hints.ai_flags = AI_NUMERICSERV;  // port passed as as numeric value
+
+        auto port_str = std::to_string(port);
+        struct addrinfo *addrinfo_result;
+        if (::getaddrinfo(host.c_str(), port_str.c_str(), &hints, &addrinfo_result) != 0) {
             int last_error = ::WSAGetLastError();
             ::WSACleanup();
             throw_winsock_error_("error: Invalid address!", last_error);
         }
+        memcpy(&addr_, addrinfo_result->ai_addr, addrinfo_result->ai_addrlen);
+        addr_len_ = static_cast<int>(addrinfo_result->ai_addrlen);
+        auto family = addrinfo_result->ai_family;
+        ::freeaddrinfo(addrinfo_result);
 
-        socket_ = ::socket(PF_INET, SOCK_DGRAM, 0);
+        socket_ = ::socket(family, SOCK_DGRAM, 0);
         if (socket_ == INVALID_SOCKET) {
             int last_error = ::WSAGetLastError();
             ::WSACleanup();
             throw_winsock_error_("error: Create Socket failed", last_error);
         }
 
-        int option_value = TX_BUFFER_SIZE;
-        if (::setsockopt(socket_, SOL_SOCKET, SO_SNDBUF,
+        int option_value = send_buffer_size;
+        if (send_buffer_size > 0 &&
+            ::setsockopt(socket_, SOL_SOCKET, SO_SNDBUF,
                          reinterpret_cast<const char *>(&option_value), sizeof(option_value)) < 0) {
             int last_error = ::WSAGetLastError();
             cleanup_();
@@ -87,12 +100,19 @@ public:
     SOCKET fd() const { return socket_; }
 
     void send(const char *data, size_t n_bytes) {
-        socklen_t tolen = sizeof(struct sockaddr);
         if (::sendto(socket_, data, static_cast<int>(n_bytes), 0, (struct sockaddr *)&addr_,
-                     tolen) == -1) {
+                     addr_len_) == -1) {
             throw_spdlog_ex("sendto(2) failed", errno);
         }
     }
+
+    // Send n_datagrams datagrams stored back to back in data, with the given sizes.
+    void send_many(const char *data, const size_t *sizes, size_t n_datagrams) {
+        for (size_t i = 0; i < n_datagrams; i++) {
+            send(data, sizes[i]);
+            data += sizes[i];
+        }
+    }
 };
 }  // namespace details
 }  // namespace spdlog
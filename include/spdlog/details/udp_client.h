@@ -27,8 +27,10 @@ namespace details {
 
 class udp_client {
     static constexpr int TX_BUFFER_SIZE = 1024 * 10;
+    static constexpr size_t MAX_BATCH = 64;  // datagrams per sendmmsg call
     int socket_ = -1;
-    struct sockaddr_in sockAddr_;
+    struct sockaddr_storage sockAddr_;
+    socklen_t sockAddrLen_ = 0;
 
     void cleanup_() {
         if (socket_ != -1) {
@@ -38,28 +40,38 @@ class udp_client {
     }
 
 public:
-    udp_client(const std::string &host, uint16_t port) {
-        socket_ = ::socket(PF_INET, SOCK_DGRAM, 0);
+    // host can be an IPv4/IPv6 address or a hostname.
+    // send_buffer_size sets SO_SNDBUF (0 keeps the system default).
+    udp_client(const std::string &host, uint16_t port, int send_buffer_size = TX_BUFFER_SIZE) {
+        struct addrinfo hints {};
+        hints.ai_family = AF_UNSPEC;  // To work with IPv4, IPv6, and so on
+        hints.ai_socktype = SOCK_DGRAM;
+        hints.ai_flags = AI_NUMERICSERV;  // port passed as as numeric value
+
+        auto port_str = std::to_string(port);
+        struct addrinfo *addrinfo_result;
+        auto rv = ::getaddrinfo(host.c_str(), port_str.c_str(), &hints, &addrinfo_result);
+        if (rv != 0) {
+            throw_spdlog_ex(fmt_lib::format("error: Invalid address! {}", gai_strerror(rv)));
+        }
+        ::memset(&sockAddr_, 0, sizeof(sockAddr_));
+        ::memcpy(&sockAddr_, addrinfo_result->ai_addr, addrinfo_result->ai_addrlen);
+        sockAddrLen_ = static_cast<socklen_t>(addrinfo_result->ai_addrlen);
+        auto family = addrinfo_result->ai_family;
+        ::freeaddrinfo(addrinfo_result);
+
+        socket_ = ::socket(family, SOCK_DGRAM, 0);
         if (socket_ < 0) {
             throw_spdlog_ex("error: Create Socket Failed!");
         }
 
-        int option_value = TX_BUFFER_SIZE;
-        if (::setsockopt(socket_, SOL_SOCKET, SO_SNDBUF,
+        int option_value = send_buffer_size;
+        if (send_buffer_size > 0 &&
+            ::setsockopt(socket_, SOL_SOCKET, SO_SNDBUF,
                          reinterpret_cast<const char *>(&option_value), sizeof(option_value)) < 0) {
             cleanup_();
             throw_spdlog_ex("error: setsockopt(SO_SNDBUF) Failed!");
         }
-
-        sockAddr_.sin_family = AF_INET;
-        sockAddr_.sin_port = htons(port);
-
-        if (::inet_aton(host.c_str(), &sockAddr_.sin_addr) == 0) {
-            cleanup_();
-            throw_spdlog_ex("error: Invalid address!");
-        }
-
-        ::memset(sockAddr_.sin_zero, 0x00, sizeof(sockAddr_.sin_zero));
     }
 
     ~udp_client() { cleanup_(); }
@@ -69,13 +81,49 @@ public:
     // Send exactly n_bytes of the given data.
     // On error close the connection and throw.
     void send(const char *data, size_t n_bytes) {
-        ssize_t toslen = 0;
-        socklen_t tolen = sizeof(struct sockaddr);
-        if ((toslen = ::sendto(socket_, data, n_bytes, 0, (struct sockaddr *)&sockAddr_, tolen)) ==
-            -1) {
+        if (::sendto(socket_, data, n_bytes, 0, reinterpret_cast<struct sockaddr *>(&sockAddr_),
+                     sockAddrLen_) == -1) {
             throw_spdlog_ex("sendto(2) failed", errno);
         }
     }
+
+    // Send n_datagrams datagrams stored back to back in data, with the given sizes.
+    // Uses sendmmsg where available, so up to MAX_BATCH datagrams cost a single syscall.
+    void send_many(const char *data, const size_t *sizes, size_t n_datagrams) {
+#ifdef __linux__
+        struct mmsghdr msgs[MAX_BATCH];
+        struct iovec iovecs[MAX_BATCH];
+        while (n_datagrams > 0) {
+            auto n = n_datagrams < MAX_BATCH ? n_datagrams : MAX_BATCH;
+            for (size_t i = 0; i < n; i++) {
+                iovecs[i].iov_base = const_cast<char *>(data);
+                iovecs[i].iov_len = sizes[i];
+                data += sizes[i];
+                ::memset(&msgs[i], 0, sizeof(msgs[i]));
+                msgs[i].msg_hdr.msg_name = &sockAddr_;
+                msgs[i].msg_hdr.msg_namelen = sockAddrLen_;
+                msgs[i].msg_hdr.msg_iov = &iovecs[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+            }
+            // sendmmsg can send fewer datagrams than asked, so retry from the first unsent one
+            size_t sent = 0;
+            while (sent < n) {
+                auto rv = ::sendmmsg(socket_, msgs + sent, static_cast<unsigned int>(n - sent), 0);
+                if (rv == -1) {
+                    throw_spdlog_ex("sendmmsg(2) failed", errno);
+                }
+                sent += static_cast<size_t>(rv);
+            }
+            sizes += n;
+            n_datagrams -= n;
+        }
+#else
+        for (size_t i = 0; i < n_datagrams; i++) {
+            send(data, sizes[i]);
+            data += sizes[i];
+        }
+#endif
+    }
 };
 }  // namespace details
 }  // namespace spdlog
@@ -11,6 +11,7 @@
 #include <spdlog/pattern_formatter.h>
 #include <spdlog/sinks/sink.h>
 
+#include <algorithm>
 #include <cstdio>
 
 namespace spdlog {
@@ -42,6 +43,9 @@ SPDLOG_INLINE logger &logger::operator=(logger other) SPDLOG_NOEXCEPT {
 SPDLOG_INLINE void logger::swap(spdlog::logger &other) SPDLOG_NOEXCEPT {
     name_.swap(other.name_);
     sinks_.swap(other.sinks_);
+    sinks_snapshot_owner_.swap(other.sinks_snapshot_owner_);
+    sinks_snapshot_.store(sinks_snapshot_owner_.get());
+    other.sinks_snapshot_.store(other.sinks_snapshot_owner_.get());
 
     // swap level_
     auto other_level = other.level_.load();
@@ -55,11 +59,15 @@ SPDLOG_INLINE void logger::swap(spdlog::logger &other) SPDLOG_NOEXCEPT {
 
     custom_err_handler_.swap(other.custom_err_handler_);
     std::swap(tracer_, other.tracer_);
+    details::bump_level_epoch();
 }
 
 SPDLOG_INLINE void swap(logger &a, logger &b) { a.swap(b); }
 
-SPDLOG_INLINE void logger::set_level(level::level_enum log_level) { level_.store(log_level); }
+SPDLOG_INLINE void logger::set_level(level::level_enum log_level) {
+    level_.store(log_level);
+    details::bump_level_epoch();
+}
 
 SPDLOG_INLINE level::level_enum logger::level() const {
     return static_cast<level::level_enum>(level_.load(std::memory_order_relaxed));
@@ -70,6 +78,7 @@ SPDLOG_INLINE const std::string &logger::name() const { return name_; }
 // set formatting for the sinks in this logger.
 // each sink will get a separate instance of the formatter object.
 SPDLOG_INLINE void logger::set_formatter(std::unique_ptr<formatter> f) {
+    std::lock_guard<std::mutex> lock(sinks_mutex_);
     for (auto it = sinks_.begin(); it != sinks_.end(); ++it) {
         if (std::next(it) == sinks_.end()) {
             // last element - we can be move it.
@@ -87,10 +96,16 @@ SPDLOG_INLINE void logger::set_pattern(std::string pattern, pattern_time_type ti
 }
 
 // create new backtrace sink and move to it all our child sinks
-SPDLOG_INLINE void logger::enable_backtrace(size_t n_messages) { tracer_.enable(n_messages); }
+SPDLOG_INLINE void logger::enable_backtrace(size_t n_messages) {
+    tracer_.enable(n_messages);
+    details::bump_level_epoch();
+}
 
 // restore orig sinks and level and delete the backtrace sink
-SPDLOG_INLINE void logger::disable_backtrace() { tracer_.disable(); }
+SPDLOG_INLINE void logger::disable_backtrace() {
+    tracer_.disable();
+    details::bump_level_epoch();
+}
 
 SPDLOG_INLINE void logger::dump_backtrace() { dump_backtrace_(); }
 
@@ -108,6 +123,25 @@ SPDLOG_INLINE const std::vector<sink_ptr> &logger::sinks() const { return sinks_
 
 SPDLOG_INLINE std::vector<sink_ptr> &logger::sinks() { return sinks_; }
 
+SPDLOG_INLINE void logger::add_sink(sink_ptr sink) {
+    std::lock_guard<std::mutex> lock(sinks_mutex_);
+    auto new_sinks = sinks_;
+    new_sinks.push_back(std::move(sink));
+    publish_sinks_(std::move(new_sinks));
+}
+
+SPDLOG_INLINE void logger::remove_sink(const sink_ptr &sink) {
+    std::lock_guard<std::mutex> lock(sinks_mutex_);
+    auto new_sinks = sinks_;
+    new_sinks.erase(std::remove(new_sinks.begin(), new_sinks.end(), sink), new_sinks.end());
+    publish_sinks_(std::move(new_sinks));
+}
+
+SPDLOG_INLINE void logger::set_sinks(std::vector<sink_ptr> sinks) {
+    std::lock_guard<std::mutex> lock(sinks_mutex_);
+    publish_sinks_(std::move(sinks));
+}
+
 // error handler
 SPDLOG_INLINE void logger::set_error_handler(err_handler handler) {
     custom_err_handler_ = std::move(handler);
@@ -133,12 +167,12 @@ SPDLOG_INLINE void logger::log_it_(const spdlog::details::log_msg &log_msg,
 }
 
 SPDLOG_INLINE void logger::sink_it_(const details::log_msg &msg) {
-    for (auto &sink : sinks_) {
+    for_each_sink_([&](const sink_ptr &sink) {
         if (sink->should_log(msg.level)) {
             SPDLOG_TRY { sink->log(msg); }
             SPDLOG_LOGGER_CATCH(msg.source)
         }
-    }
+    });
 
     if (should_flush_(msg)) {
         flush_();
@@ -146,10 +180,22 @@ SPDLOG_INLINE void logger::sink_it_(const details::log_msg &msg) {
 }
 
 SPDLOG_INLINE void logger::flush_() {
-    for (auto &sink : sinks_) {
+    for_each_sink_([&](const sink_ptr &sink) {
         SPDLOG_TRY { sink->flush(); }
         SPDLOG_LOGGER_CATCH(source_loc())
-    }
+    });
+}
+
+// called with sinks_mutex_ held.
+// a thread that loaded the previous snapshot registered in one of the readers counters before
+// loading it. flipping the epoch sends new readers to the other counter, so each counter drains
+// even under constant logging. once both drained, the previous snapshot is no longer in use.
+SPDLOG_INLINE void logger::publish_sinks_(std::vector<sink_ptr> new_sinks) {
+    std::unique_ptr<const std::vector<sink_ptr>> snapshot(new std::vector<sink_ptr>(new_sinks));
+    sinks_snapshot_.store(snapshot.get(), std::memory_order_release);
+    sinks_epoch_.synchronize();
+    sinks_snapshot_owner_ = std::move(snapshot);
+    sinks_ = std::move(new_sinks);
 }
 
 SPDLOG_INLINE void logger::dump_backtrace_() {
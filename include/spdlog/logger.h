@@ -3,7 +3,7 @@
 
 #pragma once
 
-// Thread safe logger (except for set_error_handler())
+// Thread safe logger (except for set_error_handler() and changes through sinks())
 // Has name, log level, vector of std::shared sink pointers and formatter
 // Upon each log write the logger:
 // 1. Checks if its log level is enough to log the message and if yes:
@@ -16,6 +16,8 @@
 
 #include <spdlog/common.h>
 #include <spdlog/details/backtracer.h>
+#include <spdlog/details/callsite.h>
+#include <spdlog/details/read_epoch.h>
 #include <spdlog/details/log_msg.h>
 
 #ifdef SPDLOG_WCHAR_TO_UTF8_SUPPORT
@@ -25,6 +27,9 @@
     #include <spdlog/details/os.h>
 #endif
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #ifndef SPDLOG_NO_EXCEPTIONS
@@ -125,6 +130,27 @@ public:
 
     void log(level::level_enum lvl, string_view_t msg) { log(source_loc{}, lvl, msg); }
 
+    // log the message even if its level is disabled in this logger.
+    // used by the SPDLOG_* macros for the callsites turned on in the callsite_registry.
+    template <typename... Args>
+    void log_forced(source_loc loc,
+                    level::level_enum lvl,
+                    format_string_t<Args...> fmt,
+                    Args &&...args) {
+        log_if_(true, loc, lvl, details::to_string_view(fmt), std::forward<Args>(args)...);
+    }
+
+    template <class T,
+              typename std::enable_if<!is_convertible_to_any_format_string<const T &>::value,
+                                      int>::type = 0>
+    void log_forced(source_loc loc, level::level_enum lvl, const T &msg) {
+        log_forced(loc, lvl, "{}", msg);
+    }
+
+    void log_forced(source_loc loc, level::level_enum lvl, string_view_t msg) {
+        log_forced(loc, lvl, "{}", msg);
+    }
+
     template <typename... Args>
     void trace(format_string_t<Args...> fmt, Args &&...args) {
         log(level::trace, fmt, std::forward<Args>(args)...);
@@ -197,6 +223,18 @@ public:
 
     void log(level::level_enum lvl, wstring_view_t msg) { log(source_loc{}, lvl, msg); }
 
+    template <typename... Args>
+    void log_forced(source_loc loc,
+                    level::level_enum lvl,
+                    wformat_string_t<Args...> fmt,
+                    Args &&...args) {
+        log_if_(true, loc, lvl, details::to_string_view(fmt), std::forward<Args>(args)...);
+    }
+
+    void log_forced(source_loc loc, level::level_enum lvl, wstring_view_t msg) {
+        log_forced(loc, lvl, L"{}", msg);
+    }
+
     template <typename... Args>
     void trace(wformat_string_t<Args...> fmt, Args &&...args) {
         log(level::trace, fmt, std::forward<Args>(args)...);
@@ -266,6 +304,9 @@ public:
     // return true if backtrace logging is enabled.
     bool should_backtrace() const { return tracer_.enabled(); }
 
+    // identifies this logger instance in the callsite level caches
+    uint32_t callsite_key() const { return callsite_key_; }
+
     void set_level(level::level_enum log_level);
 
     level::level_enum level() const;
@@ -294,10 +335,20 @@ public:
     level::level_enum flush_level() const;
 
     // sinks
+    // the vector returned by sinks() may be changed only while no other thread uses the logger.
+    // once add_sink(), remove_sink() or set_sinks() were used, change the sinks only with them.
     const std::vector<sink_ptr> &sinks() const;
 
     std::vector<sink_ptr> &sinks();
 
+    // change the sinks while other threads are logging.
+    // the logging threads iterate an immutable snapshot of the sinks without locking; these
+    // functions publish a new snapshot and wait until no thread uses the previous one.
+    // must not be called from a sink of this logger.
+    void add_sink(sink_ptr sink);
+    void remove_sink(const sink_ptr &sink);
+    void set_sinks(std::vector<sink_ptr> sinks);
+
     // error handler
     void set_error_handler(err_handler);
 
@@ -311,15 +362,51 @@ protected:
     spdlog::level_t flush_level_{level::off};
     err_handler custom_err_handler_{nullptr};
     details::backtracer tracer_;
+    uint32_t callsite_key_{details::next_callsite_key()};
+
+    // sinks snapshot published by add_sink()/remove_sink()/set_sinks(). null until first used.
+    std::atomic<const std::vector<sink_ptr> *> sinks_snapshot_{nullptr};
+    std::unique_ptr<const std::vector<sink_ptr>> sinks_snapshot_owner_;
+    std::mutex sinks_mutex_;  // serializes the writers
+    details::read_epoch sinks_epoch_;  // the logging threads are readers while they iterate
+
+    // call f(const sink_ptr &) for each sink of the current snapshot
+    template <typename F>
+    void for_each_sink_(F &&f) {
+        details::read_epoch::reader_guard guard(sinks_epoch_);
+        const auto *snapshot = sinks_snapshot_.load(std::memory_order_acquire);
+        for (const auto &sink : snapshot ? *snapshot : sinks_) {
+            f(sink);
+        }
+    }
+
+    void publish_sinks_(std::vector<sink_ptr> new_sinks);
 
     // common implementation for after templated public api has been resolved
     template <typename... Args>
     void log_(source_loc loc, level::level_enum lvl, string_view_t fmt, Args &&...args) {
-        bool log_enabled = should_log(lvl);
+        log_if_(should_log(lvl), loc, lvl, fmt, std::forward<Args>(args)...);
+    }
+
+    // send the message to the sinks if log_enabled, and save it if backtrace is enabled
+    template <typename... Args>
+    void log_if_(bool log_enabled,
+                 source_loc loc,
+                 level::level_enum lvl,
+                 string_view_t fmt,
+                 Args &&...args) {
         bool traceback_enabled = tracer_.enabled();
         if (!log_enabled && !traceback_enabled) {
             return;
         }
+#if !defined(SPDLOG_USE_STD_FORMAT) && !defined(SPDLOG_NO_LAZY_BACKTRACE)
+        // only kept for backtrace: format it if it gets dumped
+        if (!log_enabled && backtrace_lazy_(loc, lvl, fmt,
+                                            details::lazy_format::all_supported<Args...>{},
+                                            args...)) {
+            return;
+        }
+#endif
         SPDLOG_TRY {
             memory_buf_t buf;
 #ifdef SPDLOG_USE_STD_FORMAT
@@ -334,10 +421,45 @@ protected:
         SPDLOG_LOGGER_CATCH(loc)
     }
 
+#if !defined(SPDLOG_USE_STD_FORMAT) && !defined(SPDLOG_NO_LAZY_BACKTRACE)
+    // push the unformatted message to the backtrace. returns false if the arguments are not
+    // supported by details::lazy_format.
+    template <typename... Args>
+    bool backtrace_lazy_(source_loc loc,
+                         level::level_enum lvl,
+                         string_view_t fmt,
+                         std::true_type,
+                         const Args &...args) {
+        SPDLOG_TRY {
+            details::log_msg log_msg(loc, name_, lvl, string_view_t{});
+            return tracer_.push_back_lazy(log_msg, fmt, args...);
+        }
+        SPDLOG_LOGGER_CATCH(loc)
+        return true;
+    }
+
+    template <typename... Args>
+    bool backtrace_lazy_(source_loc,
+                         level::level_enum,
+                         string_view_t,
+                         std::false_type,
+                         const Args &...) {
+        return false;
+    }
+#endif
+
 #ifdef SPDLOG_WCHAR_TO_UTF8_SUPPORT
     template <typename... Args>
     void log_(source_loc loc, level::level_enum lvl, wstring_view_t fmt, Args &&...args) {
-        bool log_enabled = should_log(lvl);
+        log_if_(should_log(lvl), loc, lvl, fmt, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void log_if_(bool log_enabled,
+                 source_loc loc,
+                 level::level_enum lvl,
+                 wstring_view_t fmt,
+                 Args &&...args) {
         bool traceback_enabled = tracer_.enabled();
         if (!log_enabled && !traceback_enabled) {
             return;
@@ -13,28 +13,27 @@
 namespace spdlog {
 namespace sinks {
 
-template <typename Mutex>
-SPDLOG_INLINE basic_file_sink<Mutex>::basic_file_sink(const filename_t &filename,
-                                                      bool truncate,
-                                                      const file_event_handlers &event_handlers)
+template <typename Mutex, typename FileHelper>
+SPDLOG_INLINE basic_file_sink<Mutex, FileHelper>::basic_file_sink(
+    const filename_t &filename, bool truncate, const file_event_handlers &event_handlers)
     : file_helper_{event_handlers} {
     file_helper_.open(filename, truncate);
 }
 
-template <typename Mutex>
-SPDLOG_INLINE const filename_t &basic_file_sink<Mutex>::filename() const {
+template <typename Mutex, typename FileHelper>
+SPDLOG_INLINE const filename_t &basic_file_sink<Mutex, FileHelper>::filename() const {
     return file_helper_.filename();
 }
 
-template <typename Mutex>
-SPDLOG_INLINE void basic_file_sink<Mutex>::sink_it_(const details::log_msg &msg) {
+template <typename Mutex, typename FileHelper>
+SPDLOG_INLINE void basic_file_sink<Mutex, FileHelper>::sink_it_(const details::log_msg &msg) {
     memory_buf_t formatted;
     base_sink<Mutex>::formatter_->format(msg, formatted);
     file_helper_.write(formatted);
 }
 
-template <typename Mutex>
-SPDLOG_INLINE void basic_file_sink<Mutex>::flush_() {
+template <typename Mutex, typename FileHelper>
+SPDLOG_INLINE void basic_file_sink<Mutex, FileHelper>::flush_() {
     file_helper_.flush();
 }
 
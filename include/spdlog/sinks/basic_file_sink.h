@@ -16,7 +16,7 @@ namespace sinks {
 /*
  * Trivial file sink with single file as target
  */
-template <typename Mutex>
+template <typename Mutex, typename FileHelper = details::file_helper>
 class basic_file_sink final : public base_sink<Mutex> {
 public:
     explicit basic_file_sink(const filename_t &filename,
@@ -29,7 +29,7 @@ protected:
     void flush_() override;
 
 private:
-    details::file_helper file_helper_;
+    FileHelper file_helper_;
 };
 
 using basic_file_sink_mt = basic_file_sink<std::mutex>;
@@ -0,0 +1,77 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <spdlog/common.h>
+#include <spdlog/details/binary_protocol.h>
+#include <spdlog/details/null_mutex.h>
+#include <spdlog/details/synchronous_factory.h>
+#include <spdlog/sinks/base_sink.h>
+#include <spdlog/sinks/tcp_sink.h>
+
+#include <mutex>
+#include <string>
+
+// Tcp client sink that sends the log_msg fields in a compact binary format instead of
+// formatted text (see details/binary_protocol.h), so the receiver doesn't need to parse lines.
+// The receiver can use details::binary_decoder to rebuild the messages and pass them to its own
+// sinks. The formatter of this sink is not used.
+// Will attempt to reconnect if connection drops, starting a new stream on each connection.
+
+namespace spdlog {
+namespace sinks {
+
+template <typename Mutex>
+class binary_tcp_sink final : public spdlog::sinks::base_sink<Mutex> {
+public:
+    // connect to tcp host/port or throw if failed
+    // host can be hostname or ip address
+    explicit binary_tcp_sink(tcp_sink_config sink_config)
+        : config_{std::move(sink_config)} {
+        if (!config_.lazy_connect) {
+            connect_();
+        }
+    }
+
+protected:
+    void sink_it_(const spdlog::details::log_msg &msg) override {
+        if (!client_.is_connected()) {
+            connect_();
+        }
+        buf_.clear();
+        encoder_.encode(msg, buf_);
+        client_.send(buf_.data(), buf_.size());
+    }
+
+    void flush_() override {}
+
+private:
+    void connect_() {
+        client_.connect(config_.server_host, config_.server_port);
+        buf_.clear();
+        encoder_.reset(buf_);
+        client_.send(buf_.data(), buf_.size());
+    }
+
+    tcp_sink_config config_;
+    details::tcp_client client_;
+    details::binary_encoder encoder_;
+    memory_buf_t buf_;
+};
+
+using binary_tcp_sink_mt = binary_tcp_sink<std::mutex>;
+using binary_tcp_sink_st = binary_tcp_sink<spdlog::details::null_mutex>;
+
+}  // namespace sinks
+
+//
+// factory functions
+//
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> binary_tcp_logger_mt(const std::string &logger_name,
+                                                    sinks::tcp_sink_config sink_config) {
+    return Factory::template create<sinks::binary_tcp_sink_mt>(logger_name, sink_config);
+}
+
+}  // namespace spdlog
@@ -0,0 +1,265 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <spdlog/common.h>
+#include <spdlog/details/null_mutex.h>
+#include <spdlog/sinks/base_sink.h>
+#ifdef _WIN32
+    #include <spdlog/details/tcp_client-windows.h>
+#else
+    #include <spdlog/details/tcp_client.h>
+    #include <sys/time.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Non blocking tcp client sink.
+// Formatted messages are appended to a bounded in-memory buffer, which a background thread
+// sends to the remote address. Everything that accumulated while the previous batch was sent
+// goes out in a single send call.
+// If the connection fails or drops, the sender reconnects with exponential backoff while the
+// buffer keeps absorbing messages. A batch that failed in the middle of a send, or whose send
+// was blocked for longer than send_timeout (e.g. by a server that stopped reading), is dropped.
+// When the buffer is full, the overflow policy decides whether to block the logging thread,
+// drop the oldest buffered messages, or drop the new message.
+
+namespace spdlog {
+namespace sinks {
+
+struct buffered_tcp_sink_config {
+    std::string server_host;
+    int server_port;
+    size_t buffer_size = 1024 * 1024;  // max bytes waiting to be sent
+    async_overflow_policy overflow_policy = async_overflow_policy::discard_new;
+    std::chrono::milliseconds min_backoff{100};  // first reconnect delay, doubled on each failure
+    std::chrono::milliseconds max_backoff{10000};
+    std::chrono::milliseconds send_timeout{5000};  // also bounds the wait in the destructor
+
+    buffered_tcp_sink_config(std::string host, int port)
+        : server_host{std::move(host)},
+          server_port{port} {}
+};
+
+template <typename Mutex>
+class buffered_tcp_sink final : public spdlog::sinks::base_sink<Mutex> {
+public:
+    explicit buffered_tcp_sink(buffered_tcp_sink_config sink_config)
+        : config_{std::move(sink_config)} {
+        sender_thread_ = std::thread([this]() { this->sender_loop_(); });
+    }
+
+    buffered_tcp_sink(const buffered_tcp_sink &) = delete;
+    buffered_tcp_sink &operator=(const buffered_tcp_sink &) = delete;
+
+    // try to send what is left in the buffer (if connected), then stop the sender
+    ~buffered_tcp_sink() override {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            stop_ = true;
+        }
+        data_cv_.notify_one();
+        space_cv_.notify_all();
+        sender_thread_.join();
+    }
+
+    bool connected() const { return connected_.load(std::memory_order_relaxed); }
+
+    // bytes sent to the server so far
+    size_t sent_bytes() const { return sent_bytes_.load(std::memory_order_relaxed); }
+
+    // messages dropped because the buffer was full or their batch failed to send
+    size_t dropped_messages() const { return dropped_messages_.load(std::memory_order_relaxed); }
+
+    // number of failed connect or send attempts
+    size_t connection_errors() const { return connection_errors_.load(std::memory_order_relaxed); }
+
+protected:
+    void sink_it_(const spdlog::details::log_msg &msg) override {
+        spdlog::memory_buf_t formatted;
+        spdlog::sinks::base_sink<Mutex>::formatter_->format(msg, formatted);
+        if (formatted.size() > config_.buffer_size) {
+            dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        if (pending_.size() + formatted.size() > config_.buffer_size) {
+            switch (config_.overflow_policy) {
+                case async_overflow_policy::block:
+                    space_cv_.wait(lock, [&] {
+                        return stop_ || pending_.size() + formatted.size() <= config_.buffer_size;
+                    });
+                    break;
+                case async_overflow_policy::overrun_oldest:
+                    drop_oldest_(formatted.size());
+                    break;
+                default:
+                    dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+            }
+        }
+        pending_.append(formatted.data(), formatted.data() + formatted.size());
+        pending_sizes_.push_back(formatted.size());
+        lock.unlock();
+        data_cv_.notify_one();
+    }
+
+    // wait until the buffer was sent. returns right away if not connected.
+    void flush_() override {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        idle_cv_.wait(lock, [this] {
+            return stop_ || !connected() || (pending_.size() == 0 && !sending_);
+        });
+    }
+
+private:
+    // make room for n_bytes by dropping the oldest messages.
+    // drops down to 3/4 of the buffer, so the memmove is amortized over several messages.
+    void drop_oldest_(size_t n_bytes) {
+        size_t target = config_.buffer_size / 4 * 3;
+        target = n_bytes < target ? target - n_bytes : 0;
+        size_t drop_bytes = 0;
+        size_t drop_count = 0;
+        while (drop_count < pending_sizes_.size() && pending_.size() - drop_bytes > target) {
+            drop_bytes += pending_sizes_[drop_count++];
+        }
+        std::copy(pending_.data() + drop_bytes, pending_.data() + pending_.size(),
+                  pending_.data());
+        pending_.resize(pending_.size() - drop_bytes);
+        pending_sizes_.erase(pending_sizes_.begin(),
+                             pending_sizes_.begin() + static_cast<std::ptrdiff_t>(drop_count));
+        dropped_messages_.fetch_add(drop_count, std::memory_order_relaxed);
+    }
+
+    void sender_loop_() {
+        auto backoff = config_.min_backoff;
+        spdlog::memory_buf_t sending;
+        for (;;) {
+            // messages keep accumulating in the buffer while not connected
+            if (!client_.is_connected()) {
+                if (!connect_()) {
+                    if (!wait_backoff_(backoff)) {
+                        return;
+                    }
+                    backoff = (std::min)(backoff * 2, config_.max_backoff);
+                    continue;
+                }
+                backoff = config_.min_backoff;
+            }
+
+            size_t n_msgs;
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex_);
+                sending_ = false;
+                idle_cv_.notify_all();
+                data_cv_.wait(lock, [this] { return stop_ || pending_.size() > 0; });
+                if (pending_.size() == 0) {
+                    return;  // stopped and nothing left to send
+                }
+                std::swap(sending, pending_);
+                n_msgs = pending_sizes_.size();
+                pending_sizes_.clear();
+                sending_ = true;
+            }
+            space_cv_.notify_all();
+
+            SPDLOG_TRY {
+                client_.send(sending.data(), sending.size());
+                sent_bytes_.fetch_add(sending.size(), std::memory_order_relaxed);
+            }
+            SPDLOG_CATCH_STD
+            if (!client_.is_connected()) {
+                // the send failed and closed the connection. it's unknown how much of the batch
+                // was received, so count all of it as dropped.
+                connected_.store(false, std::memory_order_relaxed);
+                connection_errors_.fetch_add(1, std::memory_order_relaxed);
+                dropped_messages_.fetch_add(n_msgs, std::memory_order_relaxed);
+                if (stopping_()) {
+                    return;
+                }
+            }
+            sending.clear();
+        }
+    }
+
+    bool connect_() {
+        SPDLOG_TRY {
+            client_.connect(config_.server_host, config_.server_port);
+            set_send_timeout_();
+            connected_.store(true, std::memory_order_relaxed);
+            return true;
+        }
+        SPDLOG_CATCH_STD
+        connection_errors_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // a send blocked for longer fails, so a server that stopped reading can't block the sender
+    // (and the destructor, which waits for it) forever.
+    void set_send_timeout_() {
+        auto ms = config_.send_timeout.count();
+        if (ms <= 0) {
+            return;
+        }
+#ifdef _WIN32
+        DWORD timeout = static_cast<DWORD>(ms);
+#else
+        timeval timeout{};
+        timeout.tv_sec = static_cast<decltype(timeout.tv_sec)>(ms / 1000);
+        timeout.tv_usec = static_cast<decltype(timeout.tv_usec)>(ms % 1000 * 1000);
+#endif
+        ::setsockopt(client_.fd(), SOL_SOCKET, SO_SNDTIMEO,
+                     reinterpret_cast<const char *>(&timeout), sizeof(timeout));
+    }
+
+    // true if the destructor was called. called after the connection was lost: what is left is
+    // counted as dropped, instead of reconnecting to send it.
+    bool stopping_() {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (stop_) {
+            dropped_messages_.fetch_add(pending_sizes_.size(), std::memory_order_relaxed);
+        }
+        return stop_;
+    }
+
+    // wait before the next connect attempt. returns false if the sink is being destroyed.
+    bool wait_backoff_(std::chrono::milliseconds backoff) {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        sending_ = false;
+        idle_cv_.notify_all();
+        return !data_cv_.wait_for(lock, backoff, [this] { return stop_; });
+    }
+
+    buffered_tcp_sink_config config_;
+    details::tcp_client client_;  // used only by the sender thread
+
+    std::mutex queue_mutex_;
+    std::condition_variable data_cv_;   // pending data or stop
+    std::condition_variable space_cv_;  // buffer space freed
+    std::condition_variable idle_cv_;   // sender finished a batch
+    spdlog::memory_buf_t pending_;
+    std::deque<size_t> pending_sizes_;  // size of each message in pending_
+    bool sending_ = false;
+    bool stop_ = false;
+
+    std::atomic<bool> connected_{false};
+    std::atomic<size_t> sent_bytes_{0};
+    std::atomic<size_t> dropped_messages_{0};
+    std::atomic<size_t> connection_errors_{0};
+    std::thread sender_thread_;
+};
+
+using buffered_tcp_sink_mt = buffered_tcp_sink<std::mutex>;
+using buffered_tcp_sink_st = buffered_tcp_sink<spdlog::details::null_mutex>;
+
+}  // namespace sinks
+}  // namespace spdlog
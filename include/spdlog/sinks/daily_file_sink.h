@@ -63,7 +63,9 @@ struct daily_filename_format_calculator {
  * If truncate != false , the created file will be truncated.
  * If max_files > 0, retain only the last max_files and delete previous.
  */
-template <typename Mutex, typename FileNameCalc = daily_filename_calculator>
+template <typename Mutex,
+          typename FileNameCalc = daily_filename_calculator,
+          typename FileHelper = details::file_helper>
 class daily_file_sink final : public base_sink<Mutex> {
 public:
     // create daily file sink which rotates on given time
@@ -183,7 +185,7 @@ private:
     int rotation_h_;
     int rotation_m_;
     log_clock::time_point rotation_tp_;
-    details::file_helper file_helper_;
+    FileHelper file_helper_;
     bool truncate_;
     uint16_t max_files_;
     details::circular_q<filename_t> filenames_q_;
@@ -0,0 +1,178 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "dist_sink.h"
+#include <spdlog/details/log_msg.h>
+#include <spdlog/details/null_mutex.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Duplicate message removal sink, for floods of repeating messages from several threads.
+//
+// Unlike dup_filter_sink, which only compares with the previous message, each message is looked
+// up by the hash of its logger name, level and payload in a table of the recently seen messages
+// (4 entries per hash bucket, the least recently started one is replaced). A message passes if
+// it wasn't seen within the last max_skip_duration, and is suppressed otherwise. Once the window
+// of a suppressed message is over, a summary is logged at notification_level:
+//
+//     Suppressed 1234 occurrences of "connection refused: 10.0.0.1:80"
+//
+// The summaries are logged by the next message (or flush) after the window ends, and when the
+// entry is replaced. Each message costs one hash of its payload and a lookup in 4 entries.
+// Distinct messages with the same 64 bit hash would be taken for duplicates.
+//
+// Example:
+//
+//     auto dedup = std::make_shared<spdlog::sinks::dedup_sink_mt>(std::chrono::seconds(10));
+//     dedup->add_sink(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
+//     spdlog::logger l("logger", dedup);
+
+namespace spdlog {
+namespace sinks {
+template <typename Mutex>
+class dedup_sink : public dist_sink<Mutex> {
+public:
+    // n_entries is rounded up to a power of 2 (at least 4)
+    template <class Rep, class Period>
+    explicit dedup_sink(std::chrono::duration<Rep, Period> max_skip_duration,
+                        size_t n_entries = 1024,
+                        level::level_enum notification_level = level::info)
+        : max_skip_duration_{max_skip_duration},
+          notification_level_{notification_level} {
+        size_t n_buckets = 1;
+        while (n_buckets * ways < n_entries) {
+            n_buckets *= 2;
+        }
+        entries_.resize(n_buckets * ways);
+    }
+
+    // messages suppressed so far
+    size_t suppressed_messages() const { return suppressed_.load(std::memory_order_relaxed); }
+
+    // summaries logged so far
+    size_t summaries() const { return summaries_.load(std::memory_order_relaxed); }
+
+protected:
+    void sink_it_(const details::log_msg &msg) override {
+        if (pending_summaries_ > 0 && msg.time >= next_sweep_) {
+            sweep_(msg.time);
+        }
+
+        auto hash = hash_(msg);
+        auto *bucket = &entries_[(hash & (entries_.size() / ways - 1)) * ways];
+        entry *victim = bucket;
+        for (size_t i = 0; i < ways; i++) {
+            auto &e = bucket[i];
+            if (e.used && e.hash == hash) {
+                if (msg.time - e.window_start < max_skip_duration_) {
+                    if (e.suppressed++ == 0) {
+                        pending_summaries_++;
+                    }
+                    suppressed_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                // the window is over: summarize it and start a new one
+                summarize_(e, msg.time);
+                e.window_start = msg.time;
+                dist_sink<Mutex>::sink_it_(msg);
+                return;
+            }
+            if (!e.used || (victim->used && e.window_start < victim->window_start)) {
+                victim = &e;
+            }
+        }
+
+        summarize_(*victim, msg.time);
+        victim->used = true;
+        victim->hash = hash;
+        victim->window_start = msg.time;
+        victim->logger_name.assign(msg.logger_name.data(), msg.logger_name.size());
+        victim->text.assign(msg.payload.data(), (std::min)(msg.payload.size(), max_text_size));
+        dist_sink<Mutex>::sink_it_(msg);
+    }
+
+    void flush_() override {
+        sweep_(log_clock::now());
+        dist_sink<Mutex>::flush_();
+    }
+
+private:
+    static constexpr size_t ways = 4;
+    static constexpr size_t max_text_size = 128;  // payload bytes quoted by the summaries
+
+    struct entry {
+        bool used = false;
+        uint64_t hash = 0;
+        log_clock::time_point window_start;
+        size_t suppressed = 0;
+        std::string logger_name;
+        std::string text;
+    };
+
+    // FNV-1a of the logger name, the level and the payload
+    static uint64_t hash_(const details::log_msg &msg) {
+        uint64_t h = 14695981039346656037ull;
+        auto add = [&h](const char *data, size_t size) {
+            for (size_t i = 0; i < size; i++) {
+                h = (h ^ static_cast<unsigned char>(data[i])) * 1099511628211ull;
+            }
+        };
+        add(msg.logger_name.data(), msg.logger_name.size());
+        auto lvl = static_cast<char>(msg.level);
+        add(&lvl, 1);
+        add(msg.payload.data(), msg.payload.size());
+        return h;
+    }
+
+    // log the summary of the entry if messages were suppressed
+    void summarize_(entry &e, log_clock::time_point now) {
+        if (e.suppressed == 0) {
+            return;
+        }
+        auto text = "Suppressed " + std::to_string(e.suppressed) + " occurrences of \"" + e.text +
+                    "\"";
+        details::log_msg summary{now, source_loc{}, e.logger_name, notification_level_, text};
+        e.suppressed = 0;
+        pending_summaries_--;
+        summaries_.fetch_add(1, std::memory_order_relaxed);
+        dist_sink<Mutex>::sink_it_(summary);
+    }
+
+    // summarize the entries whose window is over. called by sink_it_() at most once per
+    // max_skip_duration, and only if messages were suppressed, so the cost per message stays
+    // constant.
+    void sweep_(log_clock::time_point now) {
+        for (auto &e : entries_) {
+            if (e.used && e.suppressed > 0 && now - e.window_start >= max_skip_duration_) {
+                summarize_(e, now);
+            }
+        }
+        next_sweep_ = now + std::chrono::duration_cast<log_clock::duration>(max_skip_duration_);
+    }
+
+    std::chrono::microseconds max_skip_duration_;
+    level::level_enum notification_level_;
+    std::vector<entry> entries_;
+    log_clock::time_point next_sweep_;
+    size_t pending_summaries_ = 0;  // entries with suppressed messages
+    std::atomic<size_t> suppressed_{0};
+    std::atomic<size_t> summaries_{0};
+};
+
+// odr-used by std::min (needed before C++17)
+template <typename Mutex>
+constexpr size_t dedup_sink<Mutex>::max_text_size;
+
+using dedup_sink_mt = dedup_sink<std::mutex>;
+using dedup_sink_st = dedup_sink<details::null_mutex>;
+
+}  // namespace sinks
+}  // namespace spdlog
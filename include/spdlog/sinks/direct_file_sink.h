@@ -0,0 +1,44 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+//
+// File sinks that bypass the page cache using O_DIRECT (see details/direct_file_helper.h).
+// Data is written in whole blocks, so it reaches the file only when the internal buffer fills
+// up or on flush().
+//
+// Example:
+//
+//     #include <spdlog/sinks/direct_file_sink.h>
+//
+//     // preallocate each 100MB file and write it with O_DIRECT
+//     auto sink = std::make_shared<spdlog::sinks::rotating_direct_file_sink_mt>(
+//         "logs/direct.log", 1024 * 1024 * 100, 3, false, spdlog::file_event_handlers{}, true);
+//
+
+#include <spdlog/details/direct_file_helper.h>
+#include <spdlog/details/null_mutex.h>
+#include <spdlog/sinks/basic_file_sink.h>
+#include <spdlog/sinks/rotating_file_sink.h>
+
+#ifndef SPDLOG_HEADER_ONLY
+    // the compiled lib only instantiates the sinks with the default file_helper
+    #include <spdlog/sinks/basic_file_sink-inl.h>
+    #include <spdlog/sinks/rotating_file_sink-inl.h>
+#endif
+
+#include <mutex>
+
+namespace spdlog {
+namespace sinks {
+
+using basic_direct_file_sink_mt = basic_file_sink<std::mutex, details::direct_file_helper>;
+using basic_direct_file_sink_st = basic_file_sink<details::null_mutex, details::direct_file_helper>;
+
+using rotating_direct_file_sink_mt = rotating_file_sink<std::mutex, details::direct_file_helper>;
+using rotating_direct_file_sink_st =
+    rotating_file_sink<details::null_mutex, details::direct_file_helper>;
+
+}  // namespace sinks
+}  // namespace spdlog
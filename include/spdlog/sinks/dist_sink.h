@@ -5,16 +5,25 @@
 
 #include "base_sink.h"
 #include <spdlog/details/log_msg.h>
+#include <spdlog/details/log_msg_buffer.h>
+#include <spdlog/details/mpmc_blocking_q.h>
 #include <spdlog/details/null_mutex.h>
 #include <spdlog/pattern_formatter.h>
 
 #include <algorithm>
+#include <atomic>
+#include <iterator>
 #include <memory>
 #include <mutex>
+#include <thread>
 #include <vector>
 
 // Distribution sink (mux). Stores a vector of sinks which get called when log
-// is called
+// is called.
+//
+// Sinks added with add_queued_sink() are instead fed through a queue by a dedicated thread,
+// so a slow sink (e.g. a network sink) doesn't add latency to the others. Each message is
+// copied once, and the copy is shared by the queues of all the queued sinks.
 
 namespace spdlog {
 namespace sinks {
@@ -34,11 +43,36 @@ public:
         sinks_.push_back(sub_sink);
     }
 
-    void remove_sink(std::shared_ptr<sink> sub_sink) {
+    // log to sub_sink from a dedicated thread, through a queue of up to queue_size messages.
+    // like in async_logger, the overflow policy decides what happens when the queue is full,
+    // and flush() only queues a flush request.
+    void add_queued_sink(std::shared_ptr<sink> sub_sink,
+                         size_t queue_size = 8192,
+                         async_overflow_policy overflow_policy = async_overflow_policy::block) {
+        std::unique_ptr<queued_sink> queued(
+            new queued_sink(std::move(sub_sink), queue_size, overflow_policy));
         std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
-        sinks_.erase(std::remove(sinks_.begin(), sinks_.end(), sub_sink), sinks_.end());
+        queued_sinks_.push_back(std::move(queued));
+    }
+
+    // remove the sink, whether queued or not. a queued sink first logs what is in its queue,
+    // after the lock is released, so logging to the other sinks goes on meanwhile.
+    void remove_sink(std::shared_ptr<sink> sub_sink) {
+        std::vector<std::unique_ptr<queued_sink>> removed;
+        {
+            std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+            sinks_.erase(std::remove(sinks_.begin(), sinks_.end(), sub_sink), sinks_.end());
+            auto kept_end =
+                std::stable_partition(queued_sinks_.begin(), queued_sinks_.end(),
+                                      [&sub_sink](const std::unique_ptr<queued_sink> &q) {
+                                          return q->target != sub_sink;
+                                      });
+            std::move(kept_end, queued_sinks_.end(), std::back_inserter(removed));
+            queued_sinks_.erase(kept_end, queued_sinks_.end());
+        }
     }
 
+    // replace the sinks that are called inline. queued sinks are kept.
     void set_sinks(std::vector<std::shared_ptr<sink>> sinks) {
         std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
         sinks_ = std::move(sinks);
@@ -46,8 +80,38 @@ public:
 
     std::vector<std::shared_ptr<sink>> &sinks() { return sinks_; }
 
+    // messages dropped or overrun by the queues of the queued sinks
+    size_t queued_dropped_messages() {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+        size_t n = 0;
+        for (auto &queued : queued_sinks_) {
+            n += queued->q.overrun_counter() + queued->q.discard_counter();
+        }
+        return n;
+    }
+
+    // exceptions thrown by the queued sinks (they have no logger to report them to)
+    size_t queued_errors() {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+        size_t n = 0;
+        for (auto &queued : queued_sinks_) {
+            n += queued->errors.load(std::memory_order_relaxed);
+        }
+        return n;
+    }
+
 protected:
     void sink_it_(const details::log_msg &msg) override {
+        // hand the message to the queued sinks first, so they start as soon as possible
+        std::shared_ptr<const details::log_msg_buffer> shared_msg;
+        for (auto &queued : queued_sinks_) {
+            if (queued->target->should_log(msg.level)) {
+                if (!shared_msg) {
+                    shared_msg = std::make_shared<const details::log_msg_buffer>(msg);
+                }
+                queued->push(queued_item{queued_item_type::log, shared_msg});
+            }
+        }
         for (auto &sub_sink : sinks_) {
             if (sub_sink->should_log(msg.level)) {
                 sub_sink->log(msg);
@@ -56,6 +120,9 @@ protected:
     }
 
     void flush_() override {
+        for (auto &queued : queued_sinks_) {
+            queued->push(queued_item{queued_item_type::flush, nullptr});
+        }
         for (auto &sub_sink : sinks_) {
             sub_sink->flush();
         }
@@ -70,8 +137,85 @@ protected:
         for (auto &sub_sink : sinks_) {
             sub_sink->set_formatter(base_sink<Mutex>::formatter_->clone());
         }
+        for (auto &queued : queued_sinks_) {
+            queued->target->set_formatter(base_sink<Mutex>::formatter_->clone());
+        }
     }
+
+    enum class queued_item_type { log, flush, terminate };
+
+    struct queued_item {
+        queued_item() = default;
+        queued_item(queued_item_type item_type,
+                    std::shared_ptr<const details::log_msg_buffer> item_msg)
+            : type{item_type},
+              msg{std::move(item_msg)} {}
+
+        queued_item_type type = queued_item_type::log;
+        std::shared_ptr<const details::log_msg_buffer> msg;
+    };
+
+    // a sink with its queue and the thread that feeds it
+    struct queued_sink {
+        queued_sink(std::shared_ptr<sink> sub_sink,
+                    size_t queue_size,
+                    async_overflow_policy policy)
+            : target{std::move(sub_sink)},
+              q{queue_size},
+              overflow_policy{policy} {
+            worker = std::thread([this]() { this->worker_loop(); });
+        }
+
+        queued_sink(const queued_sink &) = delete;
+        queued_sink &operator=(const queued_sink &) = delete;
+
+        ~queued_sink() {
+            q.enqueue(queued_item{queued_item_type::terminate, nullptr});
+            worker.join();
+        }
+
+        void push(queued_item &&item) {
+            if (overflow_policy == async_overflow_policy::block) {
+                q.enqueue(std::move(item));
+            } else if (overflow_policy == async_overflow_policy::overrun_oldest) {
+                q.enqueue_nowait(std::move(item));
+            } else {
+                q.enqueue_if_have_room(std::move(item));
+            }
+        }
+
+        void worker_loop() {
+            for (;;) {
+                queued_item item;
+                q.dequeue(item);
+                if (item.type == queued_item_type::terminate) {
+                    return;
+                }
+                bool ok = false;
+                SPDLOG_TRY {
+                    if (item.type == queued_item_type::log) {
+                        target->log(*item.msg);
+                    } else {
+                        target->flush();
+                    }
+                    ok = true;
+                }
+                SPDLOG_CATCH_STD
+                if (!ok) {
+                    errors.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        std::shared_ptr<sink> target;
+        details::mpmc_blocking_queue<queued_item> q;
+        async_overflow_policy overflow_policy;
+        std::atomic<size_t> errors{0};
+        std::thread worker;
+    };
+
     std::vector<std::shared_ptr<sink>> sinks_;
+    std::vector<std::unique_ptr<queued_sink>> queued_sinks_;
 };
 
 using dist_sink_mt = dist_sink<std::mutex>;
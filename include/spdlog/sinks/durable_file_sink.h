@@ -0,0 +1,265 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <spdlog/common.h>
+#include <spdlog/details/file_helper.h>
+#include <spdlog/details/os.h>
+#include <spdlog/details/synchronous_factory.h>
+#include <spdlog/pattern_formatter.h>
+#include <spdlog/sinks/sink.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+// File sink with group commit durability.
+//
+// Messages at or above the durable level block the logging thread until their bytes (and all the
+// bytes written before them) were fdatasync'ed to disk. Messages below it are written as usual.
+//
+// The fdatasync calls are done by a dedicated thread: all the threads waiting at the same time
+// share a single fdatasync, so the number of syncs is bounded by the disk and not by the number
+// of durable messages. min_sync_interval can be used to further bound the sync rate at the
+// expense of latency for durable messages.
+//
+// Example:
+//
+//     #include <spdlog/sinks/durable_file_sink.h>
+//
+//     // every warn/error/critical message is on disk when log() returns
+//     auto logger = spdlog::durable_logger_mt("durable", "logs/durable.txt", spdlog::level::warn);
+
+namespace spdlog {
+namespace sinks {
+
+class durable_file_sink final : public sink {
+public:
+    explicit durable_file_sink(const filename_t &filename,
+                               level::level_enum durable_level = level::err,
+                               std::chrono::milliseconds min_sync_interval = {},
+                               bool truncate = false,
+                               const file_event_handlers &event_handlers = {})
+        : formatter_{details::make_unique<spdlog::pattern_formatter>()},
+          file_helper_{event_handlers},
+          durable_level_{durable_level},
+          min_sync_interval_{min_sync_interval} {
+        file_helper_.open(filename, truncate);
+        sync_thread_ = std::thread([this]() { this->sync_loop_(); });
+    }
+
+    durable_file_sink(const durable_file_sink &) = delete;
+    durable_file_sink &operator=(const durable_file_sink &) = delete;
+
+    ~durable_file_sink() override {
+        {
+            std::lock_guard<std::mutex> lock(sync_mutex_);
+            stop_ = true;
+        }
+        sync_cv_.notify_one();
+        sync_thread_.join();
+    }
+
+    void log(const details::log_msg &msg) override {
+        bool durable = msg.level >= durable_level();
+        uint64_t seq;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            memory_buf_t formatted;
+            formatter_->format(msg, formatted);
+            file_helper_.write(formatted);
+            seq = ++written_seq_;
+            if (durable) {
+                add_waiter_(seq);
+            }
+        }
+        if (durable) {
+            wait_synced_(seq);
+        }
+    }
+
+    void flush() override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        file_helper_.flush();
+    }
+
+    // block until everything logged so far is on disk
+    void sync() {
+        uint64_t seq;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            seq = written_seq_;
+            add_waiter_(seq);
+        }
+        wait_synced_(seq);
+    }
+
+    void set_pattern(const std::string &pattern) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        formatter_ = details::make_unique<spdlog::pattern_formatter>(pattern);
+    }
+
+    void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        formatter_ = std::move(sink_formatter);
+    }
+
+    void set_durable_level(level::level_enum log_level) {
+        durable_level_.store(log_level, std::memory_order_relaxed);
+    }
+
+    level::level_enum durable_level() const {
+        return static_cast<level::level_enum>(durable_level_.load(std::memory_order_relaxed));
+    }
+
+    // number of fdatasync calls done so far
+    size_t sync_count() {
+        std::lock_guard<std::mutex> lock(sync_mutex_);
+        return sync_count_;
+    }
+
+    const filename_t &filename() const { return file_helper_.filename(); }
+
+private:
+    // a failed sync of the messages in (from_seq, to_seq]
+    struct sync_failure {
+        uint64_t from_seq;
+        uint64_t to_seq;
+        std::string error;
+    };
+
+    // called with mutex_ locked, together with the write of seq, so that no sync can complete
+    // (and drop its failure) before the waiter is known. wait_synced_(seq) must follow.
+    void add_waiter_(uint64_t seq) {
+        std::lock_guard<std::mutex> lock(sync_mutex_);
+        waiters_.insert(seq);
+        if (seq > requested_seq_) {
+            requested_seq_ = seq;
+            sync_cv_.notify_one();
+        }
+    }
+
+    void wait_synced_(uint64_t seq) {
+        std::unique_lock<std::mutex> lock(sync_mutex_);
+        done_cv_.wait(lock, [this, seq] { return synced_seq_ >= seq; });
+        // the failed sync covering seq, if any
+        std::string error;
+        auto failed = std::lower_bound(
+            failures_.begin(), failures_.end(), seq,
+            [](const sync_failure &f, uint64_t s) { return f.to_seq < s; });
+        if (failed != failures_.end() && failed->from_seq < seq) {
+            error = failed->error;
+        }
+        // keep the failures only while a waiter they cover remains
+        waiters_.erase(waiters_.find(seq));
+        auto oldest_waiter =
+            waiters_.empty() ? (std::numeric_limits<uint64_t>::max)() : *waiters_.begin();
+        while (!failures_.empty() && failures_.front().to_seq < oldest_waiter) {
+            failures_.pop_front();
+        }
+        if (!error.empty()) {
+            throw_spdlog_ex(error);
+        }
+    }
+
+    // waiters in (synced_seq_, target] will throw instead of returning. called with sync_mutex_
+    // locked, before synced_seq_ is set to target.
+    void record_failure_(uint64_t target, std::string error) {
+        if (!failures_.empty() && failures_.back().to_seq == synced_seq_ &&
+            failures_.back().error == error) {
+            failures_.back().to_seq = target;
+            return;
+        }
+        failures_.push_back(sync_failure{synced_seq_, target, std::move(error)});
+    }
+
+    void sync_loop_() {
+        std::unique_lock<std::mutex> lock(sync_mutex_);
+        for (;;) {
+            sync_cv_.wait(lock, [this] { return stop_ || requested_seq_ > synced_seq_; });
+            if (stop_) {
+                return;
+            }
+            lock.unlock();
+
+            // sync everything written so far, not only what was requested,
+            // so threads that logged in the meantime share this sync.
+            uint64_t target = 0;
+            std::string error;
+            SPDLOG_TRY {
+                {
+                    std::lock_guard<std::mutex> write_lock(mutex_);
+                    target = written_seq_;
+                    file_helper_.flush();
+                }
+                file_helper_.sync_data();
+            }
+#ifndef SPDLOG_NO_EXCEPTIONS
+            catch (const std::exception &ex) {
+                error = ex.what();
+            }
+#endif
+
+            lock.lock();
+            sync_count_++;
+            if (!error.empty()) {
+                record_failure_(target, std::move(error));
+            }
+            synced_seq_ = target;
+            done_cv_.notify_all();
+
+            if (min_sync_interval_.count() > 0) {
+                sync_cv_.wait_for(lock, min_sync_interval_, [this] { return stop_; });
+            }
+        }
+    }
+
+    // protects formatter_, file_helper_ writes and written_seq_.
+    // locked before sync_mutex_ when both are needed.
+    std::mutex mutex_;
+    std::unique_ptr<spdlog::formatter> formatter_;
+    details::file_helper file_helper_;
+    uint64_t written_seq_ = 0;
+
+    // protects the sync state below
+    std::mutex sync_mutex_;
+    std::condition_variable sync_cv_;
+    std::condition_variable done_cv_;
+    uint64_t requested_seq_ = 0;
+    uint64_t synced_seq_ = 0;
+    std::multiset<uint64_t> waiters_;    // seqs of the threads in wait_synced_()
+    std::deque<sync_failure> failures_;  // ordered by seq
+    size_t sync_count_ = 0;
+    bool stop_ = false;
+
+    level_t durable_level_;
+    std::chrono::milliseconds min_sync_interval_;
+    std::thread sync_thread_;
+};
+
+}  // namespace sinks
+
+//
+// factory functions
+//
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> durable_logger_mt(
+    const std::string &logger_name,
+    const filename_t &filename,
+    level::level_enum durable_level = level::err,
+    std::chrono::milliseconds min_sync_interval = {},
+    bool truncate = false,
+    const file_event_handlers &event_handlers = {}) {
+    return Factory::template create<sinks::durable_file_sink>(
+        logger_name, filename, durable_level, min_sync_interval, truncate, event_handlers);
+}
+
+}  // namespace spdlog
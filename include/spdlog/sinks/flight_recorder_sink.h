@@ -0,0 +1,317 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifdef _WIN32
+    #error "flight_recorder_sink is not supported on windows"
+#endif
+
+#include <spdlog/common.h>
+#include <spdlog/details/log_msg.h>
+#include <spdlog/details/synchronous_factory.h>
+#include <spdlog/sinks/sink.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <signal.h>
+#include <string>
+#include <unistd.h>
+
+// Crash recorder: keeps the last messages of each thread in preallocated rings, and writes them
+// to a file descriptor when the process gets a fatal signal.
+//
+// Logging doesn't lock, allocate, format or make a system call: the logger name and the payload
+// are copied (truncated to max_message_size) into the next slot of the thread's ring. Each thread
+// gets a ring of its own, found by hashing its id. Once max_threads rings are taken, the other
+// threads share them, and a message is dropped (and counted) if its ring is being written by
+// another thread. The formatter of this sink is not used.
+//
+// dump() only uses write(2) on memory allocated by the constructor, so it can be called from a
+// signal handler. install_crash_handler() installs one for SIGSEGV, SIGABRT, SIGBUS, SIGFPE and
+// SIGILL that dumps the recorder, restores the previous handlers and raises the signal again.
+// The dump is best effort: a message being written while the process crashes may be garbled.
+//
+// Each message is written as "<seconds since epoch>.<microseconds> [<thread id>] [<level>]
+// [<logger name>] <payload>", the messages of each thread oldest first.
+//
+// Example:
+//
+//     auto recorder = std::make_shared<spdlog::sinks::flight_recorder_sink>();
+//     recorder->set_level(spdlog::level::trace);
+//     spdlog::default_logger()->sinks().push_back(recorder);
+//     spdlog::default_logger()->set_level(spdlog::level::trace);
+//     recorder->install_crash_handler(STDERR_FILENO);
+
+namespace spdlog {
+namespace sinks {
+
+struct flight_recorder_config {
+    size_t max_threads = 64;          // threads that get a ring of their own
+    size_t messages_per_thread = 64;  // messages kept per ring
+    size_t max_message_size = 256;    // logger name + payload bytes kept per message
+};
+
+class flight_recorder_sink final : public sink {
+public:
+    explicit flight_recorder_sink(flight_recorder_config config = flight_recorder_config())
+        : config_(config) {
+        if (config_.max_threads == 0 || config_.messages_per_thread == 0) {
+            throw_spdlog_ex(
+                "flight_recorder_sink: max_threads and messages_per_thread must be > 0");
+        }
+        slot_size_ = sizeof(record_header) + config_.max_message_size;
+        rings_.reset(new ring[config_.max_threads]);
+        slots_.reset(new char[config_.max_threads * config_.messages_per_thread * slot_size_]);
+        dump_buf_.reset(new char[dump_buf_size_()]);
+    }
+
+    flight_recorder_sink(const flight_recorder_sink &) = delete;
+    flight_recorder_sink &operator=(const flight_recorder_sink &) = delete;
+
+    ~flight_recorder_sink() override { uninstall_crash_handler(); }
+
+    void log(const details::log_msg &msg) override {
+        auto &r = ring_of_(msg.thread_id);
+        if (r.busy.exchange(true, std::memory_order_acquire)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        auto head = r.head.load(std::memory_order_relaxed);
+        char *slot = slot_(r, head);
+
+        record_header hdr;
+        hdr.time_ns = static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                               msg.time.time_since_epoch())
+                                               .count());
+        hdr.thread_id = static_cast<uint64_t>(msg.thread_id);
+        hdr.level = static_cast<uint32_t>(msg.level);
+        hdr.name_size = static_cast<uint32_t>(
+            (std::min)(msg.logger_name.size(), config_.max_message_size));
+        hdr.size = static_cast<uint32_t>(
+            (std::min)(msg.logger_name.size() + msg.payload.size(), config_.max_message_size));
+        std::memcpy(slot, &hdr, sizeof(hdr));
+        char *data = slot + sizeof(hdr);
+        std::memcpy(data, msg.logger_name.data(), hdr.name_size);
+        std::memcpy(data + hdr.name_size, msg.payload.data(), hdr.size - hdr.name_size);
+
+        r.head.store(head + 1, std::memory_order_release);
+        r.busy.store(false, std::memory_order_release);
+    }
+
+    void flush() override {}
+
+    void set_pattern(const std::string &) override {}
+
+    void set_formatter(std::unique_ptr<spdlog::formatter>) override {}
+
+    // messages dropped because their ring was being written by another thread
+    size_t dropped_messages() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // write the recorded messages to fd. async-signal-safe.
+    // returns false if another dump is in progress or write(2) failed.
+    bool dump(int fd) const {
+        if (dumping_.exchange(true, std::memory_order_acquire)) {
+            return false;
+        }
+        bool ok = true;
+        for (size_t i = 0; i < config_.max_threads && ok; i++) {
+            const auto &r = rings_[i];
+            auto head = r.head.load(std::memory_order_acquire);
+            auto n = static_cast<uint64_t>(config_.messages_per_thread);
+            for (auto seq = head > n ? head - n : 0; seq < head && ok; seq++) {
+                ok = write_record_(fd, slot_(r, seq));
+            }
+        }
+        dumping_.store(false, std::memory_order_release);
+        return ok;
+    }
+
+    // dump this recorder to fd (which must stay open) on fatal signals.
+    // only one recorder can be installed at a time: installing another one replaces it.
+    void install_crash_handler(int fd) {
+        auto &state = crash_state_();
+        state.fd.store(fd);
+        if (state.recorder.exchange(this) != nullptr) {
+            return;
+        }
+        struct sigaction action;
+        std::memset(&action, 0, sizeof(action));
+        action.sa_handler = &flight_recorder_sink::on_crash_;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_ONSTACK;
+        for (size_t i = 0; i < crash_state::n_signals; i++) {
+            ::sigaction(crash_state::signals()[i], &action, &state.previous[i]);
+        }
+    }
+
+    // restore the signal handlers, if this recorder is installed
+    void uninstall_crash_handler() {
+        auto &state = crash_state_();
+        flight_recorder_sink *expected = this;
+        if (state.recorder.compare_exchange_strong(expected, nullptr)) {
+            for (size_t i = 0; i < crash_state::n_signals; i++) {
+                ::sigaction(crash_state::signals()[i], &state.previous[i], nullptr);
+            }
+        }
+    }
+
+private:
+    struct record_header {
+        int64_t time_ns;
+        uint64_t thread_id;
+        uint32_t level;
+        uint32_t name_size;
+        uint32_t size;  // name_size + payload size
+    };
+
+    struct ring {
+        std::atomic<size_t> owner{0};  // thread id + 1 of the thread that took it, or 0
+        std::atomic<uint64_t> head{0};
+        std::atomic<bool> busy{false};
+    };
+
+    struct crash_state {
+        static constexpr size_t n_signals = 5;
+        static const int *signals() {
+            static const int sigs[n_signals] = {SIGSEGV, SIGABRT, SIGBUS, SIGFPE, SIGILL};
+            return sigs;
+        }
+        std::atomic<flight_recorder_sink *> recorder{nullptr};
+        std::atomic<int> fd{-1};
+        struct sigaction previous[n_signals];
+    };
+
+    static crash_state &crash_state_() {
+        static crash_state state;
+        return state;
+    }
+
+    static void on_crash_(int sig) {
+        auto &state = crash_state_();
+        auto *recorder = state.recorder.exchange(nullptr);
+        if (recorder != nullptr) {
+            recorder->dump(state.fd.load());
+            for (size_t i = 0; i < crash_state::n_signals; i++) {
+                ::sigaction(crash_state::signals()[i], &state.previous[i], nullptr);
+            }
+        }
+        ::raise(sig);
+    }
+
+    // the ring of the thread: the first free or owned one of a few, starting at its hash
+    ring &ring_of_(size_t thread_id) {
+        static constexpr size_t max_probes = 8;
+        auto key = thread_id + 1;
+        auto start = static_cast<size_t>(thread_id % config_.max_threads);
+        auto probes = (std::min)(max_probes, config_.max_threads);
+        for (size_t i = 0; i < probes; i++) {
+            auto &r = rings_[(start + i) % config_.max_threads];
+            auto owner = r.owner.load(std::memory_order_relaxed);
+            if (owner == key) {
+                return r;
+            }
+            if (owner == 0 && r.owner.compare_exchange_strong(owner, key,
+                                                              std::memory_order_relaxed)) {
+                return r;
+            }
+        }
+        return rings_[start];
+    }
+
+    char *slot_(const ring &r, uint64_t seq) const {
+        auto ring_index = static_cast<size_t>(&r - rings_.get());
+        auto slot_index = static_cast<size_t>(seq % config_.messages_per_thread);
+        return slots_.get() +
+               (ring_index * config_.messages_per_thread + slot_index) * slot_size_;
+    }
+
+    size_t dump_buf_size_() const { return config_.max_message_size + 128; }
+
+    static void append_(char *&pos, const char *data, size_t size) {
+        std::memcpy(pos, data, size);
+        pos += size;
+    }
+
+    static void append_uint_(char *&pos, uint64_t n, int min_digits = 1) {
+        char digits[20];
+        int count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + n % 10);
+            n /= 10;
+        } while (n != 0 || count < min_digits);
+        while (count > 0) {
+            *pos++ = digits[--count];
+        }
+    }
+
+    static bool write_all_(int fd, const char *data, size_t size) {
+        while (size > 0) {
+            auto written = ::write(fd, data, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    bool write_record_(int fd, const char *slot) const {
+        record_header hdr;
+        std::memcpy(&hdr, slot, sizeof(hdr));
+        // the record may be garbled if its thread crashed while writing it
+        auto size = (std::min)(static_cast<size_t>(hdr.size), config_.max_message_size);
+        auto name_size = (std::min)(static_cast<size_t>(hdr.name_size), size);
+        const char *data = slot + sizeof(hdr);
+
+        char *pos = dump_buf_.get();
+        auto time_us = static_cast<uint64_t>(hdr.time_ns < 0 ? 0 : hdr.time_ns / 1000);
+        append_uint_(pos, time_us / 1000000);
+        *pos++ = '.';
+        append_uint_(pos, time_us % 1000000, 6);
+        append_(pos, " [", 2);
+        append_uint_(pos, hdr.thread_id);
+        append_(pos, "] [", 3);
+        auto lvl = hdr.level < level::n_levels ? static_cast<level::level_enum>(hdr.level)
+                                               : level::off;
+        auto level_name = level::to_string_view(lvl);
+        append_(pos, level_name.data(), level_name.size());
+        append_(pos, "] [", 3);
+        append_(pos, data, name_size);
+        append_(pos, "] ", 2);
+        append_(pos, data + name_size, size - name_size);
+        *pos++ = '\n';
+        return write_all_(fd, dump_buf_.get(), static_cast<size_t>(pos - dump_buf_.get()));
+    }
+
+    flight_recorder_config config_;
+    size_t slot_size_;
+    std::unique_ptr<ring[]> rings_;
+    std::unique_ptr<char[]> slots_;
+    std::unique_ptr<char[]> dump_buf_;
+    mutable std::atomic<bool> dumping_{false};
+    std::atomic<size_t> dropped_{0};
+};
+
+}  // namespace sinks
+
+//
+// factory functions
+//
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> flight_recorder_logger_mt(
+    const std::string &logger_name,
+    sinks::flight_recorder_config config = sinks::flight_recorder_config()) {
+    return Factory::template create<sinks::flight_recorder_sink>(logger_name, config);
+}
+
+}  // namespace spdlog
@@ -0,0 +1,272 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+//
+// Ring buffer sink that keeps the last capacity bytes of formatted messages, e.g. to serve
+// "the last 64MB of logs" from a diagnostic endpoint without slowing down the logging threads.
+//
+// Unlike ringbuffer_sink, messages are formatted once, when logged, and stored back to back in
+// a single preallocated byte ring. Writers reserve their space with an atomic fetch_add and
+// never wait for readers; the oldest messages are overwritten. Formatting uses one shard (a
+// formatter and its buffer, under a mutex) per hardware thread, like sharded_file_sink. Threads
+// are spread over the shards, so they wait for each other only when more threads than
+// hardware_concurrency() log to the sink.
+//
+// Each record is an 8 byte commit word (size and position, set when the message is copied)
+// followed by the formatted message, padded to 8 bytes. The reader walks the records from the
+// oldest one it can find and stops at the first one not committed yet. The first record of each
+// of the 64 blocks of the ring is tracked, so the walk can start at a record boundary.
+//
+// A writer that was lapped (its space reserved again by newer messages) while copying doesn't
+// commit its message, and counts it as dropped. Each shard publishes the position its writer
+// is copying to, and lapped writers are counted, so the reader can tell when such a writer may
+// have written over the messages it read.
+//
+// read() passes views into the ring itself, without copying. Writers may overwrite them while
+// they are being read: read() returns false in that case, and the data seen should be discarded.
+// last_formatted() copies the messages, and retries if they were overwritten.
+//
+// Example:
+//
+//     auto ring = std::make_shared<spdlog::sinks::formatted_ringbuffer_sink>(64 * 1024 * 1024);
+//     logger->sinks().push_back(ring);
+//     ...
+//     // diagnostic endpoint
+//     bool valid = ring->read([&](spdlog::string_view_t first, spdlog::string_view_t second) {
+//         response.append(first.data(), first.size());
+//         response.append(second.data(), second.size());
+//     });
+//
+
+#include <spdlog/common.h>
+#include <spdlog/details/log_msg.h>
+#include <spdlog/details/thread_shard.h>
+#include <spdlog/pattern_formatter.h>
+#include <spdlog/sinks/sink.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace spdlog {
+namespace sinks {
+
+class formatted_ringbuffer_sink final : public sink {
+public:
+    // capacity is rounded up to a multiple of 512 bytes
+    explicit formatted_ringbuffer_sink(size_t capacity)
+        : capacity_{(capacity + block_align - 1) / block_align * block_align},
+          block_size_{capacity_ / n_blocks},
+          data_(new char[capacity_]),
+          commits_(new std::atomic<uint64_t>[capacity_ / 8]),
+          shard_map_{std::thread::hardware_concurrency()} {
+        if (capacity_ == 0) {
+            throw_spdlog_ex("formatted_ringbuffer_sink: capacity must be > 0");
+        }
+        for (size_t i = 0; i < capacity_ / 8; i++) {
+            commits_[i].store(0, std::memory_order_relaxed);
+        }
+        for (auto &first : block_first_) {
+            first.store(0, std::memory_order_relaxed);
+        }
+        shards_.reserve(shard_map_.n_shards());
+        for (size_t i = 0; i < shard_map_.n_shards(); i++) {
+            shards_.emplace_back(new shard());
+        }
+    }
+
+    formatted_ringbuffer_sink(const formatted_ringbuffer_sink &) = delete;
+    formatted_ringbuffer_sink &operator=(const formatted_ringbuffer_sink &) = delete;
+
+    void log(const details::log_msg &msg) override {
+        auto &s = current_shard_();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.formatted.clear();
+        s.formatter->format(msg, s.formatted);
+        write_(s, string_view_t(s.formatted.data(), s.formatted.size()));
+    }
+
+    void flush() override {}
+
+    void set_pattern(const std::string &pattern) override {
+        set_formatter(details::make_unique<spdlog::pattern_formatter>(pattern));
+    }
+
+    void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override {
+        for (auto &s : shards_) {
+            std::lock_guard<std::mutex> lock(s->mutex);
+            s->formatter = sink_formatter->clone();
+        }
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    // messages that didn't fit in the ring, or were overwritten before they were copied
+    size_t dropped_messages() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // call f(string_view_t first, string_view_t second) for each message in the ring, oldest
+    // first. second is empty unless the message wraps around the end of the ring.
+    // returns false if some of the messages were overwritten while f was called.
+    template <typename F>
+    bool read(F &&f) const {
+        auto lapped = lapped_writes_.load();
+        auto head = write_pos_.load(std::memory_order_acquire);
+        auto start = oldest_record_(head);
+        auto pos = start;
+        while (pos < head) {
+            auto commit = commits_[(pos % capacity_) / 8].load(std::memory_order_acquire);
+            if (commit != commit_word_(pos, static_cast<size_t>(commit >> 32))) {
+                // not committed yet, or already overwritten by a newer record
+                break;
+            }
+            auto size = static_cast<size_t>(commit >> 32);
+            auto offset = static_cast<size_t>((pos + 8) % capacity_);
+            auto first_size = (std::min)(size, capacity_ - offset);
+            f(string_view_t(data_.get() + offset, first_size),
+              string_view_t(data_.get(), size - first_size));
+            pos += record_size_(size);
+        }
+        if (write_pos_.load() > start + capacity_) {
+            return false;
+        }
+        // a writer copying to a position before start may have been lapped, and written over
+        // the messages read
+        for (const auto &s : shards_) {
+            if (s->writing.load() < start) {
+                return false;
+            }
+        }
+        return lapped_writes_.load() == lapped;
+    }
+
+    // copy the last lim messages (all if lim is 0)
+    std::vector<std::string> last_formatted(size_t lim = 0) const {
+        std::vector<std::string> messages;
+        for (int attempt = 0; attempt < 3; attempt++) {
+            messages.clear();
+            bool valid = read([&messages](string_view_t first, string_view_t second) {
+                messages.emplace_back(first.data(), first.size());
+                messages.back().append(second.data(), second.size());
+            });
+            if (valid) {
+                break;
+            }
+        }
+        if (lim > 0 && messages.size() > lim) {
+            messages.erase(messages.begin(),
+                           messages.end() - static_cast<std::ptrdiff_t>(lim));
+        }
+        return messages;
+    }
+
+private:
+    static constexpr size_t n_blocks = 64;
+    static constexpr size_t block_align = n_blocks * 8;
+
+    static constexpr uint64_t not_writing = UINT64_MAX;
+
+    struct shard {
+        std::mutex mutex;
+        std::unique_ptr<spdlog::formatter> formatter{
+            details::make_unique<spdlog::pattern_formatter>()};
+        memory_buf_t formatted;
+        // position of the record being copied (or a lower bound of it), or not_writing
+        std::atomic<uint64_t> writing{not_writing};
+    };
+
+    static uint64_t record_size_(size_t size) { return 8 + (uint64_t{size} + 7) / 8 * 8; }
+
+    // size (32 bits) | position / 8 (31 bits) | committed bit
+    static uint64_t commit_word_(uint64_t pos, size_t size) {
+        return (uint64_t{size} << 32) | (((pos / 8) & 0x7fffffff) << 1) | 1;
+    }
+
+    // called with s.mutex locked
+    void write_(shard &s, string_view_t formatted) {
+        auto n = record_size_(formatted.size());
+        if (n > capacity_ || formatted.size() > UINT32_MAX) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // publish a lower bound of the position before reserving it, so read() never misses
+        // this writer (seq_cst, like the loads in read())
+        s.writing.store(write_pos_.load(std::memory_order_relaxed));
+        auto pos = write_pos_.fetch_add(n);
+        s.writing.store(pos);
+        track_block_first_(pos, pos + n);
+
+        auto offset = static_cast<size_t>((pos + 8) % capacity_);
+        auto first_size = (std::min)(formatted.size(), capacity_ - offset);
+        std::memcpy(data_.get() + offset, formatted.data(), first_size);
+        std::memcpy(data_.get(), formatted.data() + first_size, formatted.size() - first_size);
+
+        // the commit word of a previous lap doesn't match pos, so the record stays invisible
+        // until committed. if the space was reserved again while copying, the message is
+        // dropped, and the commit word (maybe a newer one) is left alone.
+        auto &commit = commits_[(pos % capacity_) / 8];
+        auto current = commit.load(std::memory_order_acquire);
+        if (write_pos_.load() > pos + capacity_ ||
+            !commit.compare_exchange_strong(current, commit_word_(pos, formatted.size()),
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+            lapped_writes_.fetch_add(1);
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+        s.writing.store(not_writing);
+    }
+
+    // record, for each block boundary in [begin, end), the first record starting at or after it
+    void track_block_first_(uint64_t begin, uint64_t end) {
+        auto boundary = (begin + block_size_ - 1) / block_size_ * block_size_;
+        for (; boundary < end; boundary += block_size_) {
+            auto first = boundary == begin ? begin : end;
+            auto &slot = block_first_[(boundary / block_size_) % n_blocks];
+            auto current = slot.load(std::memory_order_relaxed);
+            while (current < first &&
+                   !slot.compare_exchange_weak(current, first, std::memory_order_release,
+                                               std::memory_order_relaxed)) {
+            }
+        }
+    }
+
+    // position of the oldest record boundary that was not overwritten
+    uint64_t oldest_record_(uint64_t head) const {
+        if (head <= capacity_) {
+            return 0;
+        }
+        auto low = head - capacity_;
+        auto oldest = head;
+        for (const auto &slot : block_first_) {
+            auto first = slot.load(std::memory_order_acquire);
+            if (first >= low && first < oldest) {
+                oldest = first;
+            }
+        }
+        return oldest;
+    }
+
+    // threads are assigned to shards round robin, in the order they first log to this sink
+    shard &current_shard_() { return *shards_[shard_map_.shard()]; }
+
+    const size_t capacity_;
+    const size_t block_size_;
+    std::unique_ptr<char[]> data_;
+    std::unique_ptr<std::atomic<uint64_t>[]> commits_;  // commit word of a record at each 8 bytes
+    std::atomic<uint64_t> block_first_[n_blocks];
+    std::atomic<uint64_t> write_pos_{0};
+    std::atomic<size_t> dropped_{0};
+    std::atomic<uint64_t> lapped_writes_{0};
+    details::thread_shard_map shard_map_;
+    std::vector<std::unique_ptr<shard>> shards_;
+};
+
+}  // namespace sinks
+}  // namespace spdlog
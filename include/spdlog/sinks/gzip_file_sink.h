@@ -0,0 +1,133 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+//
+// File sinks that write gzip compressed output.
+// Requires zlib (https://zlib.net) - link with -lz.
+//
+// Messages are compressed synchronously, by the logging thread under the sink mutex. Rotated
+// files are not compressed afterwards: with the rotating variant every file is gzip already.
+//
+// The file is a valid gzip stream up to the last flush (each flush ends a gzip member),
+// so use flush_on()/flush_every() to bound how much could be lost on a crash.
+// The rotating variant applies max_size to the compressed file size, and may rotate up to
+// max_size / 16 bytes early (see gzip_file_helper::would_exceed).
+//
+// Example:
+//
+//     #include <spdlog/sinks/gzip_file_sink.h>
+//
+//     auto logger = spdlog::rotating_gzip_logger_mt("gz", "logs/app.log.gz", 1024 * 1024 * 5, 3);
+//     logger->info("Hello");
+//     // zcat logs/app.log.gz
+//
+
+#include <spdlog/details/gzip_file_helper.h>
+#include <spdlog/details/null_mutex.h>
+#include <spdlog/details/synchronous_factory.h>
+#include <spdlog/sinks/basic_file_sink.h>
+#include <spdlog/sinks/daily_file_sink.h>
+#include <spdlog/sinks/rotating_file_sink.h>
+
+#ifndef SPDLOG_HEADER_ONLY
+    // the compiled lib only instantiates the sinks with the default file_helper
+    #include <spdlog/sinks/basic_file_sink-inl.h>
+    #include <spdlog/sinks/rotating_file_sink-inl.h>
+#endif
+
+#include <mutex>
+#include <string>
+
+namespace spdlog {
+namespace sinks {
+
+using basic_gzip_file_sink_mt = basic_file_sink<std::mutex, details::gzip_file_helper>;
+using basic_gzip_file_sink_st = basic_file_sink<details::null_mutex, details::gzip_file_helper>;
+
+using rotating_gzip_file_sink_mt = rotating_file_sink<std::mutex, details::gzip_file_helper>;
+using rotating_gzip_file_sink_st =
+    rotating_file_sink<details::null_mutex, details::gzip_file_helper>;
+
+using daily_gzip_file_sink_mt =
+    daily_file_sink<std::mutex, daily_filename_calculator, details::gzip_file_helper>;
+using daily_gzip_file_sink_st =
+    daily_file_sink<details::null_mutex, daily_filename_calculator, details::gzip_file_helper>;
+
+}  // namespace sinks
+
+//
+// factory functions
+//
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> basic_gzip_logger_mt(
+    const std::string &logger_name,
+    const filename_t &filename,
+    bool truncate = false,
+    const file_event_handlers &event_handlers = {}) {
+    return Factory::template create<sinks::basic_gzip_file_sink_mt>(logger_name, filename, truncate,
+                                                                    event_handlers);
+}
+
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> basic_gzip_logger_st(
+    const std::string &logger_name,
+    const filename_t &filename,
+    bool truncate = false,
+    const file_event_handlers &event_handlers = {}) {
+    return Factory::template create<sinks::basic_gzip_file_sink_st>(logger_name, filename, truncate,
+                                                                    event_handlers);
+}
+
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> rotating_gzip_logger_mt(
+    const std::string &logger_name,
+    const filename_t &filename,
+    size_t max_file_size,
+    size_t max_files,
+    bool rotate_on_open = false,
+    const file_event_handlers &event_handlers = {}) {
+    return Factory::template create<sinks::rotating_gzip_file_sink_mt>(
+        logger_name, filename, max_file_size, max_files, rotate_on_open, event_handlers);
+}
+
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> rotating_gzip_logger_st(
+    const std::string &logger_name,
+    const filename_t &filename,
+    size_t max_file_size,
+    size_t max_files,
+    bool rotate_on_open = false,
+    const file_event_handlers &event_handlers = {}) {
+    return Factory::template create<sinks::rotating_gzip_file_sink_st>(
+        logger_name, filename, max_file_size, max_files, rotate_on_open, event_handlers);
+}
+
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> daily_gzip_logger_mt(
+    const std::string &logger_name,
+    const filename_t &filename,
+    int hour = 0,
+    int minute = 0,
+    bool truncate = false,
+    uint16_t max_files = 0,
+    const file_event_handlers &event_handlers = {}) {
+    return Factory::template create<sinks::daily_gzip_file_sink_mt>(
+        logger_name, filename, hour, minute, truncate, max_files, event_handlers);
+}
+
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> daily_gzip_logger_st(
+    const std::string &logger_name,
+    const filename_t &filename,
+    int hour = 0,
+    int minute = 0,
+    bool truncate = false,
+    uint16_t max_files = 0,
+    const file_event_handlers &event_handlers = {}) {
+    return Factory::template create<sinks::daily_gzip_file_sink_st>(
+        logger_name, filename, hour, minute, truncate, max_files, event_handlers);
+}
+
+}  // namespace spdlog
@@ -0,0 +1,292 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <spdlog/common.h>
+#include <spdlog/details/file_helper.h>
+#include <spdlog/details/null_mutex.h>
+#include <spdlog/details/os.h>
+#include <spdlog/details/synchronous_factory.h>
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/sinks/base_sink.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <ctime>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+namespace spdlog {
+namespace sinks {
+
+/*
+ * Rotating file sink based on size and time, with a limit on the total disk usage.
+ *
+ * The current file is rotated (log.txt -> log.1.txt -> log.2.txt ..) when it would exceed
+ * max_size, or when a message is logged at or after the next rotation time. Rotation times are
+ * multiples of rotation_interval since local midnight (e.g. 1h rotates at every full hour), or
+ * rotation_interval apart if it is longer than a day.
+ * After each rotation, the oldest files are deleted so that at most max_files rotated files are
+ * kept, and so that their total size doesn't exceed max_total_size (less max_size, to leave
+ * room for the current file, if max_size is set and smaller than max_total_size).
+ *
+ * max_size, rotation_interval and max_total_size can be 0 to disable the limit.
+ *
+ * The next rotation time is computed only when rotating, so the per message check is a
+ * single integer compare.
+ */
+template <typename Mutex, typename FileHelper = details::file_helper>
+class hybrid_rotating_file_sink final : public base_sink<Mutex> {
+public:
+    hybrid_rotating_file_sink(filename_t base_filename,
+                              std::size_t max_size,
+                              std::chrono::seconds rotation_interval,
+                              std::size_t max_files,
+                              std::size_t max_total_size = 0,
+                              bool rotate_on_open = false,
+                              const file_event_handlers &event_handlers = {})
+        : base_filename_(std::move(base_filename)),
+          max_size_(max_size > 0 ? max_size : (std::numeric_limits<std::size_t>::max)()),
+          rotation_interval_(rotation_interval),
+          max_files_(max_files),
+          max_total_size_(max_total_size),
+          file_helper_{event_handlers} {
+        if (max_files > 200000) {
+            throw_spdlog_ex("hybrid rotating sink constructor: max_files arg cannot exceed 200000");
+        }
+        init_rotated_sizes_();
+        file_helper_.open(calc_filename(base_filename_, 0));
+        current_size_ = file_helper_.size();  // expensive. called only once
+        if (rotate_on_open && current_size_ > 0) {
+            rotate_();
+            current_size_ = 0;
+        }
+        rotation_deadline_ = next_deadline_(log_clock::now());
+    }
+
+    // calc filename according to index and file extension if exists.
+    // e.g. calc_filename("logs/mylog.txt, 3) => "logs/mylog.3.txt".
+    static filename_t calc_filename(const filename_t &filename, std::size_t index) {
+        if (index == 0u) {
+            return filename;
+        }
+
+        filename_t basename, ext;
+        std::tie(basename, ext) = details::file_helper::split_by_extension(filename);
+        return fmt_lib::format(SPDLOG_FMT_STRING(SPDLOG_FILENAME_T("{}.{}{}")), basename, index,
+                               ext);
+    }
+
+    filename_t filename() {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+        return file_helper_.filename();
+    }
+
+protected:
+    void sink_it_(const details::log_msg &msg) override {
+        if (msg.time.time_since_epoch().count() >= rotation_deadline_) {
+            if (current_size_ > 0) {
+                rotate_();
+                current_size_ = 0;
+            }
+            rotation_deadline_ = next_deadline_(msg.time);
+        }
+
+        memory_buf_t formatted;
+        base_sink<Mutex>::formatter_->format(msg, formatted);
+        auto new_size = current_size_ + formatted.size();
+
+        // same as rotating_file_sink: rotate only if the real size > 0.
+        if (new_size > max_size_ &&
+            details::would_exceed(file_helper_, max_size_, formatted.size())) {
+            file_helper_.flush();
+            if (file_helper_.size() > 0) {
+                rotate_();
+                new_size = formatted.size();
+            }
+        }
+        file_helper_.write(formatted);
+        current_size_ = new_size;
+    }
+
+    void flush_() override { file_helper_.flush(); }
+
+private:
+    using deadline_t = log_clock::rep;
+
+    // the first rotation time after tp.
+    // uses localtime/mktime, so it is called only on construction and rotation.
+    deadline_t next_deadline_(log_clock::time_point tp) {
+        if (rotation_interval_.count() <= 0) {
+            return (std::numeric_limits<deadline_t>::max)();
+        }
+        auto interval = std::chrono::duration_cast<log_clock::duration>(rotation_interval_);
+        if (rotation_interval_ > std::chrono::hours(24)) {
+            return (tp + interval).time_since_epoch().count();
+        }
+        tm date = details::os::localtime(log_clock::to_time_t(tp));
+        date.tm_hour = 0;
+        date.tm_min = 0;
+        date.tm_sec = 0;
+        auto midnight = log_clock::from_time_t(std::mktime(&date));
+        auto n_intervals = (tp - midnight) / interval + 1;
+        return (midnight + n_intervals * interval).time_since_epoch().count();
+    }
+
+    // sizes of the rotated files that exist on disk, starting with log.1.txt
+    void init_rotated_sizes_() {
+        for (std::size_t i = 1; i <= max_files_; i++) {
+            auto filename = calc_filename(base_filename_, i);
+            if (!details::os::path_exists(filename)) {
+                break;
+            }
+            details::file_helper helper;
+            helper.open(filename);
+            rotated_sizes_.push_back(helper.size());
+            rotated_total_ += rotated_sizes_.back();
+        }
+    }
+
+    // Rotate files:
+    // log.txt -> log.1.txt
+    // log.1.txt -> log.2.txt
+    // log.2.txt -> log.3.txt
+    // log.3.txt -> delete
+    // then delete the oldest files that exceed max_total_size_.
+    void rotate_() {
+        using details::os::filename_to_str;
+        using details::os::path_exists;
+
+        file_helper_.flush();
+        auto rotated_size = file_helper_.size();
+        file_helper_.close();
+        for (auto i = max_files_; i > 0; --i) {
+            filename_t src = calc_filename(base_filename_, i - 1);
+            if (!path_exists(src)) {
+                continue;
+            }
+            filename_t target = calc_filename(base_filename_, i);
+
+            if (!rename_file_(src, target)) {
+                // if failed try again after a small delay.
+                // this is a workaround to a windows issue, where very high rotation rates
+                // can cause the rename to fail with permission denied (because of antivirus?).
+                details::os::sleep_for_millis(100);
+                if (!rename_file_(src, target)) {
+                    // truncate the log file anyway to prevent it to grow beyond its limit!
+                    file_helper_.reopen(true);
+                    current_size_ = 0;
+                    // the files from index i on were renamed already, and i is now missing
+                    shift_rotated_sizes_(i, 0);
+                    throw_spdlog_ex("hybrid_rotating_file_sink: failed renaming " +
+                                        filename_to_str(src) + " to " + filename_to_str(target),
+                                    errno);
+                }
+            }
+        }
+        file_helper_.reopen(true);
+        shift_rotated_sizes_(1, rotated_size);
+        delete_over_total_size_();
+    }
+
+    // the rotated files from index on were renamed to the next index, and the file at index now
+    // has the given size (0 if missing).
+    void shift_rotated_sizes_(std::size_t index, std::size_t size) {
+        if (max_files_ == 0) {
+            return;
+        }
+        while (rotated_sizes_.size() < index - 1) {
+            rotated_sizes_.push_back(0);
+        }
+        rotated_sizes_.insert(rotated_sizes_.begin() + static_cast<std::ptrdiff_t>(index - 1),
+                              size);
+        rotated_total_ += size;
+        if (rotated_sizes_.size() > max_files_) {
+            // the oldest file was overwritten by the rename
+            rotated_total_ -= rotated_sizes_.back();
+            rotated_sizes_.pop_back();
+        }
+    }
+
+    void delete_over_total_size_() {
+        if (max_total_size_ == 0) {
+            return;
+        }
+        // room for the current file, which was just created. with no size limit (e.g. time only
+        // rotation) its size can't be known in advance.
+        auto reserved = max_size_ < max_total_size_ ? max_size_ : 0;
+        while (!rotated_sizes_.empty() && rotated_total_ + reserved > max_total_size_) {
+            auto oldest = calc_filename(base_filename_, rotated_sizes_.size());
+            if (details::os::remove_if_exists(oldest) != 0) {
+                throw_spdlog_ex("hybrid_rotating_file_sink: failed removing " +
+                                    details::os::filename_to_str(oldest),
+                                errno);
+            }
+            rotated_total_ -= rotated_sizes_.back();
+            rotated_sizes_.pop_back();
+        }
+    }
+
+    // delete the target if exists, and rename the src file  to target
+    // return true on success, false otherwise.
+    bool rename_file_(const filename_t &src_filename, const filename_t &target_filename) {
+        (void)details::os::remove(target_filename);
+        return details::os::rename(src_filename, target_filename) == 0;
+    }
+
+    filename_t base_filename_;
+    std::size_t max_size_;
+    std::chrono::seconds rotation_interval_;
+    std::size_t max_files_;
+    std::size_t max_total_size_;
+    std::size_t current_size_ = 0;
+    deadline_t rotation_deadline_ = 0;
+    std::deque<std::size_t> rotated_sizes_;
+    std::size_t rotated_total_ = 0;
+    FileHelper file_helper_;
+};
+
+using hybrid_rotating_file_sink_mt = hybrid_rotating_file_sink<std::mutex>;
+using hybrid_rotating_file_sink_st = hybrid_rotating_file_sink<details::null_mutex>;
+
+}  // namespace sinks
+
+//
+// factory functions
+//
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> hybrid_rotating_logger_mt(
+    const std::string &logger_name,
+    const filename_t &filename,
+    size_t max_file_size,
+    std::chrono::seconds rotation_interval,
+    size_t max_files,
+    size_t max_total_size = 0,
+    bool rotate_on_open = false,
+    const file_event_handlers &event_handlers = {}) {
+    return Factory::template create<sinks::hybrid_rotating_file_sink_mt>(
+        logger_name, filename, max_file_size, rotation_interval, max_files, max_total_size,
+        rotate_on_open, event_handlers);
+}
+
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> hybrid_rotating_logger_st(
+    const std::string &logger_name,
+    const filename_t &filename,
+    size_t max_file_size,
+    std::chrono::seconds rotation_interval,
+    size_t max_files,
+    size_t max_total_size = 0,
+    bool rotate_on_open = false,
+    const file_event_handlers &event_handlers = {}) {
+    return Factory::template create<sinks::hybrid_rotating_file_sink_st>(
+        logger_name, filename, max_file_size, rotation_interval, max_files, max_total_size,
+        rotate_on_open, event_handlers);
+}
+
+}  // namespace spdlog
@@ -0,0 +1,372 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifdef _WIN32
+    #error "native_syslog_sink is not supported on windows"
+#endif
+
+#include <spdlog/common.h>
+#include <spdlog/details/datagram_batch.h>
+#include <spdlog/details/fmt_helper.h>
+#include <spdlog/details/null_mutex.h>
+#include <spdlog/details/os.h>
+#include <spdlog/details/synchronous_factory.h>
+#include <spdlog/details/udp_client.h>
+#include <spdlog/pattern_formatter.h>
+#include <spdlog/sinks/base_sink.h>
+#include <spdlog/sinks/buffered_tcp_sink.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <syslog.h>
+#include <unistd.h>
+
+// Sink that writes syslog records directly to a socket, without going through libc syslog().
+//
+// Records are in RFC5424 or RFC3164 format, sent to a unix datagram socket (/dev/log by default)
+// or over udp/tcp to a syslog relay. Over tcp, records are framed using octet counting (RFC6587).
+// The parts of the header that don't change between messages (priority, hostname, app name,
+// pid) are rendered once, and the timestamp is rendered once per second.
+//
+// If batch_max_messages > 1, unix and udp records are collected and sent together (with sendmmsg
+// where available) when the batch is full or on flush().
+// Over tcp, records are sent by a background thread, like buffered_tcp_sink: logging doesn't
+// block on the connection, and the records that accumulate while a send is in progress or while
+// reconnecting go out together.
+//
+// Example:
+//
+//     #include <spdlog/sinks/native_syslog_sink.h>
+//
+//     spdlog::sinks::native_syslog_sink_config config;
+//     config.ident = "myapp";
+//     auto logger = spdlog::native_syslog_logger_mt("syslog", config);
+
+namespace spdlog {
+namespace sinks {
+
+enum class syslog_format { rfc3164, rfc5424 };
+
+enum class syslog_transport { unix_dgram, udp, tcp };
+
+struct native_syslog_sink_config {
+    syslog_transport transport = syslog_transport::unix_dgram;
+    std::string address = "/dev/log";  // socket path for unix_dgram, host for udp/tcp
+    uint16_t port = 514;               // udp/tcp port
+    syslog_format format = syslog_format::rfc3164;
+    std::string ident;               // app name. the logger name is used if empty
+    int facility = LOG_USER;         // LOG_USER, LOG_LOCAL0, ..
+    std::string hostname;            // gethostname() if empty
+    bool enable_formatting = false;  // send the formatted message instead of the payload
+    size_t batch_max_messages = 0;   // 0 or 1 to send each record as it is logged (unix, udp)
+    size_t tcp_buffer_size = 1024 * 1024;  // max bytes waiting to be sent (tcp)
+    async_overflow_policy tcp_overflow_policy = async_overflow_policy::discard_new;
+};
+
+template <typename Mutex>
+class native_syslog_sink : public base_sink<Mutex> {
+public:
+    explicit native_syslog_sink(native_syslog_sink_config config = {})
+        : config_{std::move(config)} {
+        static const std::array<int, 7> syslog_levels{{/* trace    */ LOG_DEBUG,
+                                                       /* debug    */ LOG_DEBUG,
+                                                       /* info     */ LOG_INFO,
+                                                       /* warn     */ LOG_WARNING,
+                                                       /* err      */ LOG_ERR,
+                                                       /* critical */ LOG_CRIT,
+                                                       /* off      */ LOG_INFO}};
+        for (size_t i = 0; i < syslog_levels.size(); i++) {
+            auto pri = (config_.facility & LOG_FACMASK) | syslog_levels[i];
+            priorities_[i] = config_.format == syslog_format::rfc5424
+                                 ? fmt_lib::format("<{}>1 ", pri)
+                                 : fmt_lib::format("<{}>", pri);
+        }
+
+        if (config_.hostname.empty()) {
+            char hostname[256] = {};
+            if (::gethostname(hostname, sizeof(hostname) - 1) == 0 && hostname[0] != '\0') {
+                config_.hostname = hostname;
+            } else {
+                config_.hostname = "-";
+            }
+        }
+        pid_ = std::to_string(details::os::pid());
+        connect_();
+    }
+
+    native_syslog_sink(const native_syslog_sink &) = delete;
+    native_syslog_sink &operator=(const native_syslog_sink &) = delete;
+
+    ~native_syslog_sink() override {
+        SPDLOG_TRY {
+            std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+            send_batch_();
+        }
+        SPDLOG_CATCH_STD
+        if (unix_fd_ != -1) {
+            ::close(unix_fd_);
+        }
+    }
+
+    // the tcp sender, to check its counters (null unless the transport is tcp)
+    const buffered_tcp_sink_st *tcp_sink() const { return tcp_sink_.get(); }
+
+protected:
+    void sink_it_(const details::log_msg &msg) override {
+        if (tcp_sink_) {
+            // octet counting framing: "<length> <record>", passed as is to the tcp sink
+            record_.clear();
+            format_record_(msg, record_);
+            frame_.clear();
+            details::fmt_helper::append_int(record_.size(), frame_);
+            frame_.push_back(' ');
+            frame_.append(record_.data(), record_.data() + record_.size());
+            auto framed = msg;
+            framed.payload = string_view_t(frame_.data(), frame_.size());
+            tcp_sink_->log(framed);
+            return;
+        }
+
+        auto start = batch_.data.size();
+        format_record_(msg, batch_.data);
+        batch_.end_datagram(start);
+        if (batch_.count() >= config_.batch_max_messages) {
+            send_batch_();
+        }
+    }
+
+    void flush_() override {
+        if (tcp_sink_) {
+            tcp_sink_->flush();
+        } else {
+            send_batch_();
+        }
+    }
+
+private:
+    // <PRI>1 TIMESTAMP HOSTNAME APP-NAME PROCID - - MSG (rfc5424), or
+    // <PRI>TIMESTAMP HOSTNAME APP-NAME[PROCID]: MSG (rfc3164)
+    void format_record_(const details::log_msg &msg, memory_buf_t &dest) {
+        using details::fmt_helper::append_string_view;
+        append_string_view(priorities_[static_cast<size_t>(msg.level)], dest);
+        append_timestamp_(msg.time, dest);
+        dest.push_back(' ');
+        append_string_view(config_.hostname, dest);
+        dest.push_back(' ');
+        if (!config_.ident.empty()) {
+            append_string_view(config_.ident, dest);
+        } else if (msg.logger_name.size() > 0) {
+            append_string_view(msg.logger_name, dest);
+        } else {
+            dest.push_back('-');
+        }
+        if (config_.format == syslog_format::rfc5424) {
+            dest.push_back(' ');
+            append_string_view(pid_, dest);
+            append_string_view(" - - ", dest);
+        } else {
+            dest.push_back('[');
+            append_string_view(pid_, dest);
+            append_string_view("]: ", dest);
+        }
+
+        if (config_.enable_formatting) {
+            formatted_.clear();
+            base_sink<Mutex>::formatter_->format(msg, formatted_);
+            // the record is the line, drop the eol added by the formatter
+            auto size = formatted_.size();
+            while (size > 0 && (formatted_[size - 1] == '\n' || formatted_[size - 1] == '\r')) {
+                size--;
+            }
+            dest.append(formatted_.data(), formatted_.data() + size);
+        } else {
+            append_string_view(msg.payload, dest);
+        }
+    }
+
+    // rfc5424: 2024-01-31T23:59:59.123456Z (utc)
+    // rfc3164: Jan 31 23:59:59 (local time)
+    void append_timestamp_(log_clock::time_point tp, memory_buf_t &dest) {
+        auto secs = log_clock::to_time_t(tp);
+        if (secs != cached_secs_ || cached_timestamp_.size() == 0) {
+            cached_secs_ = secs;
+            cached_timestamp_.clear();
+            if (config_.format == syslog_format::rfc5424) {
+                auto tm = details::os::gmtime(secs);
+                fmt_lib::format_to(std::back_inserter(cached_timestamp_),
+                                   "{:04}-{:02}-{:02}T{:02}:{:02}:{:02}.", tm.tm_year + 1900,
+                                   tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
+            } else {
+                static const char *months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                               "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+                auto tm = details::os::localtime(secs);
+                fmt_lib::format_to(std::back_inserter(cached_timestamp_),
+                                   "{} {:2} {:02}:{:02}:{:02}", months[tm.tm_mon], tm.tm_mday,
+                                   tm.tm_hour, tm.tm_min, tm.tm_sec);
+            }
+        }
+        dest.append(cached_timestamp_.data(), cached_timestamp_.data() + cached_timestamp_.size());
+        if (config_.format == syslog_format::rfc5424) {
+            auto micros = details::fmt_helper::time_fraction<std::chrono::microseconds>(tp);
+            details::fmt_helper::pad6(static_cast<size_t>(micros.count()), dest);
+            dest.push_back('Z');
+        }
+    }
+
+    void connect_() {
+        switch (config_.transport) {
+            case syslog_transport::unix_dgram:
+                connect_unix_();
+                break;
+            case syslog_transport::udp:
+                udp_client_ = details::make_unique<details::udp_client>(config_.address,
+                                                                        config_.port, 0);
+                break;
+            case syslog_transport::tcp: {
+                buffered_tcp_sink_config tcp_config(config_.address, config_.port);
+                tcp_config.buffer_size = config_.tcp_buffer_size;
+                tcp_config.overflow_policy = config_.tcp_overflow_policy;
+                tcp_sink_ = details::make_unique<buffered_tcp_sink_st>(std::move(tcp_config));
+                // the records are formatted by this sink
+                tcp_sink_->set_formatter(details::make_unique<spdlog::pattern_formatter>(
+                    "%v", pattern_time_type::local, ""));
+                break;
+            }
+        }
+    }
+
+    void connect_unix_() {
+        if (unix_fd_ != -1) {
+            ::close(unix_fd_);
+        }
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (config_.address.size() >= sizeof(addr.sun_path)) {
+            throw_spdlog_ex("native_syslog_sink: socket path too long: " + config_.address);
+        }
+        std::memcpy(addr.sun_path, config_.address.c_str(), config_.address.size() + 1);
+#if defined(SOCK_CLOEXEC)
+        unix_fd_ = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+#else
+        unix_fd_ = ::socket(AF_UNIX, SOCK_DGRAM, 0);
+#endif
+        if (unix_fd_ == -1) {
+            throw_spdlog_ex("native_syslog_sink: socket(2) failed", errno);
+        }
+        if (::connect(unix_fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+            auto err = errno;
+            ::close(unix_fd_);
+            unix_fd_ = -1;
+            throw_spdlog_ex("native_syslog_sink: failed connecting to " + config_.address, err);
+        }
+    }
+
+    // unix and udp only. tcp records are sent by tcp_sink_.
+    void send_batch_() {
+        if (batch_.empty()) {
+            return;
+        }
+        details::datagram_batch::clear_guard clear_batch(batch_);
+
+        if (config_.transport == syslog_transport::udp) {
+            udp_client_->send_many(batch_.data.data(), batch_.sizes.data(), batch_.count());
+            return;
+        }
+        // the syslog daemon might have been restarted, so reconnect once on failure, and resume
+        // from the first record that wasn't sent
+        size_t sent = 0;
+        size_t sent_bytes = 0;
+        if (!send_unix_(sent, sent_bytes)) {
+            connect_unix_();
+            if (!send_unix_(sent, sent_bytes)) {
+                throw_spdlog_ex("native_syslog_sink: send failed", errno);
+            }
+        }
+    }
+
+    // send the records of the batch from the sent'th one (at offset sent_bytes) over the
+    // connected unix socket, and advance sent and sent_bytes past them. returns false on error.
+    bool send_unix_(size_t &sent, size_t &sent_bytes) {
+        if (unix_fd_ == -1) {
+            return false;
+        }
+        const auto &sizes = batch_.sizes;
+#ifdef __linux__
+        static constexpr size_t max_batch = 64;
+        struct mmsghdr msgs[max_batch];
+        struct iovec iovecs[max_batch];
+        while (sizes.size() - sent > 1) {
+            auto n = (std::min)(sizes.size() - sent, max_batch);
+            auto *p = batch_.data.data() + sent_bytes;
+            for (size_t j = 0; j < n; j++) {
+                iovecs[j].iov_base = const_cast<char *>(p);
+                iovecs[j].iov_len = sizes[sent + j];
+                p += sizes[sent + j];
+                std::memset(&msgs[j], 0, sizeof(msgs[j]));
+                msgs[j].msg_hdr.msg_iov = &iovecs[j];
+                msgs[j].msg_hdr.msg_iovlen = 1;
+            }
+            // may send fewer records than asked: the loop continues from the first unsent one
+            auto rv = ::sendmmsg(unix_fd_, msgs, static_cast<unsigned int>(n), 0);
+            if (rv <= 0) {
+                return false;
+            }
+            for (int j = 0; j < rv; j++) {
+                sent_bytes += sizes[sent++];
+            }
+        }
+#endif
+        for (; sent < sizes.size(); sent++) {
+            if (::send(unix_fd_, batch_.data.data() + sent_bytes, sizes[sent], 0) < 0) {
+                return false;
+            }
+            sent_bytes += sizes[sent];
+        }
+        return true;
+    }
+
+    native_syslog_sink_config config_;
+    std::array<std::string, 7> priorities_;
+    std::string pid_;
+    std::time_t cached_secs_ = 0;
+    memory_buf_t cached_timestamp_;
+    memory_buf_t formatted_;
+    memory_buf_t record_;
+    memory_buf_t frame_;
+    details::datagram_batch batch_;
+
+    int unix_fd_ = -1;
+    std::unique_ptr<details::udp_client> udp_client_;
+    std::unique_ptr<buffered_tcp_sink_st> tcp_sink_;
+};
+
+using native_syslog_sink_mt = native_syslog_sink<std::mutex>;
+using native_syslog_sink_st = native_syslog_sink<details::null_mutex>;
+}  // namespace sinks
+
+//
+// factory functions
+//
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> native_syslog_logger_mt(
+    const std::string &logger_name, sinks::native_syslog_sink_config config = {}) {
+    return Factory::template create<sinks::native_syslog_sink_mt>(logger_name, std::move(config));
+}
+
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> native_syslog_logger_st(
+    const std::string &logger_name, sinks::native_syslog_sink_config config = {}) {
+    return Factory::template create<sinks::native_syslog_sink_st>(logger_name, std::move(config));
+}
+}  // namespace spdlog
@@ -0,0 +1,194 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "dist_sink.h"
+#include <spdlog/details/log_msg.h>
+#include <spdlog/details/null_mutex.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Rate limiting sink, to keep runaway logging from filling the disk.
+//
+// Each logger name and level has a token bucket: it holds up to burst tokens, refilled at
+// messages_per_second. A message passes if a token is available, and is dropped otherwise.
+// The limits can be set per level and per logger name. A logger with its own limit has a single
+// bucket, shared by all its levels. Every report_interval, a summary of the dropped messages is
+// logged for each bucket that dropped some, at notification_level (summaries are not limited):
+//
+//     Rate limit: dropped 5230 error messages
+//     Rate limit: dropped 812 messages
+//
+// The summaries are logged by the next message (or flush) after the interval.
+//
+// Example:
+//
+//     // 100 messages per second, bursts of 1000, per logger and level
+//     auto limiter = std::make_shared<spdlog::sinks::rate_limit_sink_mt>(100, 1000);
+//     limiter->set_level_limit(spdlog::level::debug, 10, 100);
+//     limiter->add_sink(std::make_shared<spdlog::sinks::basic_file_sink_mt>("logs/app.txt"));
+//     spdlog::logger l("logger", limiter);
+
+namespace spdlog {
+namespace sinks {
+template <typename Mutex>
+class rate_limit_sink : public dist_sink<Mutex> {
+public:
+    explicit rate_limit_sink(double messages_per_second,
+                             double burst,
+                             std::chrono::milliseconds report_interval = std::chrono::seconds(10),
+                             level::level_enum notification_level = level::warn)
+        : report_interval_{report_interval},
+          notification_level_{notification_level} {
+        level_limits_.fill(limit{messages_per_second, burst});
+    }
+
+    // set the limit of the messages of the given level
+    void set_level_limit(level::level_enum lvl, double messages_per_second, double burst) {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+        level_limits_[static_cast<size_t>(lvl)] = limit{messages_per_second, burst};
+    }
+
+    // set the limit of the messages of the given logger, shared by all its levels
+    void set_logger_limit(const std::string &logger_name,
+                          double messages_per_second,
+                          double burst) {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+        logger_limits_[logger_name] = limit{messages_per_second, burst};
+    }
+
+    // messages dropped so far
+    size_t dropped_messages() const { return dropped_.load(std::memory_order_relaxed); }
+
+protected:
+    void sink_it_(const details::log_msg &msg) override {
+        if (msg.time >= next_report_) {
+            report_(msg.time);
+        }
+        if (!take_token_(msg)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        dist_sink<Mutex>::sink_it_(msg);
+    }
+
+    void flush_() override {
+        report_(log_clock::now());
+        dist_sink<Mutex>::flush_();
+    }
+
+private:
+    struct limit {
+        double messages_per_second;
+        double burst;
+    };
+
+    struct bucket {
+        bool used = false;
+        double tokens = 0;
+        log_clock::time_point last_refill;
+        size_t dropped = 0;
+    };
+
+    struct logger_buckets {
+        std::string logger_name;
+        std::array<bucket, level::n_levels> levels;
+        bucket all_levels;  // used instead of levels if the logger has its own limit
+    };
+
+    bool take_token_(const details::log_msg &msg) {
+        auto &buckets = buckets_of_(msg.logger_name);
+        if (!logger_limits_.empty()) {
+            auto it = logger_limits_.find(buckets.logger_name);
+            if (it != logger_limits_.end()) {
+                return take_token_(buckets.all_levels, it->second, msg.time);
+            }
+        }
+        auto lvl = static_cast<size_t>(msg.level);
+        return take_token_(buckets.levels[lvl], level_limits_[lvl], msg.time);
+    }
+
+    // keyed by the FNV-1a hash of the name, so looking up a logger doesn't allocate.
+    // names with the same hash get their own entries.
+    logger_buckets &buckets_of_(string_view_t logger_name) {
+        uint64_t key = 14695981039346656037ull;
+        for (auto c : logger_name) {
+            key = (key ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        }
+        auto range = buckets_.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (string_view_t(it->second.logger_name) == logger_name) {
+                return it->second;
+            }
+        }
+        auto it = buckets_.emplace(key, logger_buckets());
+        it->second.logger_name.assign(logger_name.data(), logger_name.size());
+        return it->second;
+    }
+
+    static bool take_token_(bucket &b, const limit &lim, log_clock::time_point time) {
+        if (!b.used) {
+            b.used = true;
+            b.tokens = lim.burst;
+            b.last_refill = time;
+        } else if (time > b.last_refill) {
+            std::chrono::duration<double> elapsed = time - b.last_refill;
+            b.tokens = (std::min)(lim.burst, b.tokens + elapsed.count() * lim.messages_per_second);
+            b.last_refill = time;
+        }
+        if (b.tokens < 1) {
+            b.dropped++;
+            return false;
+        }
+        b.tokens -= 1;
+        return true;
+    }
+
+    // log a summary for each bucket that dropped messages
+    void report_(log_clock::time_point now) {
+        next_report_ = now + std::chrono::duration_cast<log_clock::duration>(report_interval_);
+        for (auto &logger : buckets_) {
+            for (size_t i = 0; i < logger.second.levels.size(); i++) {
+                auto level_name = level::to_string_view(static_cast<level::level_enum>(i));
+                report_dropped_(now, logger.second.logger_name, logger.second.levels[i],
+                                std::string(level_name.data(), level_name.size()) + " ");
+            }
+            report_dropped_(now, logger.second.logger_name, logger.second.all_levels, "");
+        }
+    }
+
+    void report_dropped_(log_clock::time_point now,
+                         const std::string &logger_name,
+                         bucket &b,
+                         const std::string &what) {
+        if (b.dropped == 0) {
+            return;
+        }
+        auto text = "Rate limit: dropped " + std::to_string(b.dropped) + " " + what + "messages";
+        details::log_msg summary{now, source_loc{}, logger_name, notification_level_, text};
+        b.dropped = 0;
+        dist_sink<Mutex>::sink_it_(summary);
+    }
+
+    std::chrono::milliseconds report_interval_;
+    level::level_enum notification_level_;
+    std::array<limit, level::n_levels> level_limits_;
+    std::unordered_map<std::string, limit> logger_limits_;
+    std::unordered_multimap<uint64_t, logger_buckets> buckets_;
+    log_clock::time_point next_report_;
+    std::atomic<size_t> dropped_{0};
+};
+
+using rate_limit_sink_mt = rate_limit_sink<std::mutex>;
+using rate_limit_sink_st = rate_limit_sink<details::null_mutex>;
+
+}  // namespace sinks
+}  // namespace spdlog
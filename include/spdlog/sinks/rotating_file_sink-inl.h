@@ -23,16 +23,18 @@
 namespace spdlog {
 namespace sinks {
 
-template <typename Mutex>
-SPDLOG_INLINE rotating_file_sink<Mutex>::rotating_file_sink(
+template <typename Mutex, typename FileHelper>
+SPDLOG_INLINE rotating_file_sink<Mutex, FileHelper>::rotating_file_sink(
     filename_t base_filename,
     std::size_t max_size,
     std::size_t max_files,
     bool rotate_on_open,
-    const file_event_handlers &event_handlers)
+    const file_event_handlers &event_handlers,
+    bool preallocate)
     : base_filename_(std::move(base_filename)),
       max_size_(max_size),
       max_files_(max_files),
+      preallocate_(preallocate),
       file_helper_{event_handlers} {
     if (max_size == 0) {
         throw_spdlog_ex("rotating sink constructor: max_size arg cannot be zero");
@@ -46,14 +48,17 @@ SPDLOG_INLINE rotating_file_sink<Mutex>::rotating_file_sink(
     if (rotate_on_open && current_size_ > 0) {
         rotate_();
         current_size_ = 0;
+    } else if (preallocate_) {
+        file_helper_.preallocate(max_size_);
     }
 }
 
 // calc filename according to index and file extension if exists.
 // e.g. calc_filename("logs/mylog.txt, 3) => "logs/mylog.3.txt".
-template <typename Mutex>
-SPDLOG_INLINE filename_t rotating_file_sink<Mutex>::calc_filename(const filename_t &filename,
-                                                                  std::size_t index) {
+template <typename Mutex, typename FileHelper>
+SPDLOG_INLINE filename_t
+rotating_file_sink<Mutex, FileHelper>::calc_filename(const filename_t &filename,
+                                                     std::size_t index) {
     if (index == 0u) {
         return filename;
     }
@@ -63,14 +68,14 @@ SPDLOG_INLINE filename_t rotating_file_sink<Mutex>::calc_filename(const filename
     return fmt_lib::format(SPDLOG_FMT_STRING(SPDLOG_FILENAME_T("{}.{}{}")), basename, index, ext);
 }
 
-template <typename Mutex>
-SPDLOG_INLINE filename_t rotating_file_sink<Mutex>::filename() {
+template <typename Mutex, typename FileHelper>
+SPDLOG_INLINE filename_t rotating_file_sink<Mutex, FileHelper>::filename() {
     std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
     return file_helper_.filename();
 }
 
-template <typename Mutex>
-SPDLOG_INLINE void rotating_file_sink<Mutex>::sink_it_(const details::log_msg &msg) {
+template <typename Mutex, typename FileHelper>
+SPDLOG_INLINE void rotating_file_sink<Mutex, FileHelper>::sink_it_(const details::log_msg &msg) {
     memory_buf_t formatted;
     base_sink<Mutex>::formatter_->format(msg, formatted);
     auto new_size = current_size_ + formatted.size();
@@ -78,7 +83,8 @@ SPDLOG_INLINE void rotating_file_sink<Mutex>::sink_it_(const details::log_msg &m
     // rotate if the new estimated file size exceeds max size.
     // rotate only if the real size > 0 to better deal with full disk (see issue #2261).
     // we only check the real size when new_size > max_size_ because it is relatively expensive.
-    if (new_size > max_size_) {
+    // a compressing file helper checks its own size first (see details::would_exceed).
+    if (new_size > max_size_ && details::would_exceed(file_helper_, max_size_, formatted.size())) {
         file_helper_.flush();
         if (file_helper_.size() > 0) {
             rotate_();
@@ -89,8 +95,8 @@ SPDLOG_INLINE void rotating_file_sink<Mutex>::sink_it_(const details::log_msg &m
     current_size_ = new_size;
 }
 
-template <typename Mutex>
-SPDLOG_INLINE void rotating_file_sink<Mutex>::flush_() {
+template <typename Mutex, typename FileHelper>
+SPDLOG_INLINE void rotating_file_sink<Mutex, FileHelper>::flush_() {
     file_helper_.flush();
 }
 
@@ -99,8 +105,8 @@ SPDLOG_INLINE void rotating_file_sink<Mutex>::flush_() {
 // log.1.txt -> log.2.txt
 // log.2.txt -> log.3.txt
 // log.3.txt -> delete
-template <typename Mutex>
-SPDLOG_INLINE void rotating_file_sink<Mutex>::rotate_() {
+template <typename Mutex, typename FileHelper>
+SPDLOG_INLINE void rotating_file_sink<Mutex, FileHelper>::rotate_() {
     using details::os::filename_to_str;
     using details::os::path_exists;
 
@@ -128,13 +134,16 @@ SPDLOG_INLINE void rotating_file_sink<Mutex>::rotate_() {
         }
     }
     file_helper_.reopen(true);
+    if (preallocate_) {
+        file_helper_.preallocate(max_size_);
+    }
 }
 
 // delete the target if exists, and rename the src file  to target
 // return true on success, false otherwise.
-template <typename Mutex>
-SPDLOG_INLINE bool rotating_file_sink<Mutex>::rename_file_(const filename_t &src_filename,
-                                                           const filename_t &target_filename) {
+template <typename Mutex, typename FileHelper>
+SPDLOG_INLINE bool rotating_file_sink<Mutex, FileHelper>::rename_file_(
+    const filename_t &src_filename, const filename_t &target_filename) {
     // try to delete the target file in case it already exists.
     (void)details::os::remove(target_filename);
     return details::os::rename(src_filename, target_filename) == 0;
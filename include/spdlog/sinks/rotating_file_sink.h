@@ -17,15 +17,18 @@ namespace sinks {
 
 //
 // Rotating file sink based on size
+// If preallocate is true, disk space for max_size bytes is reserved when each file is opened
+// (where supported), and the unused part is released on rotation.
 //
-template <typename Mutex>
+template <typename Mutex, typename FileHelper = details::file_helper>
 class rotating_file_sink final : public base_sink<Mutex> {
 public:
     rotating_file_sink(filename_t base_filename,
                        std::size_t max_size,
                        std::size_t max_files,
                        bool rotate_on_open = false,
-                       const file_event_handlers &event_handlers = {});
+                       const file_event_handlers &event_handlers = {},
+                       bool preallocate = false);
     static filename_t calc_filename(const filename_t &filename, std::size_t index);
     filename_t filename();
 
@@ -49,7 +52,8 @@ private:
     std::size_t max_size_;
     std::size_t max_files_;
     std::size_t current_size_;
-    details::file_helper file_helper_;
+    bool preallocate_;
+    FileHelper file_helper_;
 };
 
 using rotating_file_sink_mt = rotating_file_sink<std::mutex>;
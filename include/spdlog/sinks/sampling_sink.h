@@ -0,0 +1,66 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "dist_sink.h"
+#include <spdlog/details/log_msg.h>
+#include <spdlog/details/null_mutex.h>
+#include <spdlog/details/sampler.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+// Sampling sink: passes one in one_in messages below always_level to its sinks, and all the
+// messages at or above it.
+//
+// The decision is made by details/sampler.h: by the hash of the trace id in the MDC, so whole
+// traces are kept or dropped, or randomly if there is none. The MDC is only available on the
+// logging thread, so with an async logger the sampling is always random. To avoid formatting
+// the messages that are dropped, use the SPDLOG_*_SAMPLED macros instead.
+//
+// Example:
+//
+//     // keep 1 in 1000 debug and info messages, and all warnings and errors
+//     auto sampler = std::make_shared<spdlog::sinks::sampling_sink_mt>(1000);
+//     sampler->add_sink(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
+//     spdlog::logger l("logger", sampler);
+
+namespace spdlog {
+namespace sinks {
+template <typename Mutex>
+class sampling_sink : public dist_sink<Mutex> {
+public:
+    explicit sampling_sink(uint64_t one_in, level::level_enum always_level = level::warn)
+        : one_in_{one_in},
+          always_level_{always_level} {}
+
+    // messages passed to the sinks
+    uint64_t emitted_messages() const { return emitted_.load(std::memory_order_relaxed); }
+
+    // messages dropped by the sampling
+    uint64_t dropped_messages() const { return dropped_.load(std::memory_order_relaxed); }
+
+protected:
+    void sink_it_(const details::log_msg &msg) override {
+        if (msg.level < always_level_ && !details::sample_one_in(one_in_)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        emitted_.fetch_add(1, std::memory_order_relaxed);
+        dist_sink<Mutex>::sink_it_(msg);
+    }
+
+private:
+    uint64_t one_in_;
+    level::level_enum always_level_;
+    std::atomic<uint64_t> emitted_{0};
+    std::atomic<uint64_t> dropped_{0};
+};
+
+using sampling_sink_mt = sampling_sink<std::mutex>;
+using sampling_sink_st = sampling_sink<details::null_mutex>;
+
+}  // namespace sinks
+}  // namespace spdlog
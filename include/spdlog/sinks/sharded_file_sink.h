@@ -0,0 +1,187 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+//
+// File sink that spreads the logging threads over N independent shards, each with its own
+// mutex, formatter and file ("logs/app.txt" -> "logs/app.shard0.txt", "logs/app.shard1.txt", ..).
+// Threads on different shards never contend, so formatting and writing scale with the
+// number of cores for synchronous loggers.
+//
+// Each shard file is ordered, but there is no order between shards. merge_shards() merges them
+// into a single file, assuming each line starts with a sortable timestamp (like the default
+// pattern "[%Y-%m-%d %H:%M:%S.%e] ..."). Multi line messages are not supported by the merge.
+//
+// Example:
+//
+//     #include <spdlog/sinks/sharded_file_sink.h>
+//
+//     auto logger = spdlog::sharded_logger_mt("sharded", "logs/app.txt", 8);
+//     ...
+//     spdlog::sinks::sharded_file_sink::merge_shards("logs/app.txt", 8, "logs/app.merged.txt");
+//
+
+#include <spdlog/common.h>
+#include <spdlog/details/file_helper.h>
+#include <spdlog/details/os.h>
+#include <spdlog/details/synchronous_factory.h>
+#include <spdlog/details/thread_shard.h>
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/pattern_formatter.h>
+#include <spdlog/sinks/sink.h>
+
+#include <cerrno>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace spdlog {
+namespace sinks {
+
+class sharded_file_sink final : public sink {
+public:
+    // n_shards = 0 uses one shard per hardware thread
+    explicit sharded_file_sink(const filename_t &base_filename,
+                               size_t n_shards = 0,
+                               bool truncate = false,
+                               const file_event_handlers &event_handlers = {})
+        : base_filename_{base_filename},
+          shard_map_{n_shards != 0 ? n_shards : std::thread::hardware_concurrency()} {
+        shards_.reserve(shard_map_.n_shards());
+        for (size_t i = 0; i < shard_map_.n_shards(); i++) {
+            shards_.emplace_back(new shard(event_handlers));
+            shards_.back()->file_helper.open(shard_filename(base_filename_, i), truncate);
+        }
+    }
+
+    sharded_file_sink(const sharded_file_sink &) = delete;
+    sharded_file_sink &operator=(const sharded_file_sink &) = delete;
+
+    void log(const details::log_msg &msg) override {
+        auto &s = current_shard_();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.formatted.clear();
+        s.formatter->format(msg, s.formatted);
+        s.file_helper.write(s.formatted);
+    }
+
+    void flush() override {
+        for (auto &s : shards_) {
+            std::lock_guard<std::mutex> lock(s->mutex);
+            s->file_helper.flush();
+        }
+    }
+
+    void set_pattern(const std::string &pattern) override {
+        set_formatter(details::make_unique<spdlog::pattern_formatter>(pattern));
+    }
+
+    void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override {
+        for (auto &s : shards_) {
+            std::lock_guard<std::mutex> lock(s->mutex);
+            s->formatter = sink_formatter->clone();
+        }
+    }
+
+    size_t n_shards() const { return shards_.size(); }
+
+    const filename_t &base_filename() const { return base_filename_; }
+
+    // calc shard filename according to index and file extension if exists.
+    // e.g. shard_filename("logs/mylog.txt, 3) => "logs/mylog.shard3.txt".
+    static filename_t shard_filename(const filename_t &filename, size_t index) {
+        filename_t basename, ext;
+        std::tie(basename, ext) = details::file_helper::split_by_extension(filename);
+        return fmt_lib::format(SPDLOG_FMT_STRING(SPDLOG_FILENAME_T("{}.shard{}{}")), basename,
+                               index, ext);
+    }
+
+    // merge the shard files of base_filename into target_filename, ordered by line.
+    // missing shard files are skipped. returns the number of lines written.
+    static size_t merge_shards(const filename_t &base_filename,
+                               size_t n_shards,
+                               const filename_t &target_filename) {
+        std::vector<std::unique_ptr<std::ifstream>> inputs;
+        std::vector<std::string> heads;
+        for (size_t i = 0; i < n_shards; i++) {
+            std::unique_ptr<std::ifstream> in(
+                new std::ifstream(shard_filename(base_filename, i), std::ios::binary));
+            std::string line;
+            if (in->is_open() && std::getline(*in, line)) {
+                inputs.push_back(std::move(in));
+                heads.push_back(std::move(line));
+            }
+        }
+
+        std::ofstream out(target_filename, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            throw_spdlog_ex("sharded_file_sink: failed opening " +
+                                details::os::filename_to_str(target_filename),
+                            errno);
+        }
+
+        // n-way merge. the number of shards is small, so a linear scan is enough.
+        size_t n_lines = 0;
+        while (!inputs.empty()) {
+            size_t min = 0;
+            for (size_t i = 1; i < heads.size(); i++) {
+                if (heads[i] < heads[min]) {
+                    min = i;
+                }
+            }
+            out << heads[min] << '\n';
+            n_lines++;
+            if (!std::getline(*inputs[min], heads[min])) {
+                inputs.erase(inputs.begin() + static_cast<std::ptrdiff_t>(min));
+                heads.erase(heads.begin() + static_cast<std::ptrdiff_t>(min));
+            }
+        }
+        if (!out.flush()) {
+            throw_spdlog_ex("sharded_file_sink: failed writing " +
+                                details::os::filename_to_str(target_filename),
+                            errno);
+        }
+        return n_lines;
+    }
+
+private:
+    struct shard {
+        explicit shard(const file_event_handlers &event_handlers)
+            : formatter{details::make_unique<spdlog::pattern_formatter>()},
+              file_helper{event_handlers} {}
+
+        std::mutex mutex;
+        std::unique_ptr<spdlog::formatter> formatter;
+        details::file_helper file_helper;
+        memory_buf_t formatted;
+    };
+
+    // threads are assigned to shards round robin, in the order they first log to this sink
+    shard &current_shard_() { return *shards_[shard_map_.shard()]; }
+
+    filename_t base_filename_;
+    details::thread_shard_map shard_map_;
+    std::vector<std::unique_ptr<shard>> shards_;
+};
+
+}  // namespace sinks
+
+//
+// factory functions
+//
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> sharded_logger_mt(const std::string &logger_name,
+                                                 const filename_t &base_filename,
+                                                 size_t n_shards = 0,
+                                                 bool truncate = false,
+                                                 const file_event_handlers &event_handlers = {}) {
+    return Factory::template create<sinks::sharded_file_sink>(logger_name, base_filename, n_shards,
+                                                              truncate, event_handlers);
+}
+
+}  // namespace spdlog
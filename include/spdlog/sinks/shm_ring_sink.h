@@ -0,0 +1,163 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <spdlog/common.h>
+#include <spdlog/details/log_msg.h>
+#include <spdlog/details/log_msg_record.h>
+#include <spdlog/details/shm_ring.h>
+#include <spdlog/details/synchronous_factory.h>
+#include <spdlog/sinks/sink.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Sink that copies the raw log_msg fields into a ring in POSIX shared memory (see
+// details/shm_ring.h), to be formatted and written by another process (see shm_ring_reader and
+// example/shm_ring_daemon.cpp). Logging never blocks, formats, or makes a system call: the
+// message is copied with memcpy, and dropped (and counted) if the ring is full.
+// Several processes can log to the same ring. The formatter of this sink is not used.
+//
+// Usage:
+//     // application
+//     auto logger = spdlog::shm_ring_logger_mt("app", "/myapp-log", 4 * 1024 * 1024);
+//
+//     // reader process
+//     spdlog::sinks::shm_ring_reader reader("/myapp-log", 4 * 1024 * 1024);
+//     for (;;) {
+//         if (reader.drain_to(*file_sink) == 0) std::this_thread::sleep_for(...);
+//     }
+
+namespace spdlog {
+namespace sinks {
+
+class shm_ring_sink final : public sink {
+public:
+    // attach to the ring with the given name (e.g. "/myapp-log"), creating it with the given
+    // capacity in bytes if it doesn't exist
+    explicit shm_ring_sink(const std::string &shm_name, size_t capacity = 4 * 1024 * 1024) {
+        ring_.open(shm_name, capacity);
+    }
+
+    void log(const details::log_msg &msg) override {
+        details::log_msg_record record;
+        string_view_t filename, funcname;
+        record.assign(msg, filename, funcname);
+        const string_view_t parts[] = {
+            string_view_t(reinterpret_cast<const char *>(&record), sizeof(record)),
+            msg.logger_name, filename, funcname, msg.payload};
+        ring_.write(parts);
+    }
+
+    void flush() override {}
+
+    void set_pattern(const std::string &) override {}
+
+    void set_formatter(std::unique_ptr<spdlog::formatter>) override {}
+
+    // counters of the ring, shared by all the processes that write to it
+    uint64_t written_messages() { return ring_.hdr().committed.load(std::memory_order_relaxed); }
+
+    uint64_t dropped_messages() { return ring_.hdr().dropped.load(std::memory_order_relaxed); }
+
+private:
+    details::shm_ring ring_;
+};
+
+//
+// Reads the messages of a shared memory ring and passes them to a callback or a sink.
+// Only one reader may be attached to a ring at a time.
+// The position of the reader is kept in the ring, so a restarted reader continues where the
+// previous one stopped, and messages committed before a writer crashed are not lost.
+// If a writer dies after reserving space but before committing its message, the reader would
+// wait for it forever: a message that is not committed within stall_timeout is skipped and
+// counted in abandoned_messages().
+//
+class shm_ring_reader {
+public:
+    // attach to the ring with the given name. if capacity is not 0, the ring is created if it
+    // doesn't exist yet, otherwise it must already exist.
+    explicit shm_ring_reader(const std::string &shm_name,
+                             size_t capacity = 0,
+                             std::chrono::milliseconds stall_timeout = std::chrono::seconds(5))
+        : stall_timeout_{stall_timeout} {
+        ring_.open(shm_name, capacity);
+    }
+
+    // call on_msg(const log_msg &) for up to max_messages waiting messages.
+    // the log_msg and the strings it points to are valid only during the callback.
+    // returns the number of messages read.
+    template <typename OnMsg>
+    size_t poll(OnMsg &&on_msg, size_t max_messages = static_cast<size_t>(-1)) {
+        size_t n = ring_.read(
+            [&](const char *data, size_t size) {
+                // records not written by shm_ring_sink are skipped
+                record_reader_.read(data, size, on_msg);
+            },
+            max_messages);
+        check_stalled_(n);
+        return n;
+    }
+
+    // pass up to max_messages waiting messages to the given sink (if its level allows)
+    size_t drain_to(sink &target, size_t max_messages = static_cast<size_t>(-1)) {
+        return poll(
+            [&target](const details::log_msg &msg) {
+                if (target.should_log(msg.level)) {
+                    target.log(msg);
+                }
+            },
+            max_messages);
+    }
+
+    uint64_t written_messages() { return ring_.hdr().committed.load(std::memory_order_relaxed); }
+
+    uint64_t dropped_messages() { return ring_.hdr().dropped.load(std::memory_order_relaxed); }
+
+    // messages skipped by this reader because their writer didn't commit them in time
+    uint64_t abandoned_messages() const { return abandoned_messages_; }
+
+private:
+    void check_stalled_(size_t n_read) {
+        if (n_read > 0 || !ring_.has_pending()) {
+            stalled_ = false;
+            return;
+        }
+        auto now = std::chrono::steady_clock::now();
+        auto pos = ring_.read_pos();
+        if (!stalled_ || pos != stall_pos_) {
+            stalled_ = true;
+            stall_pos_ = pos;
+            stall_since_ = now;
+        } else if (now - stall_since_ >= stall_timeout_) {
+            if (ring_.skip_stalled()) {
+                abandoned_messages_++;
+            }
+            stalled_ = false;
+        }
+    }
+
+    details::shm_ring ring_;
+    std::chrono::milliseconds stall_timeout_;
+    bool stalled_ = false;
+    uint64_t stall_pos_ = 0;
+    std::chrono::steady_clock::time_point stall_since_;
+    uint64_t abandoned_messages_ = 0;
+    details::log_msg_record_reader record_reader_;
+};
+
+}  // namespace sinks
+
+//
+// factory functions
+//
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> shm_ring_logger_mt(const std::string &logger_name,
+                                                  const std::string &shm_name,
+                                                  size_t capacity = 4 * 1024 * 1024) {
+    return Factory::template create<sinks::shm_ring_sink>(logger_name, shm_name, capacity);
+}
+
+}  // namespace spdlog
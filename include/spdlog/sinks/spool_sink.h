@@ -0,0 +1,368 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <spdlog/common.h>
+#include <spdlog/details/file_helper.h>
+#include <spdlog/details/log_msg_record.h>
+#include <spdlog/details/null_mutex.h>
+#include <spdlog/details/os.h>
+#include <spdlog/pattern_formatter.h>
+#include <spdlog/sinks/base_sink.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Store and forward decorator for sinks that can fail, such as tcp_sink.
+//
+// Messages are passed to the target sink as long as it accepts them. When the target throws,
+// the message and everything after it is spooled: first to a memory buffer, and when that fills
+// up, to an append-only log of segment files on disk ("<spool_filename>.0", ".1", ...).
+// Every retry_interval the spooled messages are replayed to the target in order, at most
+// replay_batch of them per log or flush call, so catching up doesn't stall the logging thread.
+// Once the spool is empty, new messages go straight to the target again.
+//
+// Replayed segment files are deleted, and the replay position is kept in "<spool_filename>.cursor",
+// so messages spooled on disk survive a restart and are replayed (at least once) by the next
+// spool_sink using the same spool_filename. flush() and the destructor move the memory buffer to
+// disk while the target is down. When the disk limit is reached, new messages are dropped.
+//
+// Example:
+//
+//     auto tcp = std::make_shared<spdlog::sinks::tcp_sink_mt>(tcp_config);
+//     auto spool = std::make_shared<spdlog::sinks::spool_sink_mt>(
+//         tcp, spdlog::sinks::spool_sink_config("spool/tcp"));
+//     auto logger = std::make_shared<spdlog::logger>("net", spool);
+
+namespace spdlog {
+namespace sinks {
+
+struct spool_sink_config {
+    filename_t spool_filename;               // base name of the segment files
+    size_t memory_limit = 1024 * 1024;       // spooled bytes kept in memory before using the disk
+    size_t max_segment_size = 16 * 1024 * 1024;
+    size_t max_disk_size = 1024 * 1024 * 1024;  // total size of the segment files
+    std::chrono::milliseconds retry_interval{1000};  // delay before retrying a failed target
+    size_t replay_batch = 1000;  // max messages replayed per log or flush call
+
+    explicit spool_sink_config(filename_t filename)
+        : spool_filename{std::move(filename)} {}
+};
+
+template <typename Mutex>
+class spool_sink final : public base_sink<Mutex> {
+public:
+    spool_sink(std::shared_ptr<sink> target, spool_sink_config config)
+        : target_{std::move(target)},
+          config_{std::move(config)} {
+        load_();
+    }
+
+    spool_sink(const spool_sink &) = delete;
+    spool_sink &operator=(const spool_sink &) = delete;
+
+    // keep the messages that were not delivered for the next run
+    ~spool_sink() override {
+        SPDLOG_TRY {
+            spill_();
+            writer_.close();
+            replay_file_.close();
+            save_cursor_();
+        }
+        SPDLOG_CATCH_STD
+    }
+
+    // messages that were spooled because the target failed
+    size_t spooled_messages() const { return spooled_messages_.load(std::memory_order_relaxed); }
+
+    // spooled messages that were later delivered to the target
+    size_t replayed_messages() const { return replayed_messages_.load(std::memory_order_relaxed); }
+
+    // messages dropped because the spool was full (or a record on disk was corrupted)
+    size_t dropped_messages() const { return dropped_messages_.load(std::memory_order_relaxed); }
+
+    // number of times the target threw
+    size_t delivery_errors() const { return delivery_errors_.load(std::memory_order_relaxed); }
+
+    // true if messages are waiting in the spool
+    bool spooling() {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+        return pending_();
+    }
+
+protected:
+    void sink_it_(const details::log_msg &msg) override {
+        if (pending_()) {
+            replay_if_due_();
+        }
+        // keep the order: new messages wait behind the spooled ones
+        if (pending_() || !deliver_(msg)) {
+            spool_(msg);
+        }
+    }
+
+    void flush_() override {
+        replay_if_due_();
+        if (pending_()) {
+            spill_();
+            return;
+        }
+        SPDLOG_TRY { target_->flush(); }
+        SPDLOG_CATCH_STD
+    }
+
+    void set_pattern_(const std::string &pattern) override {
+        set_formatter_(details::make_unique<spdlog::pattern_formatter>(pattern));
+    }
+
+    void set_formatter_(std::unique_ptr<spdlog::formatter> sink_formatter) override {
+        base_sink<Mutex>::formatter_ = std::move(sink_formatter);
+        target_->set_formatter(base_sink<Mutex>::formatter_->clone());
+    }
+
+private:
+    struct segment {
+        size_t seq;
+        size_t size;
+    };
+
+    bool pending_() const { return !segments_.empty() || mem_offset_ < mem_.size(); }
+
+    bool deliver_(const details::log_msg &msg) {
+        bool delivered = false;
+        SPDLOG_TRY {
+            if (target_->should_log(msg.level)) {
+                target_->log(msg);
+            }
+            delivered = true;
+        }
+        SPDLOG_CATCH_STD
+        if (!delivered) {
+            delivery_errors_.fetch_add(1, std::memory_order_relaxed);
+            next_retry_ = std::chrono::steady_clock::now() + config_.retry_interval;
+        }
+        return delivered;
+    }
+
+    // records are stored as 4 bytes size + details::log_msg_record
+    void spool_(const details::log_msg &msg) {
+        auto old_size = mem_.size();
+        mem_.resize(old_size + 4);
+        details::log_msg_record::append(msg, mem_);
+        auto record_size = static_cast<uint32_t>(mem_.size() - old_size - 4);
+        std::memcpy(mem_.data() + old_size, &record_size, 4);
+
+        if (mem_.size() - mem_offset_ > config_.memory_limit && !spill_()) {
+            // no room on disk either
+            mem_.resize(old_size);
+            dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        spooled_messages_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // move the memory buffer to the last segment file.
+    // returns false if it doesn't fit in max_disk_size.
+    bool spill_() {
+        size_t n = mem_.size() - mem_offset_;
+        if (n == 0) {
+            return true;
+        }
+        if (disk_size_ + n > config_.max_disk_size) {
+            return false;
+        }
+        if (!writer_open_ || segments_.back().size >= config_.max_segment_size) {
+            writer_.close();
+            segments_.push_back(segment{next_seq_++, 0});
+            writer_.open(segment_filename_(segments_.back().seq), true);
+            writer_open_ = true;
+        }
+        if (mem_offset_ > 0) {
+            std::memmove(mem_.data(), mem_.data() + mem_offset_, n);
+            mem_.resize(n);
+            mem_offset_ = 0;
+        }
+        writer_.write(mem_);
+        writer_.flush();
+        segments_.back().size += n;
+        disk_size_ += n;
+        mem_.clear();
+        return true;
+    }
+
+    void replay_if_due_() {
+        if (!pending_() || std::chrono::steady_clock::now() < next_retry_) {
+            return;
+        }
+        for (size_t i = 0; i < config_.replay_batch && pending_(); i++) {
+            if (!replay_one_()) {
+                return;
+            }
+        }
+    }
+
+    // deliver the oldest spooled message. returns false if the target failed.
+    bool replay_one_() {
+        const char *record;
+        size_t record_size;
+        if (!segments_.empty()) {
+            if (!read_disk_record_()) {
+                // a record truncated by a crash (or unreadable) is lost with the segment
+                if (replay_offset_ < segments_.front().size) {
+                    dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+                }
+                finish_segment_();
+                return true;
+            }
+            record = record_buf_.data();
+            record_size = record_buf_.size();
+        } else {
+            uint32_t size;
+            std::memcpy(&size, mem_.data() + mem_offset_, 4);
+            record = mem_.data() + mem_offset_ + 4;
+            record_size = size;
+        }
+
+        bool delivered = true;
+        bool valid = record_reader_.read(record, record_size, [&](const details::log_msg &msg) {
+            delivered = deliver_(msg);
+        });
+        if (!delivered) {
+            return false;
+        }
+        if (valid) {
+            replayed_messages_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (!segments_.empty()) {
+            replay_offset_ += 4 + record_size;
+            if (replay_offset_ >= segments_.front().size) {
+                finish_segment_();
+            }
+        } else {
+            mem_offset_ += 4 + record_size;
+            if (mem_offset_ == mem_.size()) {
+                mem_.clear();
+                mem_offset_ = 0;
+            }
+        }
+        return true;
+    }
+
+    // read the record at replay_offset_ of the first segment into record_buf_.
+    // returns false at the end of the segment (or at a record truncated by a crash).
+    bool read_disk_record_() {
+        auto &front = segments_.front();
+        if (replay_offset_ + 4 > front.size) {
+            return false;
+        }
+        if (!replay_file_.is_open()) {
+            replay_file_.open(segment_filename_(front.seq), std::ios::binary);
+        }
+        // the segment may still be appended to, and a failed delivery leaves the stream past
+        // the record, so always read from the replay position
+        replay_file_.clear();
+        replay_file_.seekg(static_cast<std::streamoff>(replay_offset_));
+        uint32_t size = 0;
+        replay_file_.read(reinterpret_cast<char *>(&size), 4);
+        if (!replay_file_ || replay_offset_ + 4 + size > front.size) {
+            return false;
+        }
+        record_buf_.resize(size);
+        replay_file_.read(record_buf_.data(), static_cast<std::streamsize>(size));
+        return static_cast<bool>(replay_file_);
+    }
+
+    // delete the replayed segment
+    void finish_segment_() {
+        replay_file_.close();
+        replay_file_.clear();
+        if (segments_.size() == 1) {
+            writer_.close();
+            writer_open_ = false;
+        }
+        details::os::remove(segment_filename_(segments_.front().seq));
+        disk_size_ -= segments_.front().size;
+        segments_.pop_front();
+        replay_offset_ = 0;
+        if (segments_.empty()) {
+            next_seq_ = 0;
+        }
+        save_cursor_();
+    }
+
+    filename_t segment_filename_(size_t seq) const {
+        return fmt_lib::format(SPDLOG_FMT_STRING(SPDLOG_FILENAME_T("{}.{}")),
+                               config_.spool_filename, seq);
+    }
+
+    filename_t cursor_filename_() const {
+        return config_.spool_filename + SPDLOG_FILENAME_T(".cursor");
+    }
+
+    void save_cursor_() {
+        if (segments_.empty()) {
+            details::os::remove_if_exists(cursor_filename_());
+            return;
+        }
+        std::ofstream cursor(cursor_filename_(), std::ios::trunc);
+        cursor << segments_.front().seq << ' ' << replay_offset_ << '\n';
+    }
+
+    // pick up the segments left by a previous run
+    void load_() {
+        size_t seq = 0;
+        size_t offset = 0;
+        std::ifstream cursor(cursor_filename_());
+        if (cursor) {
+            cursor >> seq >> offset;
+        }
+        for (; details::os::path_exists(segment_filename_(seq)); seq++) {
+            std::ifstream f(segment_filename_(seq), std::ios::binary | std::ios::ate);
+            auto size = static_cast<size_t>(f.tellg());
+            segments_.push_back(segment{seq, size});
+            disk_size_ += size;
+        }
+        next_seq_ = seq;
+        if (!segments_.empty() && offset <= segments_.front().size) {
+            replay_offset_ = offset;
+        }
+    }
+
+    std::shared_ptr<sink> target_;
+    spool_sink_config config_;
+    std::chrono::steady_clock::time_point next_retry_;
+
+    memory_buf_t mem_;  // newest spooled records, after those on disk
+    size_t mem_offset_ = 0;
+    std::deque<segment> segments_;
+    size_t next_seq_ = 0;
+    size_t disk_size_ = 0;
+    details::file_helper writer_;  // appends to the last segment
+    bool writer_open_ = false;
+    std::ifstream replay_file_;  // reads the first segment
+    size_t replay_offset_ = 0;
+    memory_buf_t record_buf_;
+    details::log_msg_record_reader record_reader_;
+
+    std::atomic<size_t> spooled_messages_{0};
+    std::atomic<size_t> replayed_messages_{0};
+    std::atomic<size_t> dropped_messages_{0};
+    std::atomic<size_t> delivery_errors_{0};
+};
+
+using spool_sink_mt = spool_sink<std::mutex>;
+using spool_sink_st = spool_sink<details::null_mutex>;
+
+}  // namespace sinks
+}  // namespace spdlog
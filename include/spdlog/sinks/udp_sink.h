@@ -4,6 +4,7 @@
 #pragma once
 
 #include <spdlog/common.h>
+#include <spdlog/details/datagram_batch.h>
 #include <spdlog/details/null_mutex.h>
 #include <spdlog/sinks/base_sink.h>
 #ifdef _WIN32
@@ -19,6 +20,11 @@
 
 // Simple udp client sink
 // Sends formatted log via udp
+//
+// Batching mode (batch_max_messages > 1) collects the datagrams and sends them together using
+// sendmmsg (one syscall per up to 64 datagrams) on linux. A batch is sent when it reaches
+// batch_max_messages or batch_max_bytes, when a message arrives batch_max_delay after the first
+// message of the batch, or on flush(). Use flush_every() to bound the delay on idle loggers.
 
 namespace spdlog {
 namespace sinks {
@@ -26,6 +32,10 @@ namespace sinks {
 struct udp_sink_config {
     std::string server_host;
     uint16_t server_port;
+    int send_buffer_size = 1024 * 10;  // SO_SNDBUF. 0 to keep the system default
+    size_t batch_max_messages = 0;     // 0 or 1 to send each message as it is logged
+    size_t batch_max_bytes = 64 * 1024;
+    std::chrono::milliseconds batch_max_delay{0};  // 0 for no time limit
 
     udp_sink_config(std::string host, uint16_t port)
         : server_host{std::move(host)},
@@ -35,21 +45,54 @@ struct udp_sink_config {
 template <typename Mutex>
 class udp_sink : public spdlog::sinks::base_sink<Mutex> {
 public:
-    // host can be hostname or ip address
+    // host can be hostname or ip address (IPv4 or IPv6)
     explicit udp_sink(udp_sink_config sink_config)
-        : client_{sink_config.server_host, sink_config.server_port} {}
+        : config_{std::move(sink_config)},
+          client_{config_.server_host, config_.server_port, config_.send_buffer_size} {}
 
-    ~udp_sink() override = default;
+    ~udp_sink() override {
+        SPDLOG_TRY {
+            std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+            send_batch_();
+        }
+        SPDLOG_CATCH_STD
+    }
 
 protected:
     void sink_it_(const spdlog::details::log_msg &msg) override {
         spdlog::memory_buf_t formatted;
         spdlog::sinks::base_sink<Mutex>::formatter_->format(msg, formatted);
-        client_.send(formatted.data(), formatted.size());
+        if (config_.batch_max_messages <= 1) {
+            client_.send(formatted.data(), formatted.size());
+            return;
+        }
+
+        if (batch_.empty()) {
+            batch_start_ = msg.time;
+        }
+        batch_.append(formatted.data(), formatted.size());
+        if (batch_.count() >= config_.batch_max_messages ||
+            batch_.data.size() >= config_.batch_max_bytes ||
+            (config_.batch_max_delay.count() > 0 &&
+             msg.time - batch_start_ >= config_.batch_max_delay)) {
+            send_batch_();
+        }
+    }
+
+    void flush_() override { send_batch_(); }
+
+    void send_batch_() {
+        if (batch_.empty()) {
+            return;
+        }
+        details::datagram_batch::clear_guard clear_batch(batch_);
+        client_.send_many(batch_.data.data(), batch_.sizes.data(), batch_.count());
     }
 
-    void flush_() override {}
+    udp_sink_config config_;
     details::udp_client client_;
+    details::datagram_batch batch_;
+    log_clock::time_point batch_start_;
 };
 
 using udp_sink_mt = udp_sink<std::mutex>;
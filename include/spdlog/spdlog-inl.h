@@ -20,6 +20,10 @@ SPDLOG_INLINE std::shared_ptr<logger> get(const std::string &name) {
     return details::registry::instance().get(name);
 }
 
+SPDLOG_INLINE logger *get_raw(const std::string &name) {
+    return details::registry::instance().get_raw(name);
+}
+
 SPDLOG_INLINE void set_formatter(std::unique_ptr<spdlog::formatter> formatter) {
     details::registry::instance().set_formatter(std::move(formatter));
 }
@@ -35,18 +39,22 @@ SPDLOG_INLINE void enable_backtrace(size_t n_messages) {
 
 SPDLOG_INLINE void disable_backtrace() { details::registry::instance().disable_backtrace(); }
 
-SPDLOG_INLINE void dump_backtrace() { default_logger_raw()->dump_backtrace(); }
+SPDLOG_INLINE void dump_backtrace() { details::default_logger_guard()->dump_backtrace(); }
 
-SPDLOG_INLINE level::level_enum get_level() { return default_logger_raw()->level(); }
+SPDLOG_INLINE level::level_enum get_level() { return details::default_logger_guard()->level(); }
 
 SPDLOG_INLINE bool should_log(level::level_enum log_level) {
-    return default_logger_raw()->should_log(log_level);
+    return details::default_logger_guard()->should_log(log_level);
 }
 
 SPDLOG_INLINE void set_level(level::level_enum log_level) {
     details::registry::instance().set_level(log_level);
 }
 
+SPDLOG_INLINE void set_level(const std::string &logger_name, level::level_enum log_level) {
+    details::registry::instance().set_level(logger_name, log_level);
+}
+
 SPDLOG_INLINE void flush_on(level::level_enum log_level) {
     details::registry::instance().flush_on(log_level);
 }
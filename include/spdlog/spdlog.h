@@ -11,7 +11,9 @@
 
 #include <spdlog/common.h>
 #include <spdlog/details/registry.h>
+#include <spdlog/details/sampler.h>
 #include <spdlog/details/synchronous_factory.h>
+#include <spdlog/details/throttle.h>
 #include <spdlog/logger.h>
 #include <spdlog/version.h>
 
@@ -51,6 +53,11 @@ SPDLOG_API void initialize_logger(std::shared_ptr<logger> logger);
 // example: spdlog::get("my_logger")->info("hello {}", "world");
 SPDLOG_API std::shared_ptr<logger> get(const std::string &name);
 
+// Same as get(), without updating the reference count of the logger.
+// The pointer is valid as long as the logger is not dropped from the registry.
+// example: static auto *net_logger = spdlog::get_raw("net");
+SPDLOG_API logger *get_raw(const std::string &name);
+
 // Set global formatter. Each sink in each logger will get a clone of this object
 SPDLOG_API void set_formatter(std::unique_ptr<spdlog::formatter> formatter);
 
@@ -74,6 +81,11 @@ SPDLOG_API level::level_enum get_level();
 // Set global logging level
 SPDLOG_API void set_level(level::level_enum log_level);
 
+// Set the level of the logger with the given name and of all the loggers below it in the dot
+// separated hierarchy, including loggers created later.
+// example: spdlog::set_level("net.http", spdlog::level::debug); // also sets "net.http.server"
+SPDLOG_API void set_level(const std::string &logger_name, level::level_enum log_level);
+
 // Determine whether the default logger should log messages with a certain level
 SPDLOG_API bool should_log(level::level_enum lvl);
 
@@ -120,10 +132,10 @@ SPDLOG_API void set_automatic_registration(bool automatic_registration);
 // The default logger can replaced using spdlog::set_default_logger(new_logger).
 // For example, to replace it with a file logger.
 //
-// IMPORTANT:
-// The default API is thread safe (for _mt loggers), but:
-// set_default_logger() *should not* be used concurrently with the default API.
-// e.g do not call set_default_logger() from one thread while calling spdlog::info() from another.
+// The default API is thread safe (for _mt loggers), and set_default_logger() may be called while
+// other threads use it: it waits for the calls that may use the previous default logger to
+// return, and then releases it. default_logger_raw() returns the current default logger without
+// that protection.
 
 SPDLOG_API std::shared_ptr<spdlog::logger> default_logger();
 
@@ -145,52 +157,52 @@ inline void log(source_loc source,
                 level::level_enum lvl,
                 format_string_t<Args...> fmt,
                 Args &&...args) {
-    default_logger_raw()->log(source, lvl, fmt, std::forward<Args>(args)...);
+    details::default_logger_guard()->log(source, lvl, fmt, std::forward<Args>(args)...);
 }
 
 template <typename... Args>
 inline void log(level::level_enum lvl, format_string_t<Args...> fmt, Args &&...args) {
-    default_logger_raw()->log(source_loc{}, lvl, fmt, std::forward<Args>(args)...);
+    details::default_logger_guard()->log(source_loc{}, lvl, fmt, std::forward<Args>(args)...);
 }
 
 template <typename... Args>
 inline void trace(format_string_t<Args...> fmt, Args &&...args) {
-    default_logger_raw()->trace(fmt, std::forward<Args>(args)...);
+    details::default_logger_guard()->trace(fmt, std::forward<Args>(args)...);
 }
 
 template <typename... Args>
 inline void debug(format_string_t<Args...> fmt, Args &&...args) {
-    default_logger_raw()->debug(fmt, std::forward<Args>(args)...);
+    details::default_logger_guard()->debug(fmt, std::forward<Args>(args)...);
 }
 
 template <typename... Args>
 inline void info(format_string_t<Args...> fmt, Args &&...args) {
-    default_logger_raw()->info(fmt, std::forward<Args>(args)...);
+    details::default_logger_guard()->info(fmt, std::forward<Args>(args)...);
 }
 
 template <typename... Args>
 inline void warn(format_string_t<Args...> fmt, Args &&...args) {
-    default_logger_raw()->warn(fmt, std::forward<Args>(args)...);
+    details::default_logger_guard()->warn(fmt, std::forward<Args>(args)...);
 }
 
 template <typename... Args>
 inline void error(format_string_t<Args...> fmt, Args &&...args) {
-    default_logger_raw()->error(fmt, std::forward<Args>(args)...);
+    details::default_logger_guard()->error(fmt, std::forward<Args>(args)...);
 }
 
 template <typename... Args>
 inline void critical(format_string_t<Args...> fmt, Args &&...args) {
-    default_logger_raw()->critical(fmt, std::forward<Args>(args)...);
+    details::default_logger_guard()->critical(fmt, std::forward<Args>(args)...);
 }
 
 template <typename T>
 inline void log(source_loc source, level::level_enum lvl, const T &msg) {
-    default_logger_raw()->log(source, lvl, msg);
+    details::default_logger_guard()->log(source, lvl, msg);
 }
 
 template <typename T>
 inline void log(level::level_enum lvl, const T &msg) {
-    default_logger_raw()->log(lvl, msg);
+    details::default_logger_guard()->log(lvl, msg);
 }
 
 #ifdef SPDLOG_WCHAR_TO_UTF8_SUPPORT
@@ -199,73 +211,73 @@ inline void log(source_loc source,
                 level::level_enum lvl,
                 wformat_string_t<Args...> fmt,
                 Args &&...args) {
-    default_logger_raw()->log(source, lvl, fmt, std::forward<Args>(args)...);
+    details::default_logger_guard()->log(source, lvl, fmt, std::forward<Args>(args)...);
 }
 
 template <typename... Args>
 inline void log(level::level_enum lvl, wformat_string_t<Args...> fmt, Args &&...args) {
-    default_logger_raw()->log(source_loc{}, lvl, fmt, std::forward<Args>(args)...);
+    details::default_logger_guard()->log(source_loc{}, lvl, fmt, std::forward<Args>(args)...);
 }
 
 template <typename... Args>
 inline void trace(wformat_string_t<Args...> fmt, Args &&...args) {
-    default_logger_raw()->trace(fmt, std::forward<Args>(args)...);
+    details::default_logger_guard()->trace(fmt, std::forward<Args>(args)...);
 }
 
 template <typename... Args>
 inline void debug(wformat_string_t<Args...> fmt, Args &&...args) {
-    default_logger_raw()->debug(fmt, std::forward<Args>(args)...);
+    details::default_logger_guard()->debug(fmt, std::forward<Args>(args)...);
 }
 
 template <typename... Args>
 inline void info(wformat_string_t<Args...> fmt, Args &&...args) {
-    default_logger_raw()->info(fmt, std::forward<Args>(args)...);
+    details::default_logger_guard()->info(fmt, std::forward<Args>(args)...);
 }
 
 template <typename... Args>
 inline void warn(wformat_string_t<Args...> fmt, Args &&...args) {
-    default_logger_raw()->warn(fmt, std::forward<Args>(args)...);
+    details::default_logger_guard()->warn(fmt, std::forward<Args>(args)...);
 }
 
 template <typename... Args>
 inline void error(wformat_string_t<Args...> fmt, Args &&...args) {
-    default_logger_raw()->error(fmt, std::forward<Args>(args)...);
+    details::default_logger_guard()->error(fmt, std::forward<Args>(args)...);
 }
 
 template <typename... Args>
 inline void critical(wformat_string_t<Args...> fmt, Args &&...args) {
-    default_logger_raw()->critical(fmt, std::forward<Args>(args)...);
+    details::default_logger_guard()->critical(fmt, std::forward<Args>(args)...);
 }
 #endif
 
 template <typename T>
 inline void trace(const T &msg) {
-    default_logger_raw()->trace(msg);
+    details::default_logger_guard()->trace(msg);
 }
 
 template <typename T>
 inline void debug(const T &msg) {
-    default_logger_raw()->debug(msg);
+    details::default_logger_guard()->debug(msg);
 }
 
 template <typename T>
 inline void info(const T &msg) {
-    default_logger_raw()->info(msg);
+    details::default_logger_guard()->info(msg);
 }
 
 template <typename T>
 inline void warn(const T &msg) {
-    default_logger_raw()->warn(msg);
+    details::default_logger_guard()->warn(msg);
 }
 
 template <typename T>
 inline void error(const T &msg) {
-    default_logger_raw()->error(msg);
+    details::default_logger_guard()->error(msg);
 }
 
 template <typename T>
 inline void critical(const T &msg) {
-    default_logger_raw()->critical(msg);
+    details::default_logger_guard()->critical(msg);
 }
 
 }  // namespace spdlog
@@ -282,67 +294,337 @@ inline void critical(const T &msg) {
 // SPDLOG_LEVEL_CRITICAL,
 // SPDLOG_LEVEL_OFF
 //
+// define SPDLOG_CALLSITE_CACHE to cache the level check at each callsite, and to turn single
+// callsites on or off at runtime in the callsite_registry (see details/callsite.h).
+// the macros then expand to statements instead of expressions.
+//
+
+// the default logger, held until the end of the statement (see set_default_logger())
+#define SPDLOG_DEFAULT_LOGGER_ spdlog::details::default_logger_guard()
 
 #ifndef SPDLOG_NO_SOURCE_LOC
-    #define SPDLOG_LOGGER_CALL(logger, level, ...) \
-        (logger)->log(spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION}, level, __VA_ARGS__)
+    #define SPDLOG_CALLSITE_LOC spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION}
+#else
+    #define SPDLOG_CALLSITE_LOC spdlog::source_loc{}
+#endif
+
+#ifdef SPDLOG_CALLSITE_CACHE
+    #define SPDLOG_CALLSITE_DISPATCH_(action, logger, level, ...)          \
+        if ((action) == spdlog::details::callsite::log) {                  \
+            (logger)->log(SPDLOG_CALLSITE_LOC, level, __VA_ARGS__);        \
+        } else if ((action) == spdlog::details::callsite::force_log) {     \
+            (logger)->log_forced(SPDLOG_CALLSITE_LOC, level, __VA_ARGS__); \
+        }
+    #define SPDLOG_LOGGER_CALL(logger, level, ...)                                      \
+        do {                                                                            \
+            static spdlog::details::callsite spdlog_callsite_{__FILE__, __LINE__,       \
+                                                              SPDLOG_FUNCTION};         \
+            auto &&spdlog_callsite_logger_ = (logger);                                  \
+            auto spdlog_callsite_action_ =                                              \
+                spdlog_callsite_.check(*spdlog_callsite_logger_, level);                \
+            SPDLOG_CALLSITE_DISPATCH_(spdlog_callsite_action_, spdlog_callsite_logger_, \
+                                      level, __VA_ARGS__)                               \
+        } while (0)
+    // the default logger is looked up only when the cached check is stale or enabled
+    #define SPDLOG_DEFAULT_LOGGER_CALL(level, ...)                                          \
+        do {                                                                                \
+            static spdlog::details::callsite spdlog_callsite_{__FILE__, __LINE__,           \
+                                                              SPDLOG_FUNCTION};             \
+            spdlog::details::default_logger_guard::levels spdlog_default_levels_;           \
+            auto spdlog_callsite_action_ = spdlog_callsite_.check(                          \
+                0, level, [&spdlog_default_levels_]() { return &spdlog_default_levels_; }); \
+            SPDLOG_CALLSITE_DISPATCH_(spdlog_callsite_action_,                              \
+                                      spdlog::details::default_logger_guard(), level,       \
+                                      __VA_ARGS__)                                          \
+        } while (0)
+    // gated calls (see below). the level must really be enabled, not only for backtrace.
+    #define SPDLOG_LOGGER_CALL_IF_(logger, level, allowed, ...)                                 \
+        do {                                                                                    \
+            static spdlog::details::callsite spdlog_callsite_{__FILE__, __LINE__,               \
+                                                              SPDLOG_FUNCTION};                 \
+            auto &&spdlog_callsite_logger_ = (logger);                                          \
+            auto spdlog_callsite_action_ =                                                      \
+                spdlog_callsite_.check(*spdlog_callsite_logger_, level);                        \
+            uint64_t spdlog_suppressed_ = 0;                                                    \
+            if ((spdlog_callsite_action_ == spdlog::details::callsite::force_log ||             \
+                 (spdlog_callsite_action_ == spdlog::details::callsite::log &&                  \
+                  spdlog_callsite_logger_->should_log(level))) &&                               \
+                (allowed)) {                                                                    \
+                if (spdlog_suppressed_ > 0) {                                                   \
+                    SPDLOG_CALLSITE_DISPATCH_(spdlog_callsite_action_, spdlog_callsite_logger_, \
+                                              level, "Skipped {} throttled messages..",         \
+                                              spdlog_suppressed_)                               \
+                }                                                                               \
+                SPDLOG_CALLSITE_DISPATCH_(spdlog_callsite_action_, spdlog_callsite_logger_,     \
+                                          level, __VA_ARGS__)                                   \
+            }                                                                                   \
+        } while (0)
 #else
     #define SPDLOG_LOGGER_CALL(logger, level, ...) \
-        (logger)->log(spdlog::source_loc{}, level, __VA_ARGS__)
+        (logger)->log(SPDLOG_CALLSITE_LOC, level, __VA_ARGS__)
+    #define SPDLOG_DEFAULT_LOGGER_CALL(level, ...) \
+        SPDLOG_LOGGER_CALL(SPDLOG_DEFAULT_LOGGER_, level, __VA_ARGS__)
+    #define SPDLOG_LOGGER_CALL_IF_(logger, level, allowed, ...)                        \
+        do {                                                                           \
+            auto &&spdlog_callsite_logger_ = (logger);                                 \
+            uint64_t spdlog_suppressed_ = 0;                                           \
+            if (spdlog_callsite_logger_->should_log(level) && (allowed)) {             \
+                if (spdlog_suppressed_ > 0) {                                          \
+                    spdlog_callsite_logger_->log(SPDLOG_CALLSITE_LOC, level,           \
+                                                 "Skipped {} throttled messages..",    \
+                                                 spdlog_suppressed_);                  \
+                }                                                                      \
+                spdlog_callsite_logger_->log(SPDLOG_CALLSITE_LOC, level, __VA_ARGS__); \
+            }                                                                          \
+        } while (0)
 #endif
 
+//
+// gated calls: SPDLOG_LOGGER_CALL_IF_(logger, level, allowed, ...) logs if the level check passes
+// (the same as SPDLOG_LOGGER_CALL, including the callsite modes with SPDLOG_CALLSITE_CACHE), and
+// then the allowed expression is true. allowed is evaluated before the arguments are formatted,
+// and may set spdlog_suppressed_ to log a "Skipped N throttled messages.." message first.
+//
+// throttled calls:
+// SPDLOG_LOGGER_EVERY_N(logger, level, n, ...)    logs the 1st, n+1th, 2n+1th.. time it's reached
+// SPDLOG_LOGGER_FIRST_N(logger, level, n, ...)    logs the first n times it's reached
+// SPDLOG_LOGGER_EVERY_MS(logger, level, ms, ...)  logs at most once per ms milliseconds, after a
+//                                                 "Skipped N throttled messages.." message
+// and the per level versions: SPDLOG_LOGGER_INFO_EVERY_N(logger, n, ...), SPDLOG_INFO_EVERY_N(n,
+// ...), etc. the state is kept per callsite (see details/throttle.h).
+//
+
+#define SPDLOG_LOGGER_EVERY_N(logger, level, n, ...)                                   \
+    do {                                                                               \
+        static spdlog::details::throttle_every_n spdlog_throttle_;                     \
+        SPDLOG_LOGGER_CALL_IF_(logger, level, spdlog_throttle_.allow(n), __VA_ARGS__); \
+    } while (0)
+
+#define SPDLOG_LOGGER_FIRST_N(logger, level, n, ...)                                   \
+    do {                                                                               \
+        static spdlog::details::throttle_first_n spdlog_throttle_;                     \
+        SPDLOG_LOGGER_CALL_IF_(logger, level, spdlog_throttle_.allow(n), __VA_ARGS__); \
+    } while (0)
+
+#define SPDLOG_LOGGER_EVERY_MS(logger, level, ms, ...)                                        \
+    do {                                                                                      \
+        static spdlog::details::throttle_every_ms spdlog_throttle_;                           \
+        SPDLOG_LOGGER_CALL_IF_(logger, level, spdlog_throttle_.allow(ms, spdlog_suppressed_), \
+                               __VA_ARGS__);                                                  \
+    } while (0)
+
+//
+// sampled calls, gated like the throttled calls:
+// SPDLOG_LOGGER_SAMPLED(logger, level, one_in, ...) logs one in one_in calls, chosen by the hash
+// of the MDC trace id (so a trace is logged entirely or not at all), or randomly if there is none
+// (see details/sampler.h). the per level versions are SPDLOG_LOGGER_INFO_SAMPLED(logger, one_in,
+// ...), SPDLOG_INFO_SAMPLED(one_in, ...), etc. the decisions are counted per callsite, in
+// spdlog::details::sampled_callsites().
+//
+
+#define SPDLOG_LOGGER_SAMPLED(logger, level, one_in, ...)                                   \
+    do {                                                                                    \
+        static spdlog::details::sampled_callsite spdlog_sampler_{__FILE__, __LINE__,        \
+                                                                 SPDLOG_FUNCTION};          \
+        SPDLOG_LOGGER_CALL_IF_(logger, level, spdlog_sampler_.sample(one_in), __VA_ARGS__); \
+    } while (0)
+
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
     #define SPDLOG_LOGGER_TRACE(logger, ...) \
         SPDLOG_LOGGER_CALL(logger, spdlog::level::trace, __VA_ARGS__)
-    #define SPDLOG_TRACE(...) SPDLOG_LOGGER_TRACE(spdlog::default_logger_raw(), __VA_ARGS__)
+    #define SPDLOG_TRACE(...) SPDLOG_DEFAULT_LOGGER_CALL(spdlog::level::trace, __VA_ARGS__)
+    #define SPDLOG_LOGGER_TRACE_EVERY_N(logger, n, ...) \
+        SPDLOG_LOGGER_EVERY_N(logger, spdlog::level::trace, n, __VA_ARGS__)
+    #define SPDLOG_TRACE_EVERY_N(n, ...) \
+        SPDLOG_LOGGER_TRACE_EVERY_N(SPDLOG_DEFAULT_LOGGER_, n, __VA_ARGS__)
+    #define SPDLOG_LOGGER_TRACE_FIRST_N(logger, n, ...) \
+        SPDLOG_LOGGER_FIRST_N(logger, spdlog::level::trace, n, __VA_ARGS__)
+    #define SPDLOG_TRACE_FIRST_N(n, ...) \
+        SPDLOG_LOGGER_TRACE_FIRST_N(SPDLOG_DEFAULT_LOGGER_, n, __VA_ARGS__)
+    #define SPDLOG_LOGGER_TRACE_EVERY_MS(logger, ms, ...) \
+        SPDLOG_LOGGER_EVERY_MS(logger, spdlog::level::trace, ms, __VA_ARGS__)
+    #define SPDLOG_TRACE_EVERY_MS(ms, ...) \
+        SPDLOG_LOGGER_TRACE_EVERY_MS(SPDLOG_DEFAULT_LOGGER_, ms, __VA_ARGS__)
+    #define SPDLOG_LOGGER_TRACE_SAMPLED(logger, one_in, ...) \
+        SPDLOG_LOGGER_SAMPLED(logger, spdlog::level::trace, one_in, __VA_ARGS__)
+    #define SPDLOG_TRACE_SAMPLED(one_in, ...) \
+        SPDLOG_LOGGER_TRACE_SAMPLED(SPDLOG_DEFAULT_LOGGER_, one_in, __VA_ARGS__)
 #else
     #define SPDLOG_LOGGER_TRACE(logger, ...) (void)0
     #define SPDLOG_TRACE(...) (void)0
+    #define SPDLOG_LOGGER_TRACE_EVERY_N(logger, n, ...) (void)0
+    #define SPDLOG_TRACE_EVERY_N(n, ...) (void)0
+    #define SPDLOG_LOGGER_TRACE_FIRST_N(logger, n, ...) (void)0
+    #define SPDLOG_TRACE_FIRST_N(n, ...) (void)0
+    #define SPDLOG_LOGGER_TRACE_EVERY_MS(logger, ms, ...) (void)0
+    #define SPDLOG_TRACE_EVERY_MS(ms, ...) (void)0
+    #define SPDLOG_LOGGER_TRACE_SAMPLED(logger, one_in, ...) (void)0
+    #define SPDLOG_TRACE_SAMPLED(one_in, ...) (void)0
 #endif
 
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
     #define SPDLOG_LOGGER_DEBUG(logger, ...) \
         SPDLOG_LOGGER_CALL(logger, spdlog::level::debug, __VA_ARGS__)
-    #define SPDLOG_DEBUG(...) SPDLOG_LOGGER_DEBUG(spdlog::default_logger_raw(), __VA_ARGS__)
+    #define SPDLOG_DEBUG(...) SPDLOG_DEFAULT_LOGGER_CALL(spdlog::level::debug, __VA_ARGS__)
+    #define SPDLOG_LOGGER_DEBUG_EVERY_N(logger, n, ...) \
+        SPDLOG_LOGGER_EVERY_N(logger, spdlog::level::debug, n, __VA_ARGS__)
+    #define SPDLOG_DEBUG_EVERY_N(n, ...) \
+        SPDLOG_LOGGER_DEBUG_EVERY_N(SPDLOG_DEFAULT_LOGGER_, n, __VA_ARGS__)
+    #define SPDLOG_LOGGER_DEBUG_FIRST_N(logger, n, ...) \
+        SPDLOG_LOGGER_FIRST_N(logger, spdlog::level::debug, n, __VA_ARGS__)
+    #define SPDLOG_DEBUG_FIRST_N(n, ...) \
+        SPDLOG_LOGGER_DEBUG_FIRST_N(SPDLOG_DEFAULT_LOGGER_, n, __VA_ARGS__)
+    #define SPDLOG_LOGGER_DEBUG_EVERY_MS(logger, ms, ...) \
+        SPDLOG_LOGGER_EVERY_MS(logger, spdlog::level::debug, ms, __VA_ARGS__)
+    #define SPDLOG_DEBUG_EVERY_MS(ms, ...) \
+        SPDLOG_LOGGER_DEBUG_EVERY_MS(SPDLOG_DEFAULT_LOGGER_, ms, __VA_ARGS__)
+    #define SPDLOG_LOGGER_DEBUG_SAMPLED(logger, one_in, ...) \
+        SPDLOG_LOGGER_SAMPLED(logger, spdlog::level::debug, one_in, __VA_ARGS__)
+    #define SPDLOG_DEBUG_SAMPLED(one_in, ...) \
+        SPDLOG_LOGGER_DEBUG_SAMPLED(SPDLOG_DEFAULT_LOGGER_, one_in, __VA_ARGS__)
 #else
     #define SPDLOG_LOGGER_DEBUG(logger, ...) (void)0
     #define SPDLOG_DEBUG(...) (void)0
+    #define SPDLOG_LOGGER_DEBUG_EVERY_N(logger, n, ...) (void)0
+    #define SPDLOG_DEBUG_EVERY_N(n, ...) (void)0
+    #define SPDLOG_LOGGER_DEBUG_FIRST_N(logger, n, ...) (void)0
+    #define SPDLOG_DEBUG_FIRST_N(n, ...) (void)0
+    #define SPDLOG_LOGGER_DEBUG_EVERY_MS(logger, ms, ...) (void)0
+    #define SPDLOG_DEBUG_EVERY_MS(ms, ...) (void)0
+    #define SPDLOG_LOGGER_DEBUG_SAMPLED(logger, one_in, ...) (void)0
+    #define SPDLOG_DEBUG_SAMPLED(one_in, ...) (void)0
 #endif
 
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
     #define SPDLOG_LOGGER_INFO(logger, ...) \
         SPDLOG_LOGGER_CALL(logger, spdlog::level::info, __VA_ARGS__)
-    #define SPDLOG_INFO(...) SPDLOG_LOGGER_INFO(spdlog::default_logger_raw(), __VA_ARGS__)
+    #define SPDLOG_INFO(...) SPDLOG_DEFAULT_LOGGER_CALL(spdlog::level::info, __VA_ARGS__)
+    #define SPDLOG_LOGGER_INFO_EVERY_N(logger, n, ...) \
+        SPDLOG_LOGGER_EVERY_N(logger, spdlog::level::info, n, __VA_ARGS__)
+    #define SPDLOG_INFO_EVERY_N(n, ...) \
+        SPDLOG_LOGGER_INFO_EVERY_N(SPDLOG_DEFAULT_LOGGER_, n, __VA_ARGS__)
+    #define SPDLOG_LOGGER_INFO_FIRST_N(logger, n, ...) \
+        SPDLOG_LOGGER_FIRST_N(logger, spdlog::level::info, n, __VA_ARGS__)
+    #define SPDLOG_INFO_FIRST_N(n, ...) \
+        SPDLOG_LOGGER_INFO_FIRST_N(SPDLOG_DEFAULT_LOGGER_, n, __VA_ARGS__)
+    #define SPDLOG_LOGGER_INFO_EVERY_MS(logger, ms, ...) \
+        SPDLOG_LOGGER_EVERY_MS(logger, spdlog::level::info, ms, __VA_ARGS__)
+    #define SPDLOG_INFO_EVERY_MS(ms, ...) \
+        SPDLOG_LOGGER_INFO_EVERY_MS(SPDLOG_DEFAULT_LOGGER_, ms, __VA_ARGS__)
+    #define SPDLOG_LOGGER_INFO_SAMPLED(logger, one_in, ...) \
+        SPDLOG_LOGGER_SAMPLED(logger, spdlog::level::info, one_in, __VA_ARGS__)
+    #define SPDLOG_INFO_SAMPLED(one_in, ...) \
+        SPDLOG_LOGGER_INFO_SAMPLED(SPDLOG_DEFAULT_LOGGER_, one_in, __VA_ARGS__)
 #else
     #define SPDLOG_LOGGER_INFO(logger, ...) (void)0
     #define SPDLOG_INFO(...) (void)0
+    #define SPDLOG_LOGGER_INFO_EVERY_N(logger, n, ...) (void)0
+    #define SPDLOG_INFO_EVERY_N(n, ...) (void)0
+    #define SPDLOG_LOGGER_INFO_FIRST_N(logger, n, ...) (void)0
+    #define SPDLOG_INFO_FIRST_N(n, ...) (void)0
+    #define SPDLOG_LOGGER_INFO_EVERY_MS(logger, ms, ...) (void)0
+    #define SPDLOG_INFO_EVERY_MS(ms, ...) (void)0
+    #define SPDLOG_LOGGER_INFO_SAMPLED(logger, one_in, ...) (void)0
+    #define SPDLOG_INFO_SAMPLED(one_in, ...) (void)0
 #endif
 
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
     #define SPDLOG_LOGGER_WARN(logger, ...) \
         SPDLOG_LOGGER_CALL(logger, spdlog::level::warn, __VA_ARGS__)
-    #define SPDLOG_WARN(...) SPDLOG_LOGGER_WARN(spdlog::default_logger_raw(), __VA_ARGS__)
+    #define SPDLOG_WARN(...) SPDLOG_DEFAULT_LOGGER_CALL(spdlog::level::warn, __VA_ARGS__)
+    #define SPDLOG_LOGGER_WARN_EVERY_N(logger, n, ...) \
+        SPDLOG_LOGGER_EVERY_N(logger, spdlog::level::warn, n, __VA_ARGS__)
+    #define SPDLOG_WARN_EVERY_N(n, ...) \
+        SPDLOG_LOGGER_WARN_EVERY_N(SPDLOG_DEFAULT_LOGGER_, n, __VA_ARGS__)
+    #define SPDLOG_LOGGER_WARN_FIRST_N(logger, n, ...) \
+        SPDLOG_LOGGER_FIRST_N(logger, spdlog::level::warn, n, __VA_ARGS__)
+    #define SPDLOG_WARN_FIRST_N(n, ...) \
+        SPDLOG_LOGGER_WARN_FIRST_N(SPDLOG_DEFAULT_LOGGER_, n, __VA_ARGS__)
+    #define SPDLOG_LOGGER_WARN_EVERY_MS(logger, ms, ...) \
+        SPDLOG_LOGGER_EVERY_MS(logger, spdlog::level::warn, ms, __VA_ARGS__)
+    #define SPDLOG_WARN_EVERY_MS(ms, ...) \
+        SPDLOG_LOGGER_WARN_EVERY_MS(SPDLOG_DEFAULT_LOGGER_, ms, __VA_ARGS__)
+    #define SPDLOG_LOGGER_WARN_SAMPLED(logger, one_in, ...) \
+        SPDLOG_LOGGER_SAMPLED(logger, spdlog::level::warn, one_in, __VA_ARGS__)
+    #define SPDLOG_WARN_SAMPLED(one_in, ...) \
+        SPDLOG_LOGGER_WARN_SAMPLED(SPDLOG_DEFAULT_LOGGER_, one_in, __VA_ARGS__)
 #else
     #define SPDLOG_LOGGER_WARN(logger, ...) (void)0
     #define SPDLOG_WARN(...) (void)0
+    #define SPDLOG_LOGGER_WARN_EVERY_N(logger, n, ...) (void)0
+    #define SPDLOG_WARN_EVERY_N(n, ...) (void)0
+    #define SPDLOG_LOGGER_WARN_FIRST_N(logger, n, ...) (void)0
+    #define SPDLOG_WARN_FIRST_N(n, ...) (void)0
+    #define SPDLOG_LOGGER_WARN_EVERY_MS(logger, ms, ...) (void)0
+    #define SPDLOG_WARN_EVERY_MS(ms, ...) (void)0
+    #define SPDLOG_LOGGER_WARN_SAMPLED(logger, one_in, ...) (void)0
+    #define SPDLOG_WARN_SAMPLED(one_in, ...) (void)0
 #endif
 
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_ERROR
     #define SPDLOG_LOGGER_ERROR(logger, ...) \
         SPDLOG_LOGGER_CALL(logger, spdlog::level::err, __VA_ARGS__)
-    #define SPDLOG_ERROR(...) SPDLOG_LOGGER_ERROR(spdlog::default_logger_raw(), __VA_ARGS__)
+    #define SPDLOG_ERROR(...) SPDLOG_DEFAULT_LOGGER_CALL(spdlog::level::err, __VA_ARGS__)
+    #define SPDLOG_LOGGER_ERROR_EVERY_N(logger, n, ...) \
+        SPDLOG_LOGGER_EVERY_N(logger, spdlog::level::err, n, __VA_ARGS__)
+    #define SPDLOG_ERROR_EVERY_N(n, ...) \
+        SPDLOG_LOGGER_ERROR_EVERY_N(SPDLOG_DEFAULT_LOGGER_, n, __VA_ARGS__)
+    #define SPDLOG_LOGGER_ERROR_FIRST_N(logger, n, ...) \
+        SPDLOG_LOGGER_FIRST_N(logger, spdlog::level::err, n, __VA_ARGS__)
+    #define SPDLOG_ERROR_FIRST_N(n, ...) \
+        SPDLOG_LOGGER_ERROR_FIRST_N(SPDLOG_DEFAULT_LOGGER_, n, __VA_ARGS__)
+    #define SPDLOG_LOGGER_ERROR_EVERY_MS(logger, ms, ...) \
+        SPDLOG_LOGGER_EVERY_MS(logger, spdlog::level::err, ms, __VA_ARGS__)
+    #define SPDLOG_ERROR_EVERY_MS(ms, ...) \
+        SPDLOG_LOGGER_ERROR_EVERY_MS(SPDLOG_DEFAULT_LOGGER_, ms, __VA_ARGS__)
+    #define SPDLOG_LOGGER_ERROR_SAMPLED(logger, one_in, ...) \
+        SPDLOG_LOGGER_SAMPLED(logger, spdlog::level::err, one_in, __VA_ARGS__)
+    #define SPDLOG_ERROR_SAMPLED(one_in, ...) \
+        SPDLOG_LOGGER_ERROR_SAMPLED(SPDLOG_DEFAULT_LOGGER_, one_in, __VA_ARGS__)
 #else
     #define SPDLOG_LOGGER_ERROR(logger, ...) (void)0
     #define SPDLOG_ERROR(...) (void)0
+    #define SPDLOG_LOGGER_ERROR_EVERY_N(logger, n, ...) (void)0
+    #define SPDLOG_ERROR_EVERY_N(n, ...) (void)0
+    #define SPDLOG_LOGGER_ERROR_FIRST_N(logger, n, ...) (void)0
+    #define SPDLOG_ERROR_FIRST_N(n, ...) (void)0
+    #define SPDLOG_LOGGER_ERROR_EVERY_MS(logger, ms, ...) (void)0
+    #define SPDLOG_ERROR_EVERY_MS(ms, ...) (void)0
+    #define SPDLOG_LOGGER_ERROR_SAMPLED(logger, one_in, ...) (void)0
+    #define SPDLOG_ERROR_SAMPLED(one_in, ...) (void)0
 #endif
 
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_CRITICAL
     #define SPDLOG_LOGGER_CRITICAL(logger, ...) \
         SPDLOG_LOGGER_CALL(logger, spdlog::level::critical, __VA_ARGS__)
-    #define SPDLOG_CRITICAL(...) SPDLOG_LOGGER_CRITICAL(spdlog::default_logger_raw(), __VA_ARGS__)
+    #define SPDLOG_CRITICAL(...) SPDLOG_DEFAULT_LOGGER_CALL(spdlog::level::critical, __VA_ARGS__)
+    #define SPDLOG_LOGGER_CRITICAL_EVERY_N(logger, n, ...) \
+        SPDLOG_LOGGER_EVERY_N(logger, spdlog::level::critical, n, __VA_ARGS__)
+    #define SPDLOG_CRITICAL_EVERY_N(n, ...) \
+        SPDLOG_LOGGER_CRITICAL_EVERY_N(SPDLOG_DEFAULT_LOGGER_, n, __VA_ARGS__)
+    #define SPDLOG_LOGGER_CRITICAL_FIRST_N(logger, n, ...) \
+        SPDLOG_LOGGER_FIRST_N(logger, spdlog::level::critical, n, __VA_ARGS__)
+    #define SPDLOG_CRITICAL_FIRST_N(n, ...) \
+        SPDLOG_LOGGER_CRITICAL_FIRST_N(SPDLOG_DEFAULT_LOGGER_, n, __VA_ARGS__)
+    #define SPDLOG_LOGGER_CRITICAL_EVERY_MS(logger, ms, ...) \
+        SPDLOG_LOGGER_EVERY_MS(logger, spdlog::level::critical, ms, __VA_ARGS__)
+    #define SPDLOG_CRITICAL_EVERY_MS(ms, ...) \
+        SPDLOG_LOGGER_CRITICAL_EVERY_MS(SPDLOG_DEFAULT_LOGGER_, ms, __VA_ARGS__)
+    #define SPDLOG_LOGGER_CRITICAL_SAMPLED(logger, one_in, ...) \
+        SPDLOG_LOGGER_SAMPLED(logger, spdlog::level::critical, one_in, __VA_ARGS__)
+    #define SPDLOG_CRITICAL_SAMPLED(one_in, ...) \
+        SPDLOG_LOGGER_CRITICAL_SAMPLED(SPDLOG_DEFAULT_LOGGER_, one_in, __VA_ARGS__)
 #else
     #define SPDLOG_LOGGER_CRITICAL(logger, ...) (void)0
     #define SPDLOG_CRITICAL(...) (void)0
+    #define SPDLOG_LOGGER_CRITICAL_EVERY_N(logger, n, ...) (void)0
+    #define SPDLOG_CRITICAL_EVERY_N(n, ...) (void)0
+    #define SPDLOG_LOGGER_CRITICAL_FIRST_N(logger, n, ...) (void)0
+    #define SPDLOG_CRITICAL_FIRST_N(n, ...) (void)0
+    #define SPDLOG_LOGGER_CRITICAL_EVERY_MS(logger, ms, ...) (void)0
+    #define SPDLOG_CRITICAL_EVERY_MS(ms, ...) (void)0
+    #define SPDLOG_LOGGER_CRITICAL_SAMPLED(logger, one_in, ...) (void)0
+    #define SPDLOG_CRITICAL_SAMPLED(one_in, ...) (void)0
 #endif
 
 #ifdef SPDLOG_HEADER_ONLY
@@ -139,3 +139,18 @@
 // # define SPDLOG_FUNCTION __FUNCTION__
 // #endif
 ///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// Uncomment to format the messages kept only for backtrace right away.
+// By default their arguments are stored unformatted (if they are numbers or strings),
+// and formatted only when the backtrace is dumped.
+//
+// #define SPDLOG_NO_LAZY_BACKTRACE
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// Uncomment and change to set the MDC key of the trace id used for sampling
+// (see details/sampler.h). Defaults to "trace_id".
+//
+// #define SPDLOG_SAMPLING_TRACE_KEY "trace_id"
+///////////////////////////////////////////////////////////////////////////////
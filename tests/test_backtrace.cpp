@@ -71,3 +71,69 @@ TEST_CASE("bactrace-async", "[bactrace]") {
     REQUIRE(test_sink->lines()[6] == "debug message 99");
     REQUIRE(test_sink->lines()[7] == "****************** Backtrace End ********************");
 }
+
+TEST_CASE("bactrace-concurrent", "[bactrace]") {
+    using spdlog::sinks::test_sink_mt;
+    auto test_sink = std::make_shared<test_sink_mt>();
+    size_t backtrace_size = 64;
+    spdlog::logger logger("test-bactrace-concurrent", test_sink);
+    logger.set_pattern("%v");
+    logger.enable_backtrace(backtrace_size);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&logger, t]() {
+            for (int i = 0; i < 10000; i++) {
+                logger.debug("thread {} message {}", t, i);
+            }
+        });
+    }
+    // dumps may run while the threads log
+    logger.dump_backtrace();
+    for (auto &t : threads) {
+        t.join();
+    }
+    auto dumped_before = test_sink->lines().size();
+    logger.dump_backtrace();
+    auto lines = test_sink->lines();
+    REQUIRE(lines.size() == dumped_before + backtrace_size + 2);
+    REQUIRE(lines.back() == "****************** Backtrace End ********************");
+    // the messages are complete and in order
+    int last_i[4] = {-1, -1, -1, -1};
+    for (size_t n = dumped_before + 1; n < lines.size() - 1; n++) {
+        int t = -1, i = -1;
+        REQUIRE(std::sscanf(lines[n].c_str(), "thread %d message %d", &t, &i) == 2);
+        REQUIRE(lines[n] == fmt::format("thread {} message {}", t, i));
+        REQUIRE(i > last_i[t]);
+        last_i[t] = i;
+    }
+}
+
+TEST_CASE("bactrace-lazy-args", "[bactrace]") {
+    using spdlog::sinks::test_sink_st;
+    auto test_sink = std::make_shared<test_sink_st>();
+
+    spdlog::logger logger("test-backtrace", test_sink);
+    logger.set_pattern("%v");
+    logger.enable_backtrace(10);
+
+    {
+        std::string temp = "temporary";
+        const char *cstr = "cstr";
+        logger.debug("{} {} {:.2f} {} {} {} {}", 42, -7L, 3.14159, true, 'c', temp, cstr);
+        temp = "changed";
+    }
+    logger.debug("{:>5}|{:x}|{}", spdlog::string_view_t("sv"), 255u, 1.5f);
+    logger.debug("plain message");
+    logger.debug("{}", std::vector<int>{1, 2}.size());
+    // types not supported by lazy_format are formatted right away
+    logger.debug("{}", static_cast<const void *>(nullptr));
+
+    logger.dump_backtrace();
+    REQUIRE(test_sink->lines().size() == 7);
+    REQUIRE(test_sink->lines()[1] == "42 -7 3.14 true c temporary cstr");
+    REQUIRE(test_sink->lines()[2] == "   sv|ff|1.5");
+    REQUIRE(test_sink->lines()[3] == "plain message");
+    REQUIRE(test_sink->lines()[4] == "2");
+    REQUIRE(test_sink->lines()[5] == "0x0");
+}
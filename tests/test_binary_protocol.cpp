@@ -0,0 +1,83 @@
+/*
+ * This content is released under the MIT License as specified in
+ * https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
+ */
+#include "includes.h"
+#include "test_sink.h"
+#include "spdlog/details/binary_protocol.h"
+
+using spdlog::details::binary_decoder;
+using spdlog::details::binary_encoder;
+using spdlog::details::log_msg;
+
+TEST_CASE("binary_protocol_varint", "[binary_protocol]") {
+    using namespace spdlog::details::binary_protocol;
+    for (uint64_t n : {uint64_t(0), uint64_t(1), uint64_t(127), uint64_t(128), uint64_t(300),
+                       uint64_t(1) << 40, ~uint64_t(0)}) {
+        spdlog::memory_buf_t buf;
+        append_varint(n, buf);
+        const char *pos = buf.data();
+        uint64_t decoded;
+        REQUIRE(read_varint(pos, buf.data() + buf.size(), decoded));
+        REQUIRE(decoded == n);
+        REQUIRE(pos == buf.data() + buf.size());
+    }
+    for (int64_t n : {int64_t(0), int64_t(-1), int64_t(1), int64_t(-1000000), int64_t(1000000)}) {
+        REQUIRE(unzigzag(zigzag(n)) == n);
+    }
+}
+
+TEST_CASE("binary_protocol_roundtrip", "[binary_protocol]") {
+    auto now = spdlog::log_clock::now();
+    std::vector<log_msg> msgs;
+    msgs.emplace_back(now, spdlog::source_loc{"file.cpp", 10, "func"}, "logger1",
+                      spdlog::level::info, "message 1");
+    msgs.emplace_back(now - std::chrono::milliseconds(5), spdlog::source_loc{}, "logger2",
+                      spdlog::level::err, "message 2");
+    msgs.emplace_back(now + std::chrono::seconds(1), spdlog::source_loc{"file.cpp", 10, "func"},
+                      "logger1", spdlog::level::critical, "");
+    msgs[1].thread_id = 1234;
+
+    spdlog::memory_buf_t stream;
+    binary_encoder encoder;
+    encoder.reset(stream);
+    for (const auto &msg : msgs) {
+        encoder.encode(msg, stream);
+    }
+
+    // feed one byte at a time to exercise incomplete frames
+    std::vector<std::string> decoded;
+    binary_decoder decoder;
+    for (size_t i = 0; i < stream.size(); i++) {
+        decoder.feed(stream.data() + i, 1, [&](const log_msg &msg) {
+            auto &expected = msgs[decoded.size()];
+            REQUIRE(msg.time == expected.time);
+            REQUIRE(msg.level == expected.level);
+            REQUIRE(msg.thread_id == expected.thread_id);
+            REQUIRE(msg.source.line == expected.source.line);
+            if (!expected.source.empty()) {
+                REQUIRE(std::string(msg.source.filename) == expected.source.filename);
+                REQUIRE(std::string(msg.source.funcname) == expected.source.funcname);
+            }
+            decoded.emplace_back(msg.payload.data(), msg.payload.size());
+            REQUIRE(std::string(msg.logger_name.data(), msg.logger_name.size()) ==
+                    std::string(expected.logger_name.data(), expected.logger_name.size()));
+        });
+    }
+    REQUIRE(decoded == std::vector<std::string>{"message 1", "message 2", ""});
+
+    // the decoded messages can be passed to any sink
+    auto sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    sink->set_pattern("[%n] [%l] %v");
+    spdlog::memory_buf_t more;
+    encoder.encode(msgs[0], more);
+    decoder.feed(more.data(), more.size(), [&](const log_msg &msg) { sink->log(msg); });
+    REQUIRE(sink->lines() == std::vector<std::string>{"[logger1] [info] message 1"});
+}
+
+TEST_CASE("binary_protocol_invalid", "[binary_protocol]") {
+    binary_decoder decoder;
+    const char garbage[] = {5, 0, 'X', 'X', 'X', 'X', 1};
+    REQUIRE_THROWS_AS(decoder.feed(garbage, sizeof(garbage), [](const log_msg &) {}),
+                      spdlog::spdlog_ex);
+}
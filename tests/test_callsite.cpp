@@ -0,0 +1,178 @@
+/*
+ * This content is released under the MIT License as specified in
+ * https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
+ */
+#define SPDLOG_CALLSITE_CACHE
+#include "includes.h"
+#include "test_sink.h"
+#include "spdlog/cfg/argv.h"
+
+static void log_debug(spdlog::logger *logger, int i) { SPDLOG_LOGGER_DEBUG(logger, "debug {}", i); }
+
+TEST_CASE("callsite_cache", "[callsite]") {
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    spdlog::logger logger("callsite", test_sink);
+    logger.set_pattern("%v");
+
+    for (int i = 0; i < 10; i++) {
+        log_debug(&logger, i);
+    }
+    REQUIRE(test_sink->msg_counter() == 0);
+
+    // level changes invalidate the cached checks
+    logger.set_level(spdlog::level::debug);
+    log_debug(&logger, 1);
+    REQUIRE(test_sink->msg_counter() == 1);
+    logger.set_level(spdlog::level::info);
+    log_debug(&logger, 2);
+    REQUIRE(test_sink->msg_counter() == 1);
+
+    // the same callsite with another logger
+    auto other_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    spdlog::logger other("other", other_sink);
+    other.set_level(spdlog::level::debug);
+    log_debug(&other, 3);
+    log_debug(&logger, 4);
+    REQUIRE(other_sink->msg_counter() == 1);
+    REQUIRE(test_sink->msg_counter() == 1);
+
+    // backtrace needs the disabled messages too
+    logger.enable_backtrace(4);
+    log_debug(&logger, 5);
+    logger.dump_backtrace();
+    REQUIRE(test_sink->lines().size() == 4);
+    REQUIRE(test_sink->lines()[2] == "debug 5");
+    logger.disable_backtrace();
+}
+
+TEST_CASE("callsite_cache_default_logger", "[callsite]") {
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    auto logger = std::make_shared<spdlog::logger>("callsite_default", test_sink);
+    logger->set_pattern("%v");
+    auto prev_default = spdlog::default_logger();
+    spdlog::set_default_logger(logger);
+
+    for (int i = 0; i < 3; i++) {
+        SPDLOG_DEBUG("debug {}", i);
+        SPDLOG_INFO("info {}", i);
+    }
+    REQUIRE(test_sink->msg_counter() == 3);
+
+    auto new_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    auto new_logger = std::make_shared<spdlog::logger>("callsite_default2", new_sink);
+    new_logger->set_level(spdlog::level::debug);
+    spdlog::set_default_logger(new_logger);
+    for (int i = 0; i < 3; i++) {
+        SPDLOG_DEBUG("debug {}", i);
+    }
+    REQUIRE(new_sink->msg_counter() == 3);
+    REQUIRE(test_sink->msg_counter() == 3);
+
+    spdlog::set_default_logger(prev_default);
+    spdlog::drop("callsite_default");
+    spdlog::drop("callsite_default2");
+}
+
+static int registry_test_line = 0;
+
+static void registry_test_log(spdlog::logger *logger, int i) {
+    registry_test_line = __LINE__ + 1;
+    SPDLOG_LOGGER_DEBUG(logger, "debug {}", i);
+    SPDLOG_LOGGER_INFO(logger, "info {}", i);
+}
+
+TEST_CASE("callsite_registry", "[callsite]") {
+    using spdlog::details::callsite_mode;
+    auto &callsites = spdlog::details::callsite_registry::instance();
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    spdlog::logger logger("callsite_registry", test_sink);
+    logger.set_pattern("%v");
+
+    registry_test_log(&logger, 1);
+    REQUIRE(test_sink->lines() == std::vector<std::string>{"info 1"});
+    auto sites = callsites.callsites();
+    auto it = std::find_if(sites.begin(), sites.end(), [](const spdlog::details::callsite_info &s) {
+        return s.line == registry_test_line;
+    });
+    REQUIRE(it != sites.end());
+    REQUIRE(ends_with(it->filename, "test_callsite.cpp"));
+    REQUIRE(it->mode == callsite_mode::level);
+
+    // turn on the debug statement by file:line, without changing the logger level
+    auto spec = "tests/test_callsite.cpp:" + std::to_string(registry_test_line);
+    REQUIRE(callsites.set_mode(spec, callsite_mode::on) == 1);
+    REQUIRE(callsites.set_mode("callsite.cpp:" + std::to_string(registry_test_line),
+                               callsite_mode::on) == 0);  // not at a path separator
+    registry_test_log(&logger, 2);
+    REQUIRE(test_sink->lines() == std::vector<std::string>{"info 1", "debug 2", "info 2"});
+    REQUIRE(logger.level() == spdlog::level::info);
+
+    // turn off the whole function
+    REQUIRE(callsites.set_mode("registry_test_log", callsite_mode::off) == 2);
+    registry_test_log(&logger, 3);
+    REQUIRE(test_sink->msg_counter() == 3);
+
+    callsites.reset();
+    registry_test_log(&logger, 4);
+    REQUIRE(test_sink->lines().back() == "info 4");
+    REQUIRE(test_sink->msg_counter() == 4);
+}
+
+static void cfg_test_log(spdlog::logger *logger) {
+    SPDLOG_LOGGER_DEBUG(logger, "debug");
+    SPDLOG_LOGGER_INFO(logger, "info");
+}
+
+TEST_CASE("callsite_registry_cfg", "[callsite]") {
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    spdlog::logger logger("callsite_cfg", test_sink);
+    logger.set_pattern("%v");
+
+    // rules apply to callsites reached later
+    const char *argv[] = {"ignore", "SPDLOG_CALLSITES=cfg_test_log, test_callsite.cpp=OFF"};
+    spdlog::cfg::load_argv_callsites(2, argv);
+    cfg_test_log(&logger);
+    REQUIRE(test_sink->msg_counter() == 0);
+
+    spdlog::cfg::helpers::load_callsites("test_callsite.cpp=level,cfg_test_log=on");
+    cfg_test_log(&logger);
+    REQUIRE(test_sink->lines() == std::vector<std::string>{"debug", "info"});
+    spdlog::details::callsite_registry::instance().reset();
+}
+
+static void throttled_test_log(spdlog::logger *logger, int i) {
+    SPDLOG_LOGGER_DEBUG_EVERY_N(logger, 2, "every_n {}", i);
+    SPDLOG_LOGGER_DEBUG_FIRST_N(logger, 1, "first_n {}", i);
+    SPDLOG_LOGGER_DEBUG_SAMPLED(logger, 1, "sampled {}", i);
+}
+
+TEST_CASE("callsite_registry_throttled", "[callsite]") {
+    using spdlog::details::callsite_mode;
+    auto &callsites = spdlog::details::callsite_registry::instance();
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    spdlog::logger logger("callsite_throttled", test_sink);
+    logger.set_pattern("%v");
+
+    // the throttled and sampled macros are cached callsites too: turned on, they are throttled
+    // as usual
+    throttled_test_log(&logger, 0);
+    REQUIRE(test_sink->msg_counter() == 0);
+    REQUIRE(callsites.set_mode("throttled_test_log", callsite_mode::on) == 3);
+    for (int i = 1; i <= 4; i++) {
+        throttled_test_log(&logger, i);
+    }
+    REQUIRE(test_sink->lines() ==
+            std::vector<std::string>{"every_n 1", "first_n 1", "sampled 1", "sampled 2",
+                                     "every_n 3", "sampled 3", "sampled 4"});
+    REQUIRE(logger.level() == spdlog::level::info);
+
+    logger.set_level(spdlog::level::debug);
+    REQUIRE(callsites.set_mode("throttled_test_log", callsite_mode::off) == 3);
+    throttled_test_log(&logger, 5);
+    REQUIRE(test_sink->msg_counter() == 7);
+
+    callsites.reset();
+    throttled_test_log(&logger, 6);
+    REQUIRE(test_sink->lines().back() == "sampled 6");
+    REQUIRE(test_sink->msg_counter() == 9);
+}
@@ -167,3 +167,36 @@ TEST_CASE("restore-to-default", "[cfg]") {
     load_argv_levels(2, argv);
     REQUIRE(spdlog::default_logger()->level() == spdlog::level::info);
 }
+
+TEST_CASE("hierarchical-levels", "[cfg]") {
+    spdlog::drop_all();
+    auto net = spdlog::create<test_sink_st>("net");
+    auto http = spdlog::create<test_sink_st>("net.http");
+    auto server = spdlog::create<test_sink_st>("net.http.server");
+    auto network = spdlog::create<test_sink_st>("network");
+
+    spdlog::cfg::helpers::load_levels("warn,net=error,net.http=debug");
+    REQUIRE(net->level() == spdlog::level::err);
+    REQUIRE(http->level() == spdlog::level::debug);
+    REQUIRE(server->level() == spdlog::level::debug);
+    REQUIRE(network->level() == spdlog::level::warn);
+
+    // loggers created later inherit the level of their closest parent
+    auto client = spdlog::create<test_sink_st>("net.http.client");
+    auto dns = spdlog::create<test_sink_st>("net.dns");
+    REQUIRE(client->level() == spdlog::level::debug);
+    REQUIRE(dns->level() == spdlog::level::err);
+
+    // setting a subtree keeps the levels of the longer prefixes
+    spdlog::set_level("net.http.server", spdlog::level::trace);
+    spdlog::set_level("net", spdlog::level::critical);
+    REQUIRE(net->level() == spdlog::level::critical);
+    REQUIRE(dns->level() == spdlog::level::critical);
+    REQUIRE(http->level() == spdlog::level::debug);
+    REQUIRE(server->level() == spdlog::level::trace);
+    REQUIRE(network->level() == spdlog::level::warn);
+
+    spdlog::cfg::helpers::load_levels("info");
+    spdlog::drop_all();
+    spdlog::set_default_logger(spdlog::create<test_sink_st>("cfg-default"));
+}
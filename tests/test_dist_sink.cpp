@@ -0,0 +1,106 @@
+/*
+ * This content is released under the MIT License as specified in
+ * https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
+ */
+#include "includes.h"
+#include "test_sink.h"
+#include "spdlog/sinks/dist_sink.h"
+
+#include <future>
+
+// a sink that doesn't log anything until released
+class blocked_sink : public spdlog::sinks::test_sink_mt {
+public:
+    void release() { released_.set_value(); }
+
+protected:
+    void sink_it_(const spdlog::details::log_msg &msg) override {
+        released_future_.wait();
+        spdlog::sinks::test_sink_mt::sink_it_(msg);
+    }
+
+private:
+    std::promise<void> released_;
+    std::shared_future<void> released_future_{released_.get_future()};
+};
+
+TEST_CASE("dist_sink", "[dist_sink]") {
+    auto sink1 = std::make_shared<spdlog::sinks::test_sink_st>();
+    auto sink2 = std::make_shared<spdlog::sinks::test_sink_st>();
+    auto dist = std::make_shared<spdlog::sinks::dist_sink_mt>();
+    dist->add_sink(sink1);
+    dist->add_sink(sink2);
+    sink2->set_level(spdlog::level::warn);
+
+    spdlog::logger logger("dist", dist);
+    logger.set_pattern("%v");
+    logger.info("info");
+    logger.warn("warn");
+    REQUIRE(sink1->lines() == std::vector<std::string>{"info", "warn"});
+    REQUIRE(sink2->lines() == std::vector<std::string>{"warn"});
+
+    dist->remove_sink(sink1);
+    logger.error("error");
+    REQUIRE(sink1->msg_counter() == 2);
+    REQUIRE(sink2->msg_counter() == 2);
+}
+
+TEST_CASE("dist_sink_queued", "[dist_sink]") {
+    auto fast_sink = std::make_shared<spdlog::sinks::test_sink_mt>();
+    auto slow_sink = std::make_shared<blocked_sink>();
+    auto dist = std::make_shared<spdlog::sinks::dist_sink_mt>();
+    dist->add_sink(fast_sink);
+    dist->add_queued_sink(slow_sink);
+
+    spdlog::logger logger("dist", dist);
+    logger.set_pattern("%v");
+    // the blocked sink doesn't hold up the logging thread or the other sinks
+    for (int i = 0; i < 5; i++) {
+        logger.info("message {}", i);
+    }
+    slow_sink->release();
+    REQUIRE(fast_sink->msg_counter() == 5);
+
+    // removing the queued sink waits until it logged its queue, in order
+    dist->remove_sink(slow_sink);
+    REQUIRE(slow_sink->lines() == fast_sink->lines());
+    REQUIRE(dist->queued_dropped_messages() == 0);
+}
+
+TEST_CASE("dist_sink_queued_remove", "[dist_sink]") {
+    auto fast_sink = std::make_shared<spdlog::sinks::test_sink_mt>();
+    auto slow_sink = std::make_shared<blocked_sink>();
+    auto dist = std::make_shared<spdlog::sinks::dist_sink_mt>();
+    dist->add_sink(fast_sink);
+    dist->add_queued_sink(slow_sink);
+
+    spdlog::details::log_msg msg("dist", spdlog::level::info, "message");
+    dist->log(msg);
+    // removing the queued sink waits for its queue, without holding up the other sinks
+    auto removed = std::async(std::launch::async, [&] { dist->remove_sink(slow_sink); });
+    REQUIRE(removed.wait_for(std::chrono::milliseconds(100)) == std::future_status::timeout);
+    auto logged = std::async(std::launch::async, [&] { dist->log(msg); });
+    auto logged_status = logged.wait_for(std::chrono::seconds(5));
+    slow_sink->release();
+    removed.get();
+    logged.get();
+    REQUIRE(logged_status == std::future_status::ready);
+    REQUIRE(fast_sink->msg_counter() == 2);
+    REQUIRE(slow_sink->msg_counter() == 1);
+}
+
+TEST_CASE("dist_sink_queued_discard", "[dist_sink]") {
+    auto slow_sink = std::make_shared<spdlog::sinks::test_sink_mt>();
+    slow_sink->set_delay(std::chrono::milliseconds(10));
+    auto dist = std::make_shared<spdlog::sinks::dist_sink_st>();
+    dist->add_queued_sink(slow_sink, 4, spdlog::async_overflow_policy::discard_new);
+
+    spdlog::details::log_msg msg("dist", spdlog::level::info, "message");
+    for (int i = 0; i < 20; i++) {
+        dist->log(msg);
+    }
+    auto dropped = dist->queued_dropped_messages();
+    REQUIRE(dropped > 0);
+    dist->remove_sink(slow_sink);
+    REQUIRE(slow_sink->msg_counter() + dropped == 20);
+}
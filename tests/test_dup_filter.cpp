@@ -1,4 +1,5 @@
 #include "includes.h"
+#include "spdlog/sinks/dedup_sink.h"
 #include "spdlog/sinks/dup_filter_sink.h"
 #include "test_sink.h"
 
@@ -81,3 +82,54 @@ TEST_CASE("dup_filter_test5", "[dup_filter_sink]") {
             3);  // skip 2 messages but log the "skipped.." message before message2
     REQUIRE(test_sink->lines()[1] == "Skipped 2 duplicate messages..");
 }
+
+TEST_CASE("dedup_sink_interleaved", "[dedup_sink]") {
+    using spdlog::sinks::dedup_sink_st;
+    using spdlog::sinks::test_sink_mt;
+
+    dedup_sink_st dedup{std::chrono::seconds{5}};
+    auto test_sink = std::make_shared<test_sink_mt>();
+    test_sink->set_pattern("%v");
+    dedup.add_sink(test_sink);
+
+    for (int i = 0; i < 10; i++) {
+        dedup.log(spdlog::details::log_msg{"test", spdlog::level::info, "message1"});
+        dedup.log(spdlog::details::log_msg{"test", spdlog::level::info, "message2"});
+        dedup.log(spdlog::details::log_msg{"test", spdlog::level::warn, "message1"});
+        dedup.log(spdlog::details::log_msg{"other", spdlog::level::info, "message1"});
+    }
+
+    REQUIRE(test_sink->lines() ==
+            std::vector<std::string>{"message1", "message2", "message1", "message1"});
+    REQUIRE(dedup.suppressed_messages() == 36);
+    REQUIRE(dedup.summaries() == 0);
+}
+
+TEST_CASE("dedup_sink_summary", "[dedup_sink]") {
+    using spdlog::sinks::dedup_sink_st;
+    using spdlog::sinks::test_sink_mt;
+
+    dedup_sink_st dedup{std::chrono::milliseconds{20}};
+    auto test_sink = std::make_shared<test_sink_mt>();
+    test_sink->set_pattern("%n %v");
+    dedup.add_sink(test_sink);
+
+    for (int i = 0; i < 5; i++) {
+        dedup.log(spdlog::details::log_msg{"test", spdlog::level::err, "disk full"});
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    // another message triggers the summary
+    dedup.log(spdlog::details::log_msg{"test", spdlog::level::info, "other"});
+    dedup.log(spdlog::details::log_msg{"test", spdlog::level::err, "disk full"});
+
+    REQUIRE(test_sink->lines() ==
+            std::vector<std::string>{"test disk full",
+                                     "test Suppressed 4 occurrences of \"disk full\"",
+                                     "test other", "test disk full"});
+    REQUIRE(dedup.summaries() == 1);
+
+    dedup.log(spdlog::details::log_msg{"test", spdlog::level::err, "disk full"});
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    dedup.flush();
+    REQUIRE(test_sink->lines().back() == "test Suppressed 1 occurrences of \"disk full\"");
+}
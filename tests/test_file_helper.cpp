@@ -167,3 +167,101 @@ TEST_CASE("file_helper_open", "[file_helper]") {
     target_filename += SPDLOG_FILENAME_T("/invalid");
     REQUIRE_THROWS_AS(helper.open(target_filename), spdlog::spdlog_ex);
 }
+
+#ifndef _WIN32
+    #include "spdlog/details/direct_file_helper.h"
+
+TEST_CASE("direct_file_helper", "[file_helper]") {
+    prepare_logdir();
+    spdlog::filename_t target_filename = SPDLOG_FILENAME_T(TEST_FILENAME);
+    spdlog::memory_buf_t formatted;
+    spdlog::fmt_lib::format_to(std::back_inserter(formatted), "{}", std::string(5000, '1'));
+    {
+        spdlog::details::direct_file_helper helper{spdlog::file_event_handlers{}};
+        helper.open(target_filename);
+        helper.write(formatted);
+        helper.flush();
+        REQUIRE(helper.size() == 5000);
+        // the file is extended to the block boundary until closed
+        REQUIRE(get_filesize(TEST_FILENAME) == 8192);
+
+        // the partial last block is rewritten by the next flush
+        helper.write(formatted);
+        helper.flush();
+        REQUIRE(helper.size() == 10000);
+        REQUIRE(get_filesize(TEST_FILENAME) == 12288);
+    }
+    REQUIRE(get_filesize(TEST_FILENAME) == 10000);
+
+    // reopen continues after the existing content
+    {
+        spdlog::details::direct_file_helper helper{spdlog::file_event_handlers{}};
+        helper.open(target_filename);
+        REQUIRE(helper.size() == 10000);
+        helper.preallocate(64 * 1024);
+        helper.write(formatted);
+    }
+    REQUIRE(file_contents(TEST_FILENAME) == std::string(15000, '1'));
+
+    // the padding left by a process that died before close() is trimmed on open
+    // (a copy of the open file stands for it)
+    const std::string crashed_filename = "test_logs/direct_file_helper_crashed";
+    auto copy_file = [](const std::string &from, const std::string &to) {
+        std::ofstream(to, std::ios::binary | std::ios::trunc) << file_contents(from);
+    };
+    {
+        spdlog::details::direct_file_helper helper{spdlog::file_event_handlers{}};
+        helper.open(target_filename);
+        helper.write(formatted);
+        helper.flush();
+        copy_file(TEST_FILENAME, crashed_filename);
+    }
+    REQUIRE(get_filesize(crashed_filename) == 20480);
+    {
+        spdlog::details::direct_file_helper helper{spdlog::file_event_handlers{}};
+        helper.open(SPDLOG_FILENAME_T("test_logs/direct_file_helper_crashed"));
+        REQUIRE(helper.size() == 20000);
+        helper.write(formatted);
+    }
+    REQUIRE(file_contents(crashed_filename) == std::string(25000, '1'));
+
+    // the padding may extend into the next block when the last one has no room for its trailer
+    spdlog::memory_buf_t almost_block;
+    spdlog::fmt_lib::format_to(std::back_inserter(almost_block), "{}", std::string(4090, '2'));
+    {
+        spdlog::details::direct_file_helper helper{spdlog::file_event_handlers{}};
+        helper.open(target_filename, true);
+        helper.write(almost_block);
+        helper.flush();
+        copy_file(TEST_FILENAME, crashed_filename);
+    }
+    REQUIRE(get_filesize(crashed_filename) == 8192);
+    {
+        spdlog::details::direct_file_helper helper{spdlog::file_event_handlers{}};
+        helper.open(SPDLOG_FILENAME_T("test_logs/direct_file_helper_crashed"));
+        REQUIRE(helper.size() == 4090);
+    }
+    REQUIRE(file_contents(crashed_filename) == std::string(4090, '2'));
+
+    // zero bytes that were logged are kept
+    spdlog::memory_buf_t zeros;
+    zeros.append(std::string(4096 - 10000 % 4096, '\0'));
+    {
+        spdlog::details::direct_file_helper helper{spdlog::file_event_handlers{}};
+        helper.open(target_filename, true);
+        helper.write(formatted);
+        helper.write(formatted);
+        helper.write(zeros);
+    }
+    REQUIRE(get_filesize(TEST_FILENAME) == 12288);
+    {
+        spdlog::details::direct_file_helper helper{spdlog::file_event_handlers{}};
+        helper.open(target_filename);
+        REQUIRE(helper.size() == 12288);
+    }
+
+    spdlog::details::direct_file_helper helper;
+    helper.open(target_filename, true);
+    REQUIRE(helper.size() == 0);
+}
+#endif
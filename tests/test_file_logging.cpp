@@ -3,6 +3,9 @@
  * https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
  */
 #include "includes.h"
+#include "spdlog/sinks/durable_file_sink.h"
+#include "spdlog/sinks/hybrid_rotating_file_sink.h"
+#include "spdlog/sinks/sharded_file_sink.h"
 
 #define SIMPLE_LOG "test_logs/simple_log"
 #define ROTATING_LOG "test_logs/rotating_log"
@@ -101,3 +104,197 @@ TEST_CASE("rotating_file_logger3", "[rotating_logger]") {
     REQUIRE_THROWS_AS(spdlog::rotating_logger_mt("logger", basename, max_size, 0),
                       spdlog::spdlog_ex);
 }
+
+TEST_CASE("rotating_file_logger_preallocate", "[rotating_logger]") {
+    prepare_logdir();
+    size_t max_size = 1024 * 10;
+    spdlog::filename_t basename = SPDLOG_FILENAME_T(ROTATING_LOG);
+    {
+        auto sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
+            basename, max_size, 2, false, spdlog::file_event_handlers{}, true);
+        spdlog::logger logger("logger", sink);
+        for (int i = 0; i < 1000; i++) {
+            logger.info("Test message {}", i);
+        }
+    }
+    // the reserved space is released on rotation and on close
+    REQUIRE(get_filesize(ROTATING_LOG) <= max_size);
+    REQUIRE(get_filesize(ROTATING_LOG ".1") <= max_size);
+    REQUIRE(get_filesize(ROTATING_LOG ".1") > max_size / 2);
+}
+
+TEST_CASE("hybrid_rotating_file_logger_size", "[hybrid_rotating_logger]") {
+    prepare_logdir();
+    size_t max_size = 1024;
+    size_t max_total_size = 1024 * 3;
+    spdlog::filename_t basename = SPDLOG_FILENAME_T(ROTATING_LOG);
+    auto logger = spdlog::hybrid_rotating_logger_mt("logger", basename, max_size,
+                                                    std::chrono::seconds(0), 10, max_total_size);
+    for (int i = 0; i < 1000; i++) {
+        logger->info("Test message {}", i);
+    }
+    logger->flush();
+
+    // the total size limit leaves room for only 2 rotated files
+    REQUIRE(get_filesize(ROTATING_LOG) <= max_size);
+    REQUIRE(get_filesize(ROTATING_LOG ".1") <= max_size);
+    REQUIRE(get_filesize(ROTATING_LOG ".2") <= max_size);
+    REQUIRE_FALSE(spdlog::details::os::path_exists(SPDLOG_FILENAME_T(ROTATING_LOG ".3")));
+}
+
+TEST_CASE("hybrid_rotating_file_logger_time", "[hybrid_rotating_logger]") {
+    prepare_logdir();
+    spdlog::filename_t basename = SPDLOG_FILENAME_T(ROTATING_LOG);
+    auto sink = std::make_shared<spdlog::sinks::hybrid_rotating_file_sink_st>(
+        basename, 0, std::chrono::seconds(60), 3);
+    sink->set_pattern("%v");
+
+    auto now = spdlog::log_clock::now();
+    auto log_at = [&](spdlog::log_clock::time_point tp, spdlog::string_view_t text) {
+        sink->log(spdlog::details::log_msg(tp, spdlog::source_loc{}, "test", spdlog::level::info,
+                                           text));
+    };
+    log_at(now, "1");
+    log_at(now, "2");
+    // each message after the next minute boundary starts a new file
+    log_at(now + std::chrono::minutes(2), "3");
+    log_at(now + std::chrono::minutes(4), "4");
+    log_at(now + std::chrono::minutes(4), "5");
+    sink->flush();
+
+    using spdlog::details::os::default_eol;
+    REQUIRE(file_contents(ROTATING_LOG) ==
+            spdlog::fmt_lib::format("4{}5{}", default_eol, default_eol));
+    REQUIRE(file_contents(ROTATING_LOG ".1") == spdlog::fmt_lib::format("3{}", default_eol));
+    REQUIRE(file_contents(ROTATING_LOG ".2") ==
+            spdlog::fmt_lib::format("1{}2{}", default_eol, default_eol));
+}
+
+TEST_CASE("hybrid_rotating_file_logger_time_total_size", "[hybrid_rotating_logger]") {
+    prepare_logdir();
+    spdlog::filename_t basename = SPDLOG_FILENAME_T(ROTATING_LOG);
+    // time only rotation: the total size limit applies to the rotated files only
+    const size_t line_size = 3 + strlen(spdlog::details::os::default_eol);
+    auto sink = std::make_shared<spdlog::sinks::hybrid_rotating_file_sink_st>(
+        basename, 0, std::chrono::seconds(60), 10, 2 * line_size);
+    sink->set_pattern("%v");
+
+    auto now = spdlog::log_clock::now();
+    for (int i = 0; i < 4; i++) {
+        sink->log(spdlog::details::log_msg(now + std::chrono::minutes(2 * i), spdlog::source_loc{},
+                                           "test", spdlog::level::info,
+                                           std::string(3, static_cast<char>('a' + i))));
+    }
+    sink->flush();
+
+    using spdlog::details::os::default_eol;
+    REQUIRE(file_contents(ROTATING_LOG) == spdlog::fmt_lib::format("ddd{}", default_eol));
+    REQUIRE(file_contents(ROTATING_LOG ".1") == spdlog::fmt_lib::format("ccc{}", default_eol));
+    REQUIRE(file_contents(ROTATING_LOG ".2") == spdlog::fmt_lib::format("bbb{}", default_eol));
+    REQUIRE_FALSE(spdlog::details::os::path_exists(SPDLOG_FILENAME_T(ROTATING_LOG ".3")));
+}
+
+TEST_CASE("durable_file_logger", "[durable_logger]") {
+    prepare_logdir();
+    spdlog::filename_t filename = SPDLOG_FILENAME_T(SIMPLE_LOG);
+    auto sink = std::make_shared<spdlog::sinks::durable_file_sink>(filename, spdlog::level::err);
+    spdlog::logger logger("durable", sink);
+    logger.set_pattern("%v");
+
+    logger.info("Test message {}", 1);
+    REQUIRE(sink->sync_count() == 0);
+
+    // durable message returns only after it was synced, together with the previous one
+    logger.error("Test message {}", 2);
+    REQUIRE(sink->sync_count() == 1);
+    require_message_count(SIMPLE_LOG, 2);
+
+    // concurrent durable messages share syncs
+    const int n_threads = 8;
+    const int n_messages = 100;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; t++) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < n_messages; i++) {
+                logger.error("Test message {}", i);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    require_message_count(SIMPLE_LOG, 2 + n_threads * n_messages);
+}
+
+TEST_CASE("durable_file_logger_group_commit", "[durable_logger]") {
+    prepare_logdir();
+    spdlog::filename_t filename = SPDLOG_FILENAME_T(SIMPLE_LOG);
+    // the threads that log while a sync is done (or during the interval after it) wait for the
+    // next one together
+    auto sink = std::make_shared<spdlog::sinks::durable_file_sink>(
+        filename, spdlog::level::err, std::chrono::milliseconds(10));
+    spdlog::logger logger("durable", sink);
+    logger.set_pattern("%v");
+
+    const int n_threads = 8;
+    const int n_messages = 20;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; t++) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < n_messages; i++) {
+                logger.error("Test message {}", i);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    require_message_count(SIMPLE_LOG, n_threads * n_messages);
+    // each thread waits for a sync per message, so at least n_messages syncs are needed. with
+    // no sharing there would be one per message.
+    REQUIRE(sink->sync_count() >= static_cast<size_t>(n_messages));
+    REQUIRE(sink->sync_count() < static_cast<size_t>(n_threads * n_messages / 2));
+}
+
+TEST_CASE("sharded_file_logger", "[sharded_logger]") {
+    prepare_logdir();
+    spdlog::filename_t basename = SPDLOG_FILENAME_T(SIMPLE_LOG);
+    const size_t n_shards = 4;
+    const int n_threads = 4;
+    const int n_messages = 100;
+    {
+        auto sink = std::make_shared<spdlog::sinks::sharded_file_sink>(basename, n_shards);
+        REQUIRE(sink->n_shards() == n_shards);
+        spdlog::logger logger("sharded", sink);
+        logger.set_pattern("%v");
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < n_threads; t++) {
+            threads.emplace_back([&logger, t] {
+                for (int i = 0; i < n_messages; i++) {
+                    logger.info("{:03} {}", i, t);
+                }
+            });
+        }
+        for (auto &t : threads) {
+            t.join();
+        }
+    }
+
+    // each thread wrote to its own shard
+    for (size_t i = 0; i < n_shards; i++) {
+        auto shard_filename = spdlog::sinks::sharded_file_sink::shard_filename(basename, i);
+        REQUIRE(count_lines(spdlog::details::os::filename_to_str(shard_filename)) ==
+                static_cast<size_t>(n_messages));
+    }
+
+    spdlog::filename_t merged = SPDLOG_FILENAME_T("test_logs/merged_log");
+    REQUIRE(spdlog::sinks::sharded_file_sink::merge_shards(basename, n_shards, merged) ==
+            static_cast<size_t>(n_threads * n_messages));
+    std::ifstream in("test_logs/merged_log");
+    std::string prev, line;
+    while (std::getline(in, line)) {
+        REQUIRE(prev <= line);
+        prev = line;
+    }
+}
@@ -0,0 +1,105 @@
+/*
+ * This content is released under the MIT License as specified in
+ * https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
+ */
+#include "includes.h"
+#include "spdlog/sinks/flight_recorder_sink.h"
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// the lines written to a pipe by f(write_fd)
+template <typename F>
+static std::vector<std::string> pipe_lines(F &&f) {
+    int fds[2];
+    REQUIRE(::pipe(fds) == 0);
+    f(fds[1]);
+    ::close(fds[1]);
+    std::string output;
+    char buf[4096];
+    ssize_t n;
+    while ((n = ::read(fds[0], buf, sizeof(buf))) > 0) {
+        output.append(buf, static_cast<size_t>(n));
+    }
+    ::close(fds[0]);
+
+    std::vector<std::string> lines;
+    std::istringstream stream(output);
+    for (std::string line; std::getline(stream, line);) {
+        // drop the time and thread id
+        auto pos = line.find("] ");
+        lines.push_back(pos == std::string::npos ? line : line.substr(pos + 2));
+    }
+    return lines;
+}
+
+TEST_CASE("flight_recorder_dump", "[flight_recorder]") {
+    spdlog::sinks::flight_recorder_config config;
+    config.messages_per_thread = 3;
+    config.max_message_size = 20;
+    auto recorder = std::make_shared<spdlog::sinks::flight_recorder_sink>(config);
+    spdlog::logger logger("recorder", recorder);
+    logger.set_level(spdlog::level::trace);
+
+    for (int i = 0; i < 10; i++) {
+        logger.debug("message {}", i);
+    }
+    logger.warn("a message longer than max_message_size");
+
+    auto lines = pipe_lines([&](int fd) { REQUIRE(recorder->dump(fd)); });
+    REQUIRE(lines == std::vector<std::string>{"[debug] [recorder] message 8",
+                                              "[debug] [recorder] message 9",
+                                              "[warning] [recorder] a message lo"});
+    REQUIRE(recorder->dropped_messages() == 0);
+}
+
+TEST_CASE("flight_recorder_threads", "[flight_recorder]") {
+    spdlog::sinks::flight_recorder_config config;
+    config.max_threads = 8;
+    config.messages_per_thread = 2;
+    auto recorder = std::make_shared<spdlog::sinks::flight_recorder_sink>(config);
+    spdlog::logger logger("recorder", recorder);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&logger, t]() {
+            for (int i = 0; i < 100; i++) {
+                logger.info("thread {} message {}", t, i);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    auto lines = pipe_lines([&](int fd) { REQUIRE(recorder->dump(fd)); });
+    // threads sharing a ring may drop messages, but the last message of each ring is kept
+    REQUIRE(lines.size() + recorder->dropped_messages() >= 4);
+    for (const auto &line : lines) {
+        REQUIRE(line.find("[info] [recorder] thread ") == 0);
+    }
+}
+
+TEST_CASE("flight_recorder_crash_handler", "[flight_recorder]") {
+    auto lines = pipe_lines([](int fd) {
+        auto pid = ::fork();
+        REQUIRE(pid >= 0);
+        if (pid == 0) {
+            // without the handler of the test framework
+            ::signal(SIGABRT, SIG_DFL);
+            auto recorder = std::make_shared<spdlog::sinks::flight_recorder_sink>();
+            spdlog::logger logger("crash", recorder);
+            recorder->install_crash_handler(fd);
+            logger.info("before the crash");
+            logger.error("last words");
+            std::abort();
+        }
+        int status = 0;
+        REQUIRE(::waitpid(pid, &status, 0) == pid);
+        REQUIRE(WIFSIGNALED(status));
+        REQUIRE(WTERMSIG(status) == SIGABRT);
+    });
+    REQUIRE(lines == std::vector<std::string>{"[info] [crash] before the crash",
+                                              "[error] [crash] last words"});
+}
@@ -0,0 +1,150 @@
+/*
+ * This content is released under the MIT License as specified in
+ * https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
+ */
+#include "includes.h"
+#include "spdlog/sinks/formatted_ringbuffer_sink.h"
+
+using spdlog::sinks::formatted_ringbuffer_sink;
+
+TEST_CASE("formatted_ringbuffer_basic", "[formatted_ringbuffer]") {
+    auto ring = std::make_shared<formatted_ringbuffer_sink>(4096);
+    REQUIRE(ring->capacity() == 4096);
+    spdlog::logger logger("ring", ring);
+    logger.set_pattern("[%n] %v");
+
+    REQUIRE(ring->last_formatted().empty());
+    logger.info("Hello {}", 1);
+    logger.info("Hello {}", 2);
+
+    auto eol = std::string(spdlog::details::os::default_eol);
+    REQUIRE(ring->last_formatted() ==
+            std::vector<std::string>{"[ring] Hello 1" + eol, "[ring] Hello 2" + eol});
+    REQUIRE(ring->last_formatted(1) == std::vector<std::string>{"[ring] Hello 2" + eol});
+
+    std::string all;
+    REQUIRE(ring->read([&all](spdlog::string_view_t first, spdlog::string_view_t second) {
+        all.append(first.data(), first.size());
+        all.append(second.data(), second.size());
+    }));
+    REQUIRE(all == "[ring] Hello 1" + eol + "[ring] Hello 2" + eol);
+}
+
+TEST_CASE("formatted_ringbuffer_overwrite", "[formatted_ringbuffer]") {
+    // rounded up to 512 bytes
+    auto ring = std::make_shared<formatted_ringbuffer_sink>(500);
+    REQUIRE(ring->capacity() == 512);
+    spdlog::logger logger("ring", ring);
+    logger.set_pattern("%v");
+
+    for (int i = 0; i < 1000; i++) {
+        logger.info("message {:04}", i);
+    }
+    auto messages = ring->last_formatted();
+    REQUIRE(!messages.empty());
+    // each record takes 8 + 16 bytes
+    REQUIRE(messages.size() <= 512 / 24);
+    auto eol = std::string(spdlog::details::os::default_eol);
+    auto first = 1000 - static_cast<int>(messages.size());
+    for (size_t i = 0; i < messages.size(); i++) {
+        REQUIRE(messages[i] == fmt::format("message {:04}", first + static_cast<int>(i)) + eol);
+    }
+
+    // messages larger than the ring are dropped
+    logger.info(std::string(1000, 'x'));
+    REQUIRE(ring->dropped_messages() == 1);
+    REQUIRE(ring->last_formatted().back() == "message 0999" + eol);
+}
+
+TEST_CASE("formatted_ringbuffer_threads", "[formatted_ringbuffer]") {
+    auto ring = std::make_shared<formatted_ringbuffer_sink>(64 * 1024);
+    spdlog::logger logger("ring", ring);
+    logger.set_pattern("%v");
+
+    std::atomic<bool> done{false};
+    std::atomic<bool> reader_ok{true};
+    std::thread reader([&]() {
+        while (!done) {
+            for (const auto &msg : ring->last_formatted()) {
+                if (msg.find("thread ") != 0) {
+                    reader_ok = false;
+                }
+            }
+        }
+    });
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; t++) {
+        writers.emplace_back([&logger, t]() {
+            for (int i = 0; i < 10000; i++) {
+                logger.info("thread {} message {}", t, i);
+            }
+        });
+    }
+    for (auto &w : writers) {
+        w.join();
+    }
+    done = true;
+    reader.join();
+    REQUIRE(reader_ok);
+
+    // the messages of each writer are in order, and the newest one is the last of its writer
+    auto messages = ring->last_formatted();
+    REQUIRE(!messages.empty());
+    std::vector<int> last_seen(4, -1);
+    for (const auto &msg : messages) {
+        int t = 0, i = 0;
+        REQUIRE(std::sscanf(msg.c_str(), "thread %d message %d", &t, &i) == 2);
+        REQUIRE(i > last_seen[static_cast<size_t>(t)]);
+        last_seen[static_cast<size_t>(t)] = i;
+    }
+    REQUIRE(messages.back().find(" message 9999") != std::string::npos);
+}
+
+TEST_CASE("formatted_ringbuffer_lapped_writers", "[formatted_ringbuffer]") {
+    // a small ring, so writers are often lapped while they copy
+    auto ring = std::make_shared<formatted_ringbuffer_sink>(512);
+    spdlog::logger logger("ring", ring);
+    logger.set_pattern("%v");
+
+    std::atomic<bool> done{false};
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; t++) {
+        writers.emplace_back([&logger, t]() {
+            for (int i = 0; i < 20000; i++) {
+                logger.info("{0} {1} {0} {1}", t, i);
+            }
+        });
+    }
+    std::thread stopper([&]() {
+        for (auto &w : writers) {
+            w.join();
+        }
+        done = true;
+    });
+
+    // every message returned by a successful read() is intact
+    size_t valid_reads = 0, bad_messages = 0;
+    std::vector<std::string> messages;
+    while (!done) {
+        messages.clear();
+        bool valid =
+            ring->read([&messages](spdlog::string_view_t first, spdlog::string_view_t second) {
+                messages.emplace_back(first.data(), first.size());
+                messages.back().append(second.data(), second.size());
+            });
+        if (!valid) {
+            continue;
+        }
+        valid_reads++;
+        for (const auto &msg : messages) {
+            int t1 = -1, i1 = -1, t2 = -2, i2 = -2;
+            if (std::sscanf(msg.c_str(), "%d %d %d %d", &t1, &i1, &t2, &i2) != 4 || t1 != t2 ||
+                i1 != i2) {
+                bad_messages++;
+            }
+        }
+    }
+    stopper.join();
+    REQUIRE(bad_messages == 0);
+    REQUIRE(!ring->last_formatted().empty());
+}
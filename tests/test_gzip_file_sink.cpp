@@ -0,0 +1,138 @@
+/*
+ * This content is released under the MIT License as specified in
+ * https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
+ */
+#include "includes.h"
+#include "spdlog/sinks/gzip_file_sink.h"
+
+#define GZIP_LOG "test_logs/gzip_log.gz"
+#define ROTATING_GZIP_LOG "test_logs/rotating_gzip_log.gz"
+
+// decompress the whole (possibly multi member) gzip file
+static std::string gunzip_contents(const std::string &filename) {
+    std::string rv;
+    gzFile gz = gzopen(filename.c_str(), "rb");
+    if (gz == nullptr) {
+        throw std::runtime_error("Failed open file " + filename);
+    }
+    char buf[4096];
+    int n;
+    while ((n = gzread(gz, buf, sizeof(buf))) > 0) {
+        rv.append(buf, static_cast<size_t>(n));
+    }
+    gzclose(gz);
+    return rv;
+}
+
+TEST_CASE("gzip_file_logger", "[gzip_file_sink]") {
+    prepare_logdir();
+    spdlog::filename_t filename = SPDLOG_FILENAME_T(GZIP_LOG);
+
+    auto logger = spdlog::basic_gzip_logger_mt("logger", filename);
+    logger->set_pattern("%v");
+
+    logger->info("Test message {}", 1);
+    logger->info("Test message {}", 2);
+    logger->flush();
+
+    using spdlog::details::os::default_eol;
+    REQUIRE(gunzip_contents(GZIP_LOG) ==
+            spdlog::fmt_lib::format("Test message 1{}Test message 2{}", default_eol, default_eol));
+
+    // the file must remain readable after each flush
+    logger->info("Test message {}", 3);
+    logger->flush();
+    REQUIRE(gunzip_contents(GZIP_LOG) ==
+            spdlog::fmt_lib::format("Test message 1{}Test message 2{}Test message 3{}",
+                                    default_eol, default_eol, default_eol));
+}
+
+TEST_CASE("gzip_file_logger_append", "[gzip_file_sink]") {
+    prepare_logdir();
+    spdlog::filename_t filename = SPDLOG_FILENAME_T(GZIP_LOG);
+    {
+        auto logger = spdlog::basic_gzip_logger_st("logger", filename);
+        logger->set_pattern("%v");
+        logger->info("first");
+        spdlog::drop(logger->name());
+    }
+    auto logger = spdlog::basic_gzip_logger_st("logger", filename);
+    logger->set_pattern("%v");
+    logger->info("second");
+    logger->flush();
+
+    using spdlog::details::os::default_eol;
+    REQUIRE(gunzip_contents(GZIP_LOG) ==
+            spdlog::fmt_lib::format("first{}second{}", default_eol, default_eol));
+}
+
+TEST_CASE("rotating_gzip_file_logger", "[gzip_file_sink]") {
+    prepare_logdir();
+    size_t max_size = 1024 * 4;
+    spdlog::filename_t basename = SPDLOG_FILENAME_T(ROTATING_GZIP_LOG);
+    auto logger = spdlog::rotating_gzip_logger_mt("logger", basename, max_size, 2);
+    logger->set_pattern("%v");
+
+    // compresses well, so the limit should apply to the compressed size and not rotate
+    for (int i = 0; i < 1000; i++) {
+        logger->info("Test message {}", i % 10);
+    }
+    logger->flush();
+    REQUIRE(get_filesize(ROTATING_GZIP_LOG) <= max_size);
+    REQUIRE(count_files("test_logs") == 1);
+    REQUIRE(gunzip_contents(ROTATING_GZIP_LOG).size() > max_size);
+
+    // does not compress well, so must rotate
+    for (int i = 0; i < 2000; i++) {
+        logger->info("Test message {}", i * 7919);
+    }
+    logger->flush();
+    REQUIRE(get_filesize(ROTATING_GZIP_LOG) <= max_size);
+    REQUIRE(get_filesize("test_logs/rotating_gzip_log.1.gz") <= max_size);
+}
+
+// number of gzip members in the file (each flush ends one)
+static size_t count_gzip_members(const std::string &filename) {
+    std::ifstream ifs(filename, std::ios::binary);
+    std::string compressed((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    z_stream stream{};
+    if (inflateInit2(&stream, 15 + 16) != Z_OK) {
+        throw std::runtime_error("inflateInit2 failed");
+    }
+    stream.next_in = reinterpret_cast<Bytef *>(&compressed[0]);
+    stream.avail_in = static_cast<uInt>(compressed.size());
+    size_t members = 0;
+    char out[4096];
+    while (stream.avail_in > 0) {
+        stream.next_out = reinterpret_cast<Bytef *>(out);
+        stream.avail_out = sizeof(out);
+        int rv = inflate(&stream, Z_NO_FLUSH);
+        if (rv == Z_STREAM_END) {
+            members++;
+            inflateReset(&stream);
+        } else if (rv != Z_OK) {
+            break;
+        }
+    }
+    inflateEnd(&stream);
+    return members;
+}
+
+TEST_CASE("rotating_gzip_file_logger_size_checks", "[gzip_file_sink]") {
+    prepare_logdir();
+    size_t max_size = 1024 * 16;
+    spdlog::filename_t basename = SPDLOG_FILENAME_T(ROTATING_GZIP_LOG);
+    spdlog::sinks::rotating_gzip_file_sink_st sink(basename, max_size, 2);
+    sink.set_pattern("%v");
+
+    std::string payload;
+    for (int i = 0; i < 20000; i++) {
+        payload = "Test message " + std::to_string(i * 7919);
+        sink.log(spdlog::details::log_msg("logger", spdlog::level::info, payload));
+    }
+    // the compressed size is checked (ending a gzip member) only a few times per file
+    REQUIRE(count_gzip_members("test_logs/rotating_gzip_log.1.gz") <= 10);
+    REQUIRE(get_filesize("test_logs/rotating_gzip_log.1.gz") <= max_size);
+    REQUIRE(get_filesize("test_logs/rotating_gzip_log.1.gz") >= max_size - max_size / 8);
+    REQUIRE(get_filesize("test_logs/rotating_gzip_log.2.gz") <= max_size);
+}
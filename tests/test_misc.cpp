@@ -104,6 +104,51 @@ TEST_CASE("clone-logger", "[clone]") {
     spdlog::drop_all();
 }
 
+TEST_CASE("add_remove_sinks", "[sinks]") {
+    using spdlog::sinks::test_sink_mt;
+    auto sink1 = std::make_shared<test_sink_mt>();
+    auto sink2 = std::make_shared<test_sink_mt>();
+    spdlog::logger logger("sinks", sink1);
+
+    // swap the sinks back and forth while other threads log
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&] {
+            while (!stop) {
+                logger.info("message");
+            }
+        });
+    }
+    for (int i = 0; i < 100; i++) {
+        logger.add_sink(sink2);
+        logger.remove_sink(sink1);
+        logger.set_sinks({sink1});
+    }
+    stop = true;
+    for (auto &t : threads) {
+        t.join();
+    }
+    REQUIRE(logger.sinks() == std::vector<spdlog::sink_ptr>{sink1});
+
+    auto count1 = sink1->msg_counter();
+    auto count2 = sink2->msg_counter();
+    logger.add_sink(sink2);
+    logger.info("message");
+    REQUIRE(logger.sinks().size() == 2);
+    REQUIRE(sink1->msg_counter() == count1 + 1);
+    REQUIRE(sink2->msg_counter() == count2 + 1);
+
+    logger.remove_sink(sink1);
+    logger.info("message");
+    REQUIRE(sink1->msg_counter() == count1 + 1);
+    REQUIRE(sink2->msg_counter() == count2 + 2);
+
+    // the clone gets the current sinks
+    auto cloned = logger.clone("cloned");
+    REQUIRE(cloned->sinks() == std::vector<spdlog::sink_ptr>{sink2});
+}
+
 TEST_CASE("clone async", "[clone]") {
     using spdlog::sinks::test_sink_st;
     spdlog::init_thread_pool(4, 1);
@@ -0,0 +1,408 @@
+/*
+ * This content is released under the MIT License as specified in
+ * https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
+ */
+#include "includes.h"
+#include "test_sink.h"
+#include "spdlog/sinks/binary_tcp_sink.h"
+#include "spdlog/sinks/buffered_tcp_sink.h"
+#include "spdlog/sinks/native_syslog_sink.h"
+#include "spdlog/sinks/udp_sink.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// loopback tcp server that accepts one connection and collects everything sent to it
+class tcp_test_server {
+public:
+    tcp_test_server() {
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        REQUIRE(listen_fd_ != -1);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        REQUIRE(::bind(listen_fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0);
+        REQUIRE(::listen(listen_fd_, 1) == 0);
+        socklen_t len = sizeof(addr);
+        REQUIRE(::getsockname(listen_fd_, reinterpret_cast<sockaddr *>(&addr), &len) == 0);
+        port_ = ntohs(addr.sin_port);
+        thread_ = std::thread([this] {
+            int fd = ::accept(listen_fd_, nullptr, nullptr);
+            if (fd == -1) {
+                return;
+            }
+            char buf[4096];
+            ssize_t n;
+            while ((n = ::read(fd, buf, sizeof(buf))) > 0) {
+                received_.append(buf, static_cast<size_t>(n));
+            }
+            ::close(fd);
+        });
+    }
+
+    ~tcp_test_server() {
+        ::shutdown(listen_fd_, SHUT_RDWR);
+        ::close(listen_fd_);
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    int port() const { return port_; }
+
+    // wait for the client to disconnect and return what it sent
+    std::string received() {
+        thread_.join();
+        return received_;
+    }
+
+private:
+    int listen_fd_ = -1;
+    int port_ = 0;
+    std::thread thread_;
+    std::string received_;
+};
+
+TEST_CASE("buffered_tcp_sink", "[tcp_sink]") {
+    tcp_test_server server;
+    std::string expected;
+    size_t sent_bytes;
+    {
+        spdlog::sinks::buffered_tcp_sink_config config("127.0.0.1", server.port());
+        auto sink = std::make_shared<spdlog::sinks::buffered_tcp_sink_mt>(config);
+        spdlog::logger logger("tcp", sink);
+        logger.set_pattern("%v");
+        for (int i = 0; i < 1000; i++) {
+            logger.info("Test message {}", i);
+            expected += spdlog::fmt_lib::format("Test message {}{}", i,
+                                                spdlog::details::os::default_eol);
+        }
+        logger.flush();
+        sent_bytes = sink->sent_bytes();
+        REQUIRE(sink->dropped_messages() == 0);
+    }
+    // the destructor sends what was left in the buffer
+    REQUIRE(server.received() == expected);
+    REQUIRE(sent_bytes <= expected.size());
+}
+
+TEST_CASE("buffered_tcp_sink_no_server", "[tcp_sink]") {
+    int port;
+    {
+        // a port that nobody listens on
+        tcp_test_server closed_server;
+        port = closed_server.port();
+    }
+    spdlog::sinks::buffered_tcp_sink_config config("127.0.0.1", port);
+    config.buffer_size = 100;
+    auto sink = std::make_shared<spdlog::sinks::buffered_tcp_sink_mt>(config);
+    spdlog::logger logger("tcp", sink);
+    logger.set_pattern("%v");
+
+    // logging doesn't block, and what doesn't fit in the buffer is dropped
+    for (int i = 0; i < 20; i++) {
+        logger.info("Test message {}", i);
+    }
+    logger.flush();
+    REQUIRE(sink->sent_bytes() == 0);
+    REQUIRE(sink->dropped_messages() >= 20 - 100 / 15);
+    REQUIRE_FALSE(sink->connected());
+}
+
+TEST_CASE("buffered_tcp_sink_stalled_server", "[tcp_sink]") {
+    // a server that never reads: its connection is accepted by the kernel, then the data fills
+    // the socket buffers and the send blocks
+    int listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    REQUIRE(listen_fd != -1);
+    int rcvbuf = 4096;
+    ::setsockopt(listen_fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    REQUIRE(::bind(listen_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0);
+    REQUIRE(::listen(listen_fd, 16) == 0);
+    socklen_t len = sizeof(addr);
+    REQUIRE(::getsockname(listen_fd, reinterpret_cast<sockaddr *>(&addr), &len) == 0);
+
+    std::chrono::steady_clock::time_point start;
+    {
+        spdlog::sinks::buffered_tcp_sink_config config("127.0.0.1", ntohs(addr.sin_port));
+        config.buffer_size = 64 * 1024 * 1024;
+        config.send_timeout = std::chrono::milliseconds(200);
+        auto sink = std::make_shared<spdlog::sinks::buffered_tcp_sink_mt>(config);
+        spdlog::logger logger("tcp", sink);
+        logger.set_pattern("%v");
+        std::string payload(1000, 'x');
+        for (int i = 0; i < 32 * 1024; i++) {
+            logger.info(payload);
+        }
+        start = std::chrono::steady_clock::now();
+    }
+    // the blocked send times out, so the destructor doesn't wait for the server
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+    ::close(listen_fd);
+}
+
+// loopback udp socket that receives the datagrams sent by udp_sink
+class udp_test_server {
+public:
+    explicit udp_test_server(int family = AF_INET) {
+        fd_ = ::socket(family, SOCK_DGRAM, 0);
+        if (fd_ == -1) {
+            return;
+        }
+        sockaddr_storage addr{};
+        socklen_t len;
+        if (family == AF_INET6) {
+            auto *addr6 = reinterpret_cast<sockaddr_in6 *>(&addr);
+            addr6->sin6_family = AF_INET6;
+            addr6->sin6_addr = in6addr_loopback;
+            len = sizeof(sockaddr_in6);
+        } else {
+            auto *addr4 = reinterpret_cast<sockaddr_in *>(&addr);
+            addr4->sin_family = AF_INET;
+            addr4->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            len = sizeof(sockaddr_in);
+        }
+        if (::bind(fd_, reinterpret_cast<sockaddr *>(&addr), len) != 0 ||
+            ::getsockname(fd_, reinterpret_cast<sockaddr *>(&addr), &len) != 0) {
+            ::close(fd_);
+            fd_ = -1;
+            return;
+        }
+        port_ = family == AF_INET6 ? ntohs(reinterpret_cast<sockaddr_in6 *>(&addr)->sin6_port)
+                                   : ntohs(reinterpret_cast<sockaddr_in *>(&addr)->sin_port);
+    }
+
+    ~udp_test_server() {
+        if (fd_ != -1) {
+            ::close(fd_);
+        }
+    }
+
+    bool ok() const { return fd_ != -1; }
+
+    uint16_t port() const { return port_; }
+
+    // datagrams received so far
+    std::vector<std::string> received() {
+        std::vector<std::string> datagrams;
+        char buf[65536];
+        ssize_t n;
+        while ((n = ::recv(fd_, buf, sizeof(buf), MSG_DONTWAIT)) >= 0) {
+            datagrams.emplace_back(buf, static_cast<size_t>(n));
+        }
+        return datagrams;
+    }
+
+private:
+    int fd_ = -1;
+    uint16_t port_ = 0;
+};
+
+TEST_CASE("udp_sink", "[udp_sink]") {
+    udp_test_server server;
+    REQUIRE(server.ok());
+    spdlog::sinks::udp_sink_config config("127.0.0.1", server.port());
+    auto sink = std::make_shared<spdlog::sinks::udp_sink_st>(config);
+    spdlog::logger logger("udp", sink);
+    logger.set_pattern("%v");
+    logger.info("Test message {}", 1);
+    logger.info("Test message {}", 2);
+
+    auto datagrams = server.received();
+    REQUIRE(datagrams.size() == 2);
+    REQUIRE(datagrams[1] ==
+            spdlog::fmt_lib::format("Test message 2{}", spdlog::details::os::default_eol));
+}
+
+TEST_CASE("udp_sink_batch", "[udp_sink]") {
+    udp_test_server server;
+    REQUIRE(server.ok());
+    spdlog::sinks::udp_sink_config config("127.0.0.1", server.port());
+    config.batch_max_messages = 10;
+    config.send_buffer_size = 0;
+    auto sink = std::make_shared<spdlog::sinks::udp_sink_st>(config);
+    spdlog::logger logger("udp", sink);
+    logger.set_pattern("%v");
+    for (int i = 0; i < 25; i++) {
+        logger.info("Test message {}", i);
+    }
+
+    // two full batches were sent, the rest waits for flush
+    auto datagrams = server.received();
+    REQUIRE(datagrams.size() == 20);
+    logger.flush();
+    auto rest = server.received();
+    REQUIRE(rest.size() == 5);
+    REQUIRE(rest[4] ==
+            spdlog::fmt_lib::format("Test message 24{}", spdlog::details::os::default_eol));
+}
+
+TEST_CASE("udp_sink_ipv6", "[udp_sink]") {
+    udp_test_server server(AF_INET6);
+    if (!server.ok()) {
+        return;  // no IPv6 loopback on this machine
+    }
+    spdlog::sinks::udp_sink_config config("::1", server.port());
+    auto sink = std::make_shared<spdlog::sinks::udp_sink_st>(config);
+    spdlog::logger logger("udp", sink);
+    logger.info("Test message");
+    REQUIRE(server.received().size() == 1);
+}
+
+// unix datagram socket standing in for /dev/log
+class unix_dgram_test_server {
+public:
+    explicit unix_dgram_test_server(std::string path)
+        : path_{std::move(path)} {
+        spdlog::details::os::create_dir(spdlog::details::os::dir_name(path_));
+        ::unlink(path_.c_str());
+        fd_ = ::socket(AF_UNIX, SOCK_DGRAM, 0);
+        REQUIRE(fd_ != -1);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path_.c_str(), sizeof(addr.sun_path) - 1);
+        REQUIRE(::bind(fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0);
+    }
+
+    ~unix_dgram_test_server() {
+        ::close(fd_);
+        ::unlink(path_.c_str());
+    }
+
+    std::vector<std::string> received() {
+        std::vector<std::string> datagrams;
+        char buf[65536];
+        ssize_t n;
+        while ((n = ::recv(fd_, buf, sizeof(buf), MSG_DONTWAIT)) >= 0) {
+            datagrams.emplace_back(buf, static_cast<size_t>(n));
+        }
+        return datagrams;
+    }
+
+private:
+    std::string path_;
+    int fd_ = -1;
+};
+
+static bool starts_with(const std::string &str, const std::string &prefix) {
+    return str.compare(0, prefix.size(), prefix) == 0;
+}
+
+TEST_CASE("native_syslog_sink_rfc3164", "[native_syslog_sink]") {
+    prepare_logdir();
+    unix_dgram_test_server server("test_logs/syslog.sock");
+    spdlog::sinks::native_syslog_sink_config config;
+    config.address = "test_logs/syslog.sock";
+    config.ident = "myapp";
+    config.hostname = "myhost";
+    auto sink = std::make_shared<spdlog::sinks::native_syslog_sink_st>(config);
+    spdlog::logger logger("syslog", sink);
+    logger.info("Test message {}", 1);
+    logger.error("Test message {}", 2);
+
+    auto datagrams = server.received();
+    REQUIRE(datagrams.size() == 2);
+    // facility LOG_USER(1) * 8 + LOG_INFO(6)
+    REQUIRE(starts_with(datagrams[0], "<14>"));
+    REQUIRE(ends_with(datagrams[0], spdlog::fmt_lib::format(" myhost myapp[{}]: Test message 1",
+                                                            spdlog::details::os::pid())));
+    REQUIRE(starts_with(datagrams[1], "<11>"));
+}
+
+TEST_CASE("native_syslog_sink_rfc5424_batch", "[native_syslog_sink]") {
+    prepare_logdir();
+    unix_dgram_test_server server("test_logs/syslog.sock");
+    spdlog::sinks::native_syslog_sink_config config;
+    config.address = "test_logs/syslog.sock";
+    config.format = spdlog::sinks::syslog_format::rfc5424;
+    config.facility = LOG_LOCAL0;
+    config.hostname = "myhost";
+    config.batch_max_messages = 4;
+    auto sink = std::make_shared<spdlog::sinks::native_syslog_sink_st>(config);
+    spdlog::logger logger("syslog", sink);
+    for (int i = 0; i < 6; i++) {
+        logger.warn("Test message {}", i);
+    }
+    REQUIRE(server.received().size() == 4);
+    logger.flush();
+    auto datagrams = server.received();
+    REQUIRE(datagrams.size() == 2);
+    // facility LOG_LOCAL0(16) * 8 + LOG_WARNING(4), version 1, utc timestamp
+    REQUIRE(starts_with(datagrams[1], "<132>1 "));
+    REQUIRE(datagrams[1].find("Z myhost syslog ") != std::string::npos);
+    REQUIRE(ends_with(datagrams[1], " - - Test message 5"));
+}
+
+TEST_CASE("native_syslog_sink_reconnect", "[native_syslog_sink]") {
+    prepare_logdir();
+    spdlog::sinks::native_syslog_sink_config config;
+    config.address = "test_logs/syslog.sock";
+    config.batch_max_messages = 4;
+    std::unique_ptr<unix_dgram_test_server> server(
+        new unix_dgram_test_server("test_logs/syslog.sock"));
+    auto sink = std::make_shared<spdlog::sinks::native_syslog_sink_st>(config);
+    spdlog::logger logger("syslog", sink);
+    for (int i = 0; i < 3; i++) {
+        logger.info("Test message {}", i);
+    }
+
+    // the syslog daemon restarts: the batch is sent once, to the new socket
+    server.reset();
+    server.reset(new unix_dgram_test_server("test_logs/syslog.sock"));
+    logger.flush();
+    auto datagrams = server->received();
+    REQUIRE(datagrams.size() == 3);
+    REQUIRE(ends_with(datagrams[0], "Test message 0"));
+    REQUIRE(ends_with(datagrams[2], "Test message 2"));
+}
+
+TEST_CASE("native_syslog_sink_tcp", "[native_syslog_sink]") {
+    tcp_test_server server;
+    std::string expected;
+    {
+        spdlog::sinks::native_syslog_sink_config config;
+        config.transport = spdlog::sinks::syslog_transport::tcp;
+        config.address = "127.0.0.1";
+        config.port = static_cast<uint16_t>(server.port());
+        config.ident = "myapp";
+        config.hostname = "myhost";
+        auto sink = std::make_shared<spdlog::sinks::native_syslog_sink_st>(config);
+        spdlog::logger logger("syslog", sink);
+        logger.info("Test message");
+    }
+    // octet counting framing
+    auto received = server.received();
+    auto space = received.find(' ');
+    REQUIRE(space != std::string::npos);
+    REQUIRE(std::stoul(received.substr(0, space)) == received.size() - space - 1);
+    REQUIRE(starts_with(received.substr(space + 1), "<14>"));
+    REQUIRE(ends_with(received, "]: Test message"));
+}
+
+TEST_CASE("binary_tcp_sink", "[tcp_sink]") {
+    tcp_test_server server;
+    {
+        spdlog::sinks::tcp_sink_config config("127.0.0.1", server.port());
+        auto sink = std::make_shared<spdlog::sinks::binary_tcp_sink_st>(config);
+        spdlog::logger logger("binary", sink);
+        for (int i = 0; i < 10; i++) {
+            SPDLOG_LOGGER_INFO(&logger, "Test message {}", i);
+        }
+    }
+
+    // relay the received messages to another sink
+    auto received = server.received();
+    auto sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    sink->set_pattern("[%n] [%l] [%s] %v");
+    spdlog::details::binary_decoder decoder;
+    decoder.feed(received.data(), received.size(),
+                 [&](const spdlog::details::log_msg &msg) { sink->log(msg); });
+    REQUIRE(sink->msg_counter() == 10);
+    REQUIRE(sink->lines()[9] == "[binary] [info] [test_net_sinks.cpp] Test message 9");
+}
@@ -0,0 +1,118 @@
+/*
+ * This content is released under the MIT License as specified in
+ * https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
+ */
+#include "includes.h"
+#include "spdlog/sinks/rate_limit_sink.h"
+#include "test_sink.h"
+
+using spdlog::sinks::rate_limit_sink_st;
+using spdlog::sinks::test_sink_st;
+
+static spdlog::details::log_msg msg_at(spdlog::log_clock::time_point time,
+                                       spdlog::string_view_t logger_name,
+                                       spdlog::level::level_enum lvl) {
+    return spdlog::details::log_msg{time, spdlog::source_loc{}, logger_name, lvl, "message"};
+}
+
+TEST_CASE("rate_limit_sink_buckets", "[rate_limit_sink]") {
+    rate_limit_sink_st limiter{10, 5, std::chrono::hours(1)};
+    limiter.set_level_limit(spdlog::level::err, 1, 1);
+    auto test_sink = std::make_shared<test_sink_st>();
+    limiter.add_sink(test_sink);
+
+    auto t0 = spdlog::log_clock::now();
+    for (int i = 0; i < 20; i++) {
+        limiter.log(msg_at(t0, "a", spdlog::level::info));
+        limiter.log(msg_at(t0, "b", spdlog::level::info));
+        limiter.log(msg_at(t0, "a", spdlog::level::err));
+    }
+    // a burst of 5 for each logger at info, 1 for errors
+    REQUIRE(test_sink->msg_counter() == 5 + 5 + 1);
+    REQUIRE(limiter.dropped_messages() == 60 - 11);
+
+    // 10 messages per second: 2 more tokens after 200ms
+    auto t1 = t0 + std::chrono::milliseconds(200);
+    for (int i = 0; i < 5; i++) {
+        limiter.log(msg_at(t1, "a", spdlog::level::info));
+    }
+    REQUIRE(test_sink->msg_counter() == 11 + 2);
+
+    limiter.set_logger_limit("b", 0, 0);
+    limiter.log(msg_at(t0 + std::chrono::seconds(10), "b", spdlog::level::info));
+    REQUIRE(test_sink->msg_counter() == 13);
+}
+
+TEST_CASE("rate_limit_sink_logger_limit", "[rate_limit_sink]") {
+    rate_limit_sink_st limiter{10, 5};
+    limiter.set_logger_limit("a", 1, 3);
+    auto test_sink = std::make_shared<test_sink_st>();
+    test_sink->set_pattern("%n [%l] %v");
+    limiter.add_sink(test_sink);
+
+    // the logger limit is shared by all the levels of the logger
+    auto t0 = spdlog::log_clock::now();
+    for (int i = 0; i < 5; i++) {
+        limiter.log(msg_at(t0, "a", spdlog::level::info));
+        limiter.log(msg_at(t0, "a", spdlog::level::warn));
+        limiter.log(msg_at(t0, "a", spdlog::level::err));
+    }
+    REQUIRE(test_sink->msg_counter() == 3);
+    limiter.flush();
+    REQUIRE(test_sink->lines().back() == "a [warning] Rate limit: dropped 12 messages");
+}
+
+TEST_CASE("rate_limit_sink_report", "[rate_limit_sink]") {
+    rate_limit_sink_st limiter{1, 2};
+    auto test_sink = std::make_shared<test_sink_st>();
+    test_sink->set_pattern("%n [%l] %v");
+    limiter.add_sink(test_sink);
+
+    auto t0 = spdlog::log_clock::now();
+    for (int i = 0; i < 10; i++) {
+        limiter.log(msg_at(t0, "a", spdlog::level::err));
+    }
+    limiter.flush();
+    REQUIRE(test_sink->lines() ==
+            std::vector<std::string>{"a [error] message", "a [error] message",
+                                     "a [warning] Rate limit: dropped 8 error messages"});
+    limiter.flush();
+    REQUIRE(test_sink->lines().size() == 3);
+}
+
+static int formatted_args = 0;
+
+static int count_formatted() { return ++formatted_args; }
+
+TEST_CASE("throttled_macros", "[rate_limit_sink]") {
+    auto test_sink = std::make_shared<test_sink_st>();
+    auto logger = std::make_shared<spdlog::logger>("throttled", test_sink);
+    logger->set_pattern("%v");
+    logger->set_level(spdlog::level::debug);
+
+    formatted_args = 0;
+    for (int i = 0; i < 10; i++) {
+        SPDLOG_LOGGER_INFO_EVERY_N(logger, 4, "every_n {} {}", i, count_formatted());
+    }
+    REQUIRE(formatted_args == 3);
+
+    for (int i = 0; i < 10; i++) {
+        SPDLOG_LOGGER_WARN_FIRST_N(logger, 2, "first_n {}", i);
+    }
+    for (int i = 0; i < 12; i++) {
+        if (i == 10) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        SPDLOG_LOGGER_DEBUG_EVERY_MS(logger, 50, "every_ms {}", i);
+    }
+    // the throttle is checked after the level
+    logger->set_level(spdlog::level::info);
+    for (int i = 0; i < 4; i++) {
+        SPDLOG_LOGGER_DEBUG_EVERY_N(logger, 1, "disabled {}", i);
+    }
+
+    REQUIRE(test_sink->lines() ==
+            std::vector<std::string>{"every_n 0 1", "every_n 4 2", "every_n 8 3", "first_n 0",
+                                     "first_n 1", "every_ms 0", "Skipped 9 throttled messages..",
+                                     "every_ms 10"});
+}
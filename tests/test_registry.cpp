@@ -1,4 +1,5 @@
 #include "includes.h"
+#include "test_sink.h"
 
 static const char *const tested_logger_name = "null_logger";
 static const char *const tested_logger_name2 = "null_logger2";
@@ -110,3 +111,153 @@ TEST_CASE("disable automatic registration", "[registry]") {
     spdlog::set_level(spdlog::level::info);
     spdlog::set_automatic_registration(true);
 }
+
+TEST_CASE("get_raw", "[registry]") {
+    spdlog::drop_all();
+    auto logger = spdlog::create<spdlog::sinks::null_sink_mt>(tested_logger_name);
+    REQUIRE(spdlog::get_raw(tested_logger_name) == logger.get());
+    REQUIRE(spdlog::get_raw(tested_logger_name2) == nullptr);
+    spdlog::drop(tested_logger_name);
+    REQUIRE(spdlog::get_raw(tested_logger_name) == nullptr);
+}
+
+TEST_CASE("concurrent get", "[registry]") {
+    spdlog::drop_all();
+    spdlog::create<spdlog::sinks::null_sink_mt>(tested_logger_name);
+    std::atomic<bool> done{false};
+    std::atomic<size_t> missing{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; i++) {
+        readers.emplace_back([&]() {
+            while (!done) {
+                if (!spdlog::get(tested_logger_name)) {
+                    missing++;
+                }
+            }
+        });
+    }
+    // loggers are added and dropped while the readers look up another one
+    for (int i = 0; i < 200; i++) {
+        auto name = "concurrent_get_" + std::to_string(i);
+        spdlog::create<spdlog::sinks::null_sink_mt>(name);
+        REQUIRE(spdlog::get(name) != nullptr);
+        spdlog::drop(name);
+        REQUIRE(spdlog::get(name) == nullptr);
+    }
+    done = true;
+    for (auto &t : readers) {
+        t.join();
+    }
+    REQUIRE(missing == 0);
+    spdlog::drop_all();
+}
+
+TEST_CASE("concurrent set_default_logger", "[registry]") {
+    auto prev_default = spdlog::default_logger();
+    std::vector<std::shared_ptr<spdlog::sinks::test_sink_mt>> sinks;
+    std::vector<std::weak_ptr<spdlog::logger>> replaced;
+    auto make_default = [&sinks](int i) {
+        sinks.push_back(std::make_shared<spdlog::sinks::test_sink_mt>());
+        return std::make_shared<spdlog::logger>("concurrent_default_" + std::to_string(i),
+                                                sinks.back());
+    };
+    spdlog::set_default_logger(make_default(0));
+
+    std::atomic<bool> done{false};
+    std::atomic<size_t> logged{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&]() {
+            while (!done) {
+                spdlog::info("message");
+                logged++;
+            }
+        });
+    }
+    for (int i = 1; i <= 50; i++) {
+        replaced.push_back(spdlog::default_logger());
+        spdlog::set_default_logger(make_default(i));
+        spdlog::drop("concurrent_default_" + std::to_string(i - 1));
+        // released as soon as the calls that were using it have returned
+        REQUIRE(replaced.back().expired());
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    done = true;
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    size_t received = 0;
+    for (auto &sink : sinks) {
+        received += sink->msg_counter();
+    }
+    REQUIRE(received == logged);
+    spdlog::drop("concurrent_default_50");
+    spdlog::set_default_logger(prev_default);
+}
+
+TEST_CASE("replaced default logger is released by idle threads", "[registry]") {
+    auto prev_default = spdlog::default_logger();
+    auto sink = std::make_shared<spdlog::sinks::test_sink_mt>();
+    std::weak_ptr<spdlog::logger> first_default;
+    {
+        auto logger = std::make_shared<spdlog::logger>("idle_default_1", sink);
+        first_default = logger;
+        spdlog::set_default_logger(std::move(logger));
+    }
+
+    // a thread that logs once and then stays idle
+    std::atomic<bool> logged{false}, done{false};
+    std::thread idle([&]() {
+        spdlog::info("once");
+        logged = true;
+        while (!done) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    while (!logged) {
+        std::this_thread::yield();
+    }
+
+    spdlog::set_default_logger(std::make_shared<spdlog::logger>("idle_default_2", sink));
+    spdlog::drop("idle_default_1");
+    REQUIRE(first_default.expired());
+
+    std::weak_ptr<spdlog::logger> second_default = spdlog::default_logger();
+    spdlog::drop_all();
+    REQUIRE(second_default.expired());
+
+    done = true;
+    idle.join();
+    REQUIRE(sink->msg_counter() == 1);
+    spdlog::set_default_logger(prev_default);
+}
+
+// a sink that replaces the default logger while it is logging to it
+class replace_default_sink : public spdlog::sinks::base_sink<std::mutex> {
+protected:
+    void sink_it_(const spdlog::details::log_msg &) override {
+        auto sink = std::make_shared<spdlog::sinks::test_sink_mt>();
+        spdlog::set_default_logger(std::make_shared<spdlog::logger>("nested_default", sink));
+    }
+    void flush_() override {}
+};
+
+TEST_CASE("set_default_logger from the default logger's sink", "[registry]") {
+    auto prev_default = spdlog::default_logger();
+    std::weak_ptr<spdlog::logger> replaced;
+    {
+        auto logger = std::make_shared<spdlog::logger>("replacing_default",
+                                                       std::make_shared<replace_default_sink>());
+        replaced = logger;
+        spdlog::set_default_logger(std::move(logger));
+    }
+    // it can't be released while its sink is running, so it is released by the next drop
+    spdlog::info("replace");
+    REQUIRE(spdlog::default_logger()->name() == "nested_default");
+    spdlog::drop("replacing_default");
+    REQUIRE(replaced.expired());
+
+    spdlog::drop("nested_default");
+    spdlog::set_default_logger(prev_default);
+}
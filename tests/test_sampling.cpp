@@ -0,0 +1,103 @@
+/*
+ * This content is released under the MIT License as specified in
+ * https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
+ */
+#include "includes.h"
+#include "spdlog/mdc.h"
+#include "spdlog/sinks/sampling_sink.h"
+#include "test_sink.h"
+
+using spdlog::sinks::test_sink_st;
+
+TEST_CASE("sampling_sink", "[sampling]") {
+    spdlog::sinks::sampling_sink_st sampler{10};
+    auto test_sink = std::make_shared<test_sink_st>();
+    sampler.add_sink(test_sink);
+
+    for (int i = 0; i < 10000; i++) {
+        sampler.log(spdlog::details::log_msg{"test", spdlog::level::info, "sampled"});
+    }
+    REQUIRE(sampler.emitted_messages() + sampler.dropped_messages() == 10000);
+    REQUIRE(sampler.emitted_messages() == test_sink->msg_counter());
+    // roughly 1 in 10
+    REQUIRE(sampler.emitted_messages() > 700);
+    REQUIRE(sampler.emitted_messages() < 1300);
+
+    // messages at or above always_level are not sampled
+    for (int i = 0; i < 100; i++) {
+        sampler.log(spdlog::details::log_msg{"test", spdlog::level::warn, "always"});
+    }
+    REQUIRE(sampler.emitted_messages() == test_sink->msg_counter());
+    REQUIRE(sampler.emitted_messages() + sampler.dropped_messages() == 10100);
+}
+
+TEST_CASE("sampling_trace_id", "[sampling]") {
+    spdlog::sinks::sampling_sink_st sampler{4};
+    auto test_sink = std::make_shared<test_sink_st>();
+    sampler.add_sink(test_sink);
+
+    // all the messages of a trace are kept, or all are dropped
+    size_t kept_traces = 0;
+    for (int trace = 0; trace < 100; trace++) {
+        spdlog::mdc::put("trace_id", "trace-" + std::to_string(trace));
+        auto before = test_sink->msg_counter();
+        for (int i = 0; i < 10; i++) {
+            sampler.log(spdlog::details::log_msg{"test", spdlog::level::debug, "msg"});
+        }
+        auto kept = test_sink->msg_counter() - before;
+        REQUIRE((kept == 0 || kept == 10));
+        kept_traces += kept / 10;
+    }
+    spdlog::mdc::remove("trace_id");
+    REQUIRE(kept_traces > 5);
+    REQUIRE(kept_traces < 50);
+}
+
+static int formatted_args = 0;
+
+static int count_formatted() { return ++formatted_args; }
+
+static int sampled_test_line = 0;
+
+static void sampled_test_log(spdlog::logger *logger, uint64_t one_in) {
+    sampled_test_line = __LINE__ + 1;
+    SPDLOG_LOGGER_INFO_SAMPLED(logger, one_in, "sampled {}", count_formatted());
+}
+
+static spdlog::details::sampled_callsite_info sampled_test_callsite() {
+    auto sites = spdlog::details::sampled_callsites();
+    auto it = std::find_if(sites.begin(), sites.end(),
+                           [](const spdlog::details::sampled_callsite_info &s) {
+                               return s.line == sampled_test_line;
+                           });
+    REQUIRE(it != sites.end());
+    return *it;
+}
+
+TEST_CASE("sampled_macros", "[sampling]") {
+    auto test_sink = std::make_shared<test_sink_st>();
+    auto logger = std::make_shared<spdlog::logger>("sampled", test_sink);
+    logger->set_pattern("%v");
+
+    formatted_args = 0;
+    for (int i = 0; i < 1000; i++) {
+        sampled_test_log(logger.get(), 100);
+    }
+    REQUIRE(static_cast<size_t>(formatted_args) == test_sink->msg_counter());
+    REQUIRE(formatted_args < 50);
+    // the decisions are counted at their own callsite
+    auto site = sampled_test_callsite();
+    REQUIRE(ends_with(site.filename, "test_sampling.cpp"));
+    REQUIRE(site.funcname == "sampled_test_log");
+    REQUIRE(site.emitted == static_cast<uint64_t>(formatted_args));
+    REQUIRE(site.dropped == 1000 - static_cast<uint64_t>(formatted_args));
+
+    // one_in 1 keeps everything, and disabled levels are not counted
+    SPDLOG_LOGGER_WARN_SAMPLED(logger, 1, "kept");
+    SPDLOG_LOGGER_DEBUG_SAMPLED(logger, 1, "disabled");
+    REQUIRE(test_sink->lines().back() == "kept");
+    logger->set_level(spdlog::level::warn);
+    sampled_test_log(logger.get(), 1);
+    site = sampled_test_callsite();
+    REQUIRE(site.emitted + site.dropped == 1000);
+}
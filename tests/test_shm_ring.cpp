@@ -0,0 +1,217 @@
+/*
+ * This content is released under the MIT License as specified in
+ * https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
+ */
+#include "includes.h"
+#include "test_sink.h"
+#include "spdlog/sinks/shm_ring_sink.h"
+
+#include <unistd.h>
+
+static std::string test_shm_name() { return "/spdlog-utests-" + std::to_string(::getpid()); }
+
+TEST_CASE("shm_ring_sink", "[shm_ring]") {
+    auto shm_name = test_shm_name();
+    spdlog::details::shm_ring::unlink(shm_name);
+
+    auto logger = spdlog::shm_ring_logger_mt("shm_ring_logger", shm_name, 64 * 1024);
+    logger->set_level(spdlog::level::trace);
+    logger->info("Hello {}", 1);
+    SPDLOG_LOGGER_WARN(logger, "with source {}", 2);
+
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    test_sink->set_pattern("%n [%l] %v%$");
+    spdlog::sinks::shm_ring_reader reader(shm_name);
+    REQUIRE(reader.drain_to(*test_sink) == 2);
+    REQUIRE(test_sink->lines() ==
+            std::vector<std::string>{"shm_ring_logger [info] Hello 1",
+                                     "shm_ring_logger [warning] with source 2"});
+
+    std::vector<int> lines;
+    logger->info("again");
+    SPDLOG_LOGGER_ERROR(logger, "again with source");
+    REQUIRE(reader.poll([&](const spdlog::details::log_msg &msg) {
+        lines.push_back(msg.source.line);
+        if (!msg.source.empty()) {
+            REQUIRE(std::string(msg.source.filename) == __FILE__);
+        }
+    }) == 2);
+    REQUIRE(lines.size() == 2);
+    REQUIRE(lines[0] == 0);
+    REQUIRE(lines[1] > 0);
+    REQUIRE(reader.poll([](const spdlog::details::log_msg &) {}) == 0);
+    REQUIRE(reader.written_messages() == 4);
+    REQUIRE(reader.dropped_messages() == 0);
+
+    spdlog::drop_all();
+    spdlog::details::shm_ring::unlink(shm_name);
+}
+
+TEST_CASE("shm_ring_overflow_and_wrap", "[shm_ring]") {
+    auto shm_name = test_shm_name();
+    spdlog::details::shm_ring::unlink(shm_name);
+
+    // the minimal ring is 4096 bytes
+    spdlog::sinks::shm_ring_sink sink(shm_name, 4096);
+    spdlog::sinks::shm_ring_reader reader(shm_name);
+    std::string payload(100, 'x');
+    spdlog::details::log_msg msg("shm", spdlog::level::info, payload);
+
+    // fill the ring without reading
+    for (int i = 0; i < 100; i++) {
+        sink.log(msg);
+    }
+    REQUIRE(sink.dropped_messages() > 0);
+    REQUIRE(sink.written_messages() + sink.dropped_messages() == 100);
+    auto written = static_cast<size_t>(sink.written_messages());
+    REQUIRE(reader.poll([](const spdlog::details::log_msg &) {}) == written);
+
+    // write and read many times the size of the ring, crossing the end of the buffer
+    size_t n_read = 0;
+    for (int i = 0; i < 1000; i++) {
+        msg.payload = spdlog::string_view_t(payload.data(), static_cast<size_t>(i % 100));
+        sink.log(msg);
+        n_read += reader.poll([&](const spdlog::details::log_msg &m) {
+            REQUIRE(m.payload.size() == static_cast<size_t>(i % 100));
+            REQUIRE(std::string(m.logger_name.data(), m.logger_name.size()) == "shm");
+        });
+    }
+    REQUIRE(n_read == 1000);
+
+    spdlog::details::shm_ring::unlink(shm_name);
+}
+
+TEST_CASE("shm_ring_reattach", "[shm_ring]") {
+    auto shm_name = test_shm_name();
+    spdlog::details::shm_ring::unlink(shm_name);
+
+    {
+        // the writer goes away before anything is read
+        spdlog::sinks::shm_ring_sink sink(shm_name, 4096);
+        spdlog::details::log_msg msg("shm", spdlog::level::info, "before reader");
+        sink.log(msg);
+    }
+
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    test_sink->set_pattern("%v%$");
+    {
+        spdlog::sinks::shm_ring_reader reader(shm_name);
+        REQUIRE(reader.drain_to(*test_sink) == 1);
+    }
+
+    {
+        spdlog::sinks::shm_ring_sink sink(shm_name);
+        spdlog::details::log_msg msg("shm", spdlog::level::info, "after reader restart");
+        sink.log(msg);
+    }
+    // a new reader continues where the previous one stopped
+    spdlog::sinks::shm_ring_reader reader(shm_name);
+    REQUIRE(reader.drain_to(*test_sink) == 1);
+    REQUIRE(test_sink->lines() ==
+            std::vector<std::string>{"before reader", "after reader restart"});
+
+    spdlog::details::shm_ring::unlink(shm_name);
+}
+
+// simulate a writer that died after claiming a record of the given size at write_pos,
+// before (or after) moving write_pos past it
+static void claim_stalled_record(spdlog::details::shm_ring &ring,
+                                 size_t size,
+                                 bool move_write_pos) {
+    using spdlog::details::shm_ring;
+    auto pos = ring.hdr().write_pos.load();
+    auto *data = reinterpret_cast<char *>(&ring.hdr()) + sizeof(shm_ring::header);
+    auto offset = pos & (ring.hdr().capacity - 1);
+    auto *word = reinterpret_cast<std::atomic<uint64_t> *>(data + offset);
+    word->store(shm_ring::make_word(pos, size, shm_ring::reserved_bit));
+    if (move_write_pos) {
+        ring.hdr().write_pos.store(pos + ((8 + size + 7) & ~size_t(7)));
+    }
+}
+
+TEST_CASE("shm_ring_stalled_writer", "[shm_ring]") {
+    auto shm_name = test_shm_name();
+    spdlog::details::shm_ring::unlink(shm_name);
+
+    spdlog::details::shm_ring ring;
+    ring.open(shm_name, 4096);
+    claim_stalled_record(ring, 50, true);
+
+    spdlog::sinks::shm_ring_sink sink(shm_name);
+    spdlog::details::log_msg msg("shm", spdlog::level::info, "after stalled");
+    sink.log(msg);
+
+    spdlog::sinks::shm_ring_reader reader(shm_name, 0, std::chrono::milliseconds(10));
+    REQUIRE(reader.poll([](const spdlog::details::log_msg &) {}) == 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE(reader.poll([](const spdlog::details::log_msg &) {}) == 0);
+    REQUIRE(reader.abandoned_messages() == 1);
+
+    // only the stalled record was skipped, not the ones reserved after it
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    test_sink->set_pattern("%v%$");
+    REQUIRE(reader.drain_to(*test_sink) == 1);
+    REQUIRE(test_sink->lines() == std::vector<std::string>{"after stalled"});
+
+    // died before moving write_pos: the next writer moves it past the claimed record
+    claim_stalled_record(ring, 20, false);
+    sink.log(msg);
+    REQUIRE(sink.dropped_messages() == 0);
+    REQUIRE(reader.poll([](const spdlog::details::log_msg &) {}) == 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE(reader.poll([](const spdlog::details::log_msg &) {}) == 0);
+    REQUIRE(reader.abandoned_messages() == 2);
+
+    REQUIRE(reader.drain_to(*test_sink) == 1);
+    REQUIRE(test_sink->lines() == std::vector<std::string>{"after stalled", "after stalled"});
+
+    spdlog::details::shm_ring::unlink(shm_name);
+}
+
+TEST_CASE("shm_ring_concurrent_writers", "[shm_ring]") {
+    auto shm_name = test_shm_name();
+    spdlog::details::shm_ring::unlink(shm_name);
+
+    spdlog::details::shm_ring ring;
+    ring.open(shm_name, 4096);
+    const int n_threads = 4;
+    const int per_thread = 5000;
+    std::atomic<int> done{0};
+    std::vector<std::thread> writers;
+    for (int t = 0; t < n_threads; t++) {
+        writers.emplace_back([&ring, &done, t] {
+            // each record is its size repeated, so a torn or overwritten record is detected
+            for (int i = 0; i < per_thread; i++) {
+                std::string record(static_cast<size_t>(1 + (i * 7 + t) % 200),
+                                   static_cast<char>('a' + t));
+                const spdlog::string_view_t parts[] = {record};
+                while (!ring.write(parts)) {
+                    std::this_thread::yield();
+                }
+            }
+            done.fetch_add(1);
+        });
+    }
+
+    size_t n_read = 0;
+    size_t bad = 0;
+    auto on_record = [&](const char *data, size_t size) {
+        n_read++;
+        if (size < 1 || size > 200 || std::string(data, size).find_first_not_of(data[0]) !=
+                                          std::string::npos) {
+            bad++;
+        }
+    };
+    while (done.load() < n_threads) {
+        ring.read(on_record);
+    }
+    ring.read(on_record);
+    for (auto &w : writers) {
+        w.join();
+    }
+    REQUIRE(bad == 0);
+    REQUIRE(n_read == static_cast<size_t>(n_threads * per_thread));
+    REQUIRE(ring.hdr().committed.load() == static_cast<uint64_t>(n_threads * per_thread));
+
+    spdlog::details::shm_ring::unlink(shm_name);
+}
@@ -0,0 +1,147 @@
+/*
+ * This content is released under the MIT License as specified in
+ * https://raw.githubusercontent.com/gabime/spdlog/master/LICENSE
+ */
+#include "includes.h"
+#include "test_sink.h"
+#include "spdlog/sinks/spool_sink.h"
+
+#define SPOOL_FILENAME "test_logs/spool"
+
+// test sink that throws while it is down
+class flaky_sink : public spdlog::sinks::test_sink_mt {
+public:
+    std::atomic<bool> down{false};
+
+protected:
+    void sink_it_(const spdlog::details::log_msg &msg) override {
+        if (down) {
+            throw spdlog::spdlog_ex("flaky_sink is down");
+        }
+        spdlog::sinks::test_sink_mt::sink_it_(msg);
+    }
+};
+
+static spdlog::sinks::spool_sink_config test_spool_config() {
+    spdlog::sinks::spool_sink_config config(SPDLOG_FILENAME_T(SPOOL_FILENAME));
+    config.retry_interval = std::chrono::milliseconds(0);
+    return config;
+}
+
+TEST_CASE("spool_sink_memory", "[spool_sink]") {
+    prepare_logdir();
+    auto target = std::make_shared<flaky_sink>();
+    auto spool = std::make_shared<spdlog::sinks::spool_sink_mt>(target, test_spool_config());
+    spdlog::logger logger("spool", spool);
+    logger.set_pattern("%v");
+
+    logger.info("live 1");
+    REQUIRE(target->msg_counter() == 1);
+    REQUIRE_FALSE(spool->spooling());
+
+    target->down = true;
+    logger.info("spooled 1");
+    logger.info("spooled 2");
+    REQUIRE(spool->spooling());
+    REQUIRE(spool->spooled_messages() == 2);
+    REQUIRE(spool->delivery_errors() == 2);  // the second message retried the first one
+    REQUIRE_FALSE(spdlog::details::os::path_exists(SPDLOG_FILENAME_T(SPOOL_FILENAME ".0")));
+
+    target->down = false;
+    logger.info("live 2");
+    REQUIRE_FALSE(spool->spooling());
+    REQUIRE(spool->replayed_messages() == 2);
+    REQUIRE(target->lines() ==
+            std::vector<std::string>{"live 1", "spooled 1", "spooled 2", "live 2"});
+}
+
+TEST_CASE("spool_sink_disk", "[spool_sink]") {
+    prepare_logdir();
+    auto config = test_spool_config();
+    config.memory_limit = 0;
+    config.max_segment_size = 100;
+    auto target = std::make_shared<flaky_sink>();
+    target->down = true;
+    {
+        spdlog::sinks::spool_sink_mt spool(target, config);
+        spool.set_pattern("%v");
+        for (int i = 0; i < 10; i++) {
+            spool.log(spdlog::details::log_msg("spool", spdlog::level::info,
+                                               fmt::format("message {}", i)));
+        }
+        REQUIRE(spool.spooled_messages() == 10);
+        REQUIRE(spdlog::details::os::path_exists(SPDLOG_FILENAME_T(SPOOL_FILENAME ".0")));
+        REQUIRE(spdlog::details::os::path_exists(SPDLOG_FILENAME_T(SPOOL_FILENAME ".1")));
+
+        // replay, then go down again
+        target->down = false;
+        spool.flush();
+        REQUIRE(spool.replayed_messages() == 10);
+        target->down = true;
+        spool.log(spdlog::details::log_msg("spool", spdlog::level::info, "message 10"));
+        spool.log(spdlog::details::log_msg("spool", spdlog::level::info, "message 11"));
+    }
+    REQUIRE(target->msg_counter() == 10);
+
+    // a new spool sink replays what was left on disk
+    target->down = false;
+    config.replay_batch = 1;
+    spdlog::sinks::spool_sink_mt spool(target, config);
+    spool.set_pattern("%v");
+    REQUIRE(spool.spooling());
+    spool.flush();
+    REQUIRE(target->msg_counter() == 11);
+    spool.flush();
+    REQUIRE(target->msg_counter() == 12);
+    REQUIRE_FALSE(spool.spooling());
+    REQUIRE(target->lines().back() == "message 11");
+    REQUIRE_FALSE(spdlog::details::os::path_exists(SPDLOG_FILENAME_T(SPOOL_FILENAME ".cursor")));
+}
+
+TEST_CASE("spool_sink_truncated_record", "[spool_sink]") {
+    prepare_logdir();
+    auto config = test_spool_config();
+    config.memory_limit = 0;
+    auto target = std::make_shared<flaky_sink>();
+    target->down = true;
+    {
+        spdlog::sinks::spool_sink_mt spool(target, config);
+        spool.set_pattern("%v");
+        spool.log(spdlog::details::log_msg("spool", spdlog::level::info, "message 0"));
+        spool.log(spdlog::details::log_msg("spool", spdlog::level::info, "message 1"));
+    }
+
+    // a crash in the middle of the last record
+    auto contents = file_contents(SPOOL_FILENAME ".0");
+    std::ofstream(SPOOL_FILENAME ".0", std::ios::binary | std::ios::trunc)
+        << contents.substr(0, contents.size() - 3);
+
+    target->down = false;
+    spdlog::sinks::spool_sink_mt spool(target, config);
+    spool.set_pattern("%v");
+    spool.flush();
+    REQUIRE(target->lines() == std::vector<std::string>{"message 0"});
+    REQUIRE(spool.dropped_messages() == 1);
+    REQUIRE_FALSE(spool.spooling());
+}
+
+TEST_CASE("spool_sink_disk_limit", "[spool_sink]") {
+    prepare_logdir();
+    auto config = test_spool_config();
+    config.memory_limit = 0;
+    config.max_disk_size = 200;
+    auto target = std::make_shared<flaky_sink>();
+    target->down = true;
+    spdlog::sinks::spool_sink_st spool(target, config);
+    for (int i = 0; i < 10; i++) {
+        spool.log(spdlog::details::log_msg("spool", spdlog::level::info, "a message to spool"));
+    }
+    REQUIRE(spool.dropped_messages() > 0);
+    REQUIRE(spool.spooled_messages() + spool.dropped_messages() == 10);
+    REQUIRE(get_filesize(SPOOL_FILENAME ".0") <= 200);
+
+    target->down = false;
+    spool.flush();
+    REQUIRE(target->msg_counter() == spool.spooled_messages());
+    REQUIRE_FALSE(spool.spooling());
+}